@@ -0,0 +1,158 @@
+/*
+  ==============================================================================
+
+    ChannelGroupEngine.h
+    Created: 20 Oct 2026 1:52:17am
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "DrEchoEngine.h"
+#include "RealtimeWorkerPool.h"
+
+#include <memory>
+
+/**
+ * Runs any number of channels through the echo as independent groups: one
+ * DrEchoEngine per stereo pair (plus a mono one for an odd last channel),
+ * which is how the echo treats a multichannel bed. With a worker pool and
+ * blocks long enough to be worth the fork/join, the groups run in parallel.
+ *
+ * prepare() allocates; process() doesn't.
+ */
+class ChannelGroupEngine
+{
+
+public:
+    static const int MAX_CHANNELS = 16;
+    static const int MAX_GROUPS = MAX_CHANNELS / DrEchoEngine::MAX_CHANNELS;
+
+    // Below this, waking the workers and waiting for them costs about as much as it saves.
+    static const int MIN_PARALLEL_BLOCK_SIZE = 128;
+
+public:
+    ChannelGroupEngine()
+        : _num_groups( 0 )
+    {
+    }
+
+public:
+    static int getNumGroupsFor(int num_channels)
+    {
+        return (dspLimit( 0, MAX_CHANNELS, num_channels ) + DrEchoEngine::MAX_CHANNELS - 1) / DrEchoEngine::MAX_CHANNELS;
+    }
+
+    /** Creates and prepares an engine per group. */
+    void prepare(double sample_rate, int max_block_size, bool reduced_rate, int num_channels)
+    {
+        _num_groups = getNumGroupsFor( num_channels );
+        for ( int g = 0; g < MAX_GROUPS; ++g )
+        {
+            if ( g < _num_groups )
+            {
+                if ( !_engines[g] )
+                    _engines[g].reset( new DrEchoEngine() );
+                _engines[g]->prepare( sample_rate, max_block_size, reduced_rate );
+            }
+            else
+                _engines[g].reset();
+        }
+    }
+
+    void reset()
+    {
+        for ( int g = 0; g < _num_groups; ++g )
+            _engines[g]->reset();
+    }
+
+    void setOptionalStages(bool exact_modulation, bool shimmer)
+    {
+        for ( int g = 0; g < _num_groups; ++g )
+            _engines[g]->setOptionalStages( exact_modulation, shimmer );
+    }
+
+    /**
+     * Processes the channels in place, group by group, see DrEchoEngine::process().
+     * Channels beyond the prepared ones are left alone. All groups duck to the
+     * same sidechain. With a pool, the groups run on its workers (and the
+     * calling thread) for all but short blocks.
+     */
+    void process(float* const* channels, int num_channels, int num_samples, const DrEchoEngine::Parameters& parameters, double bpm,
+                 float* const* wet_channels = nullptr, const float* const* sidechain_channels = nullptr, int num_sidechain_channels = 0,
+                 RealtimeWorkerPool* pool = nullptr)
+    {
+        _job.channels = channels;
+        _job.num_channels = std::min( num_channels, _num_groups * DrEchoEngine::MAX_CHANNELS );
+        _job.num_samples = num_samples;
+        _job.parameters = &parameters;
+        _job.bpm = bpm;
+        _job.wet_channels = wet_channels;
+        _job.sidechain_channels = sidechain_channels;
+        _job.num_sidechain_channels = num_sidechain_channels;
+
+        const int num_groups = getNumGroupsFor( _job.num_channels );
+        if ( pool && pool->getNumWorkers() > 0 && num_groups > 1 && num_samples >= MIN_PARALLEL_BLOCK_SIZE )
+        {
+            pool->run( num_groups, &ChannelGroupEngine::_process_group, this );
+        }
+        else
+        {
+            for ( int g = 0; g < num_groups; ++g )
+                _process_group( this, g );
+        }
+    }
+
+public:
+    int getNumGroups() const { return _num_groups; }
+
+    DrEchoEngine& getEngine(int group) { return *_engines[group]; }
+    const DrEchoEngine& getEngine(int group) const { return *_engines[group]; }
+
+    /** The highest wet peak of all groups in the last block. */
+    float getWetPeak() const
+    {
+        float peak = 0.0f;
+        for ( int g = 0; g < _num_groups; ++g )
+            peak = std::max( peak, _engines[g]->getWetPeak() );
+        return peak;
+    }
+
+    size_t getBufferBytes() const
+    {
+        size_t bytes = 0;
+        for ( int g = 0; g < _num_groups; ++g )
+            bytes += _engines[g]->getBufferBytes();
+        return bytes;
+    }
+
+private:
+    struct _Job
+    {
+        float* const* channels;
+        int num_channels;
+        int num_samples;
+        const DrEchoEngine::Parameters* parameters;
+        double bpm;
+        float* const* wet_channels;
+        const float* const* sidechain_channels;
+        int num_sidechain_channels;
+    };
+
+    static void _process_group(void* context, int group)
+    {
+        ChannelGroupEngine& self = *static_cast<ChannelGroupEngine*>( context );
+        const _Job& job = self._job;
+        const int first = group * DrEchoEngine::MAX_CHANNELS;
+        const int n = dspLimit( 0, DrEchoEngine::MAX_CHANNELS, job.num_channels - first );
+        self._engines[group]->process( job.channels + first, n, job.num_samples, *job.parameters, job.bpm,
+                                       job.wet_channels ? job.wet_channels + first : nullptr, job.sidechain_channels, job.num_sidechain_channels );
+    }
+
+private:
+    std::unique_ptr<DrEchoEngine> _engines[MAX_GROUPS];
+    int _num_groups;
+    _Job _job;
+};
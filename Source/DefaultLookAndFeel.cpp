@@ -10,6 +10,8 @@
 
 #include "DefaultLookAndFeel.h"
 
+#include "TraceEvents.h"
+
 DefaultLookAndFeel::DefaultLookAndFeel()
     : juce::LookAndFeel_V4()
 {
@@ -25,6 +27,10 @@ DefaultLookAndFeel::DefaultLookAndFeel()
     setColour( juce::Slider::textBoxBackgroundColourId, juce::Colours::transparentBlack );
     //setColour( juce::Slider::textBoxHighlightColourId, juce::Colours::red );
     setColour( juce::Slider::textBoxOutlineColourId, juce::Colours::transparentBlack );
+
+    setColour( juce::ToggleButton::textColourId, juce::Colour( 0xff888888 ) );
+    setColour( juce::ToggleButton::tickColourId, juce::Colour( 0xff383838 ) );
+    setColour( juce::ToggleButton::tickDisabledColourId, juce::Colour( 0xff888888 ) );
 }
 
 juce::Slider::SliderLayout DefaultLookAndFeel::getSliderLayout(juce::Slider& slider)
@@ -36,6 +42,8 @@ juce::Slider::SliderLayout DefaultLookAndFeel::getSliderLayout(juce::Slider& sli
 
 void DefaultLookAndFeel::drawRotarySlider(juce::Graphics& g, int x, int y, int width, int height, float sliderPos, const float rotaryStartAngle, const float rotaryEndAngle, juce::Slider& slider)
 {
+    DRECHO_TRACE_SCOPE( "drawRotarySlider" );
+
     auto outline = slider.findColour( juce::Slider::rotarySliderOutlineColourId );
     auto fill    = slider.findColour( juce::Slider::rotarySliderFillColourId );
     auto thumb   = slider.findColour( juce::Slider::thumbColourId );
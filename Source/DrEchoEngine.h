@@ -0,0 +1,781 @@
+/*
+  ==============================================================================
+
+    DrEchoEngine.h
+    Created: 19 Oct 2026 8:31:52pm
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "DspCommon.h"
+#include "DspKernels.h"
+#include "Ducker.h"
+#include "GrainPitchShifter.h"
+#include "LfoWavetable.h"
+#include "ReducedRatePath.h"
+#include "TempoSync.h"
+
+/**
+ * The complete echo, independent of any host or plug-in framework: it works
+ * on raw channel pointers, takes its parameters as a plain struct and the
+ * tempo as a number, and only depends on the (equally JUCE-free) DSP
+ * building blocks. DrEchoAudioProcessor is a thin adapter on top of it.
+ *
+ * Only prepare() allocates; reset() and process() don't.
+ */
+class DrEchoEngine
+{
+
+public:
+    static const int MAX_CHANNELS = 2;
+
+    /** The parameters in the units of the plug-in's parameters, except for the percentages (fractions here). */
+    struct Parameters
+    {
+        float gain_db = 0.0f;
+        float pan = 0.0f;               // [-45; +45] degrees
+        float delay = 2.0f;             // in 1/16th notes
+        float pingpong = 0.5f;
+        float feedback = 0.0f;
+        float dry = 1.0f;
+        float wet = 0.5f;
+        float mod_rate = 0.5f;          // Hz
+        float mod_depth = 0.0f;         // milliseconds
+        LfoWavetable::Shape mod_shape = LfoWavetable::Shape::Sine;
+        float mod_phase = 0.0f;         // [0; 180] degrees
+        float shimmer_semitones = 0.0f; // 0 is off
+        float shimmer_mix = 0.5f;
+        TempoSync::Division division = TempoSync::Division::Straight;
+        bool synced = true;             // false: delay_ms instead of the 1/16ths
+        float delay_ms = 250.0f;        // milliseconds, also without a tempo to sync to
+        float duck_amount_db = 0.0f;    // 0 is off
+        float duck_threshold_db = -30.0f;
+        float duck_attack_ms = 5.0f;
+        float duck_release_ms = 250.0f;
+
+        /** Maps the index of the plug-in's shimmer choice parameter to semitones. */
+        static float getShimmerSemitones(int choice)
+        {
+            static const float semitones[] = { 0.0f, -24.0f, -12.0f, +12.0f, +24.0f };
+            return semitones[ dspLimit( 0, 4, choice ) ];
+        }
+
+        /** The inverse of getShimmerSemitones(). */
+        static int getShimmerChoice(float semitones)
+        {
+            for ( int choice = 0; choice < 5; ++choice )
+                if ( getShimmerSemitones( choice ) == semitones )
+                    return choice;
+            return 0;
+        }
+
+        /**
+         * Sets one parameter from its plug-in parameter ID and plain value,
+         * as found in a plug-in state. Returns false for unknown IDs.
+         */
+        bool set(const std::string& id, float value)
+        {
+            if ( id == "gain" )             gain_db = value;
+            else if ( id == "pan" )         pan = value;
+            else if ( id == "delay" )       delay = value;
+            else if ( id == "pingpong" )    pingpong = value * 0.01f;
+            else if ( id == "feedback" )    feedback = value * 0.01f;
+            else if ( id == "dry" )         dry = value * 0.01f;
+            else if ( id == "wet" )         wet = value * 0.01f;
+            else if ( id == "modrate" )     mod_rate = value;
+            else if ( id == "moddepth" )    mod_depth = value;
+            else if ( id == "modshape" )    mod_shape = static_cast<LfoWavetable::Shape>( dspLimit( 0, 2, static_cast<int>( value ) ) );
+            else if ( id == "modphase" )    mod_phase = value;
+            else if ( id == "shimmer" )     shimmer_semitones = getShimmerSemitones( static_cast<int>( value ) );
+            else if ( id == "shimmermix" )  shimmer_mix = value * 0.01f;
+            else if ( id == "division" )    division = static_cast<TempoSync::Division>( dspLimit( 0, TempoSync::NUM_DIVISIONS - 1, static_cast<int>( value ) ) );
+            else if ( id == "sync" )        synced = value >= 0.5f;
+            else if ( id == "delayms" )     delay_ms = value;
+            else if ( id == "duckamount" )  duck_amount_db = value;
+            else if ( id == "duckthreshold" ) duck_threshold_db = value;
+            else if ( id == "duckattack" )  duck_attack_ms = value;
+            else if ( id == "duckrelease" ) duck_release_ms = value;
+            else
+                return false;
+            return true;
+        }
+    };
+
+    /** The peak and the energy of a signal over one block, all channels taken together. */
+    struct Level
+    {
+        float peak = 0.0f;
+        float sum_of_squares = 0.0f;
+        int num_samples = 0;    // the squares summed up, i.e. frames times channels
+
+        void add(const DspKernels& kernels, const float* samples, int n)
+        {
+            kernels.level( samples, n, peak, sum_of_squares );
+            num_samples += n;
+        }
+    };
+
+public:
+    DrEchoEngine()
+        : DrEchoEngine( DspKernels::select() )
+    {
+    }
+
+    /** Uses the given kernels instead of the widest ones for this CPU, e.g. to compare them. */
+    explicit DrEchoEngine(const DspKernels& kernels)
+        : _sample_rate( 44100.0f )
+        , _max_block_size( 0 )
+        , _delay_rate( 44100.0f )
+        , _buffer_index( 0 )
+        , _buffer_size( 0 )
+        , _max_delay( 0 )
+        , _kernels( kernels )
+        , _lfo_phase( 0.0 )
+        , _glide_delay( 0.0f )
+        , _glide_target( -1.0f )
+        , _glide_step( 0.0f )
+        , _glide_remaining( 0 )
+        , _glide_length( 1 )
+        , _exact_modulation( true )
+        , _shimmer_enabled( true )
+        , _delay_samples( 0 )
+        , _buffer_bytes( 0 )
+    {
+        // Make sure the shared LFO tables are built here rather than in the audio thread.
+        LfoWavetable::get( LfoWavetable::Shape::Sine );
+    }
+
+public:
+    /**
+     * Sizes everything for the given sample rate and maximum block size. In
+     * reduced-rate mode, the delay network runs at a fraction of the sample
+     * rate, which saves both ring-buffer memory and CPU.
+     */
+    void prepare(double sample_rate, int max_block_size, bool reduced_rate)
+    {
+        const double MAX_SECONDS = 1.0;
+
+        _sample_rate = static_cast<float>( sample_rate );
+        _max_block_size = std::max( 1, max_block_size );
+
+        const int factor = reduced_rate ? ReducedRatePath::getFactorFor( sample_rate ) : 1;
+        const size_t max_reduced_block_size = static_cast<size_t>( _max_block_size / factor + 1 );
+
+        _reduced_rate_path.prepare( factor, _max_block_size );
+        _delay_rate = _sample_rate / static_cast<float>( factor );
+        _tempo_sync.prepare( sample_rate );
+
+        // The ring buffer holds the longest delay plus a grain of the shimmer, which reads behind it.
+        _buffer_index = 0;
+        _max_delay = static_cast<size_t>( ::ceil( _delay_rate * MAX_SECONDS ) );
+        _buffer_size = _max_delay + static_cast<size_t>( ::ceil( _delay_rate * GrainPitchShifter::GRAIN_SECONDS ) ) + 2;
+        for ( int i = 0; i < MAX_CHANNELS; ++i )
+        {
+            _sample_buffers[i].assign( _buffer_size, 0.0f );
+            _sample_buffers[i].shrink_to_fit();
+        }
+
+        // Scratch space for the gained/panned input and the wet signal of one
+        // block (or one part of it), both at full and at reduced rate.
+        for ( int i = 0; i < MAX_CHANNELS; ++i )
+        {
+            _input_buffers[i].resize( static_cast<size_t>( _max_block_size ) );
+            _wet_buffers[i].resize( static_cast<size_t>( _max_block_size ) );
+            _reduced_input_buffers[i].resize( max_reduced_block_size );
+            _reduced_wet_buffers[i].resize( max_reduced_block_size );
+            _shimmer_buffers[i].resize( static_cast<size_t>( _max_block_size ) );
+            _coarse_buffers[i].resize( static_cast<size_t>( _max_block_size ) );
+        }
+
+        _lfo_phase = 0.0;
+        _glide_target = -1.0f;
+        _glide_remaining = 0;
+
+        // A change of the delay time glides over a fixed time, whatever the block size.
+        const float GLIDE_SECONDS = 0.05f;
+        _glide_length = std::max( 1, static_cast<int>( ::ceil( GLIDE_SECONDS * _delay_rate ) ) );
+
+        _pitch_shifter.prepare( _delay_rate, _max_block_size );
+        _ducker.prepare( _sample_rate );
+
+        // The optional shimmer is faded in and out rather than switched, and
+        // so is the exact modulation against the coarse one.
+        const float STAGE_CROSSFADE_SECONDS = 0.1f;
+        _shimmer_gain.reset( _delay_rate, STAGE_CROSSFADE_SECONDS, 1.0f );
+        _exact_modulation_gain.reset( _delay_rate, STAGE_CROSSFADE_SECONDS, _exact_modulation ? 1.0f : 0.0f );
+
+        _buffer_bytes = 0;
+        for ( int i = 0; i < MAX_CHANNELS; ++i )
+        {
+            for ( const std::vector<float>* buffer : { &_sample_buffers[i], &_input_buffers[i], &_wet_buffers[i], &_reduced_input_buffers[i], &_reduced_wet_buffers[i], &_shimmer_buffers[i], &_coarse_buffers[i] } )
+                _buffer_bytes += buffer->capacity() * sizeof( float );
+        }
+
+        _delay_samples = 0;
+        _input_level = _wet_level = _feedback_level = Level();
+    }
+
+    /** Silences the delay network without reallocating anything. */
+    void reset()
+    {
+        for ( auto& buffer : _sample_buffers )
+            std::fill( buffer.begin(), buffer.end(), 0.0f );
+        _buffer_index = 0;
+        _lfo_phase = 0.0;
+        _glide_target = -1.0f;
+        _glide_remaining = 0;
+        _reduced_rate_path.reset();
+        _pitch_shifter.reset();
+        _ducker.reset();
+        _input_level = _wet_level = _feedback_level = Level();
+    }
+
+    /**
+     * Moves the LFO and the shimmer's grains, right after a reset(), to where
+     * they would be after the given number of samples at constant parameters.
+     * Together with a warm-up of getTailLength() samples of the preceding
+     * input, the engine then continues as if it had processed everything
+     * before, e.g. to render one long file in chunks on several engines. The
+     * position must be a multiple of the reduced-rate factor.
+     */
+    void seek(int64_t position, const Parameters& parameters)
+    {
+        const int factor = _reduced_rate_path.getFactor();
+        assert( position % factor == 0 );
+        const double num_delay_rate_samples = static_cast<double>( position / factor );
+
+        // The increments as process() computes them, in the same precision.
+        const LfoWavetable& lfo = LfoWavetable::get( parameters.mod_shape );
+        const double lfo_increment = parameters.mod_rate / _delay_rate / lfo.getNumCycles();
+        _lfo_phase = lfo_increment * num_delay_rate_samples;
+        _lfo_phase -= ::floor( _lfo_phase );
+
+        // The grains only move while the shimmer is on.
+        if ( parameters.shimmer_semitones != 0.0f && parameters.shimmer_mix > 0.0f && _shimmer_enabled )
+            _pitch_shifter.seek( ::exp2f( parameters.shimmer_semitones * (1.0f/12.0f) ), num_delay_rate_samples );
+    }
+
+    /**
+     * How many samples of input at constant parameters and tempo it takes
+     * until the echo of everything before has decayed below the given level
+     * (relative to the input's peak) in the output: a repetition per delay
+     * (plus modulation, grains and resampling latency) until the feedback has
+     * brought the sum of all remaining repetitions down that far, or the
+     * ducker's follower has forgotten its past, whichever takes longer. Zero
+     * if the echo never decays, i.e. at 100 % feedback.
+     */
+    size_t getTailLength(const Parameters& parameters, double bpm, float level)
+    {
+        if ( parameters.feedback >= 1.0f )
+            return 0;
+
+        const float factor = static_cast<float>( _reduced_rate_path.getFactor() );
+        const float latency = static_cast<float>( _reduced_rate_path.getLatency() );
+        float repetition = _tempo_sync.getDelayInSamples( parameters.delay, parameters.division, parameters.delay_ms, parameters.synced ? bpm : 0.0 );
+        if ( repetition <= latency || (repetition - latency) / factor > static_cast<float>( _max_delay ) )
+            repetition = static_cast<float>( _max_delay ) * factor; // see process()
+        repetition += parameters.mod_depth * 0.001f * _sample_rate + latency + 2.0f * factor;
+        if ( parameters.shimmer_semitones != 0.0f && parameters.shimmer_mix > 0.0f )
+            repetition += 0.06f * _sample_rate; // a grain, see GrainPitchShifter::prepare()
+
+        // The repetitions after the k-th add up to at most feedback^k / (1 - feedback) of the peak, times the
+        // input gain and at most 2 for the pan matrix; the wet level is at most 1.
+        const double output_gain = 2.0 * ::pow( 10.0, parameters.gain_db * 0.05 );
+        double num_repetitions = 1.0;
+        if ( parameters.feedback > 0.0f )
+            num_repetitions = std::max( 1.0, ::ceil( ::log( level * (1.0 - parameters.feedback) / output_gain ) / ::log( parameters.feedback ) ) );
+        double tail = num_repetitions * repetition;
+
+        // The follower's distance to any other start value shrinks with the longer of its time constants.
+        if ( parameters.duck_amount_db > 0.0f )
+        {
+            const double time_constant = std::max( parameters.duck_attack_ms, parameters.duck_release_ms ) * 0.001 * _sample_rate;
+            tail = std::max( tail, time_constant * ::log( 1.0 / level ) );
+        }
+        return static_cast<size_t>( ::ceil( tail ) );
+    }
+
+    /**
+     * Trades quality for CPU, e.g. under pressure: without exact modulation,
+     * the modulated delay follows the LFO only every few samples (see
+     * _coarse_modulated_read()); the shimmer is switched off. Both changes
+     * are crossfaded.
+     */
+    void setOptionalStages(bool exact_modulation, bool shimmer)
+    {
+        _exact_modulation = exact_modulation;
+        _shimmer_enabled = shimmer;
+    }
+
+    /**
+     * Processes one or two channels in place. Blocks longer than the prepared
+     * maximum are processed in parts. With wet_channels, the (scaled) wet
+     * signal goes there instead, and the channels keep only the dry signal.
+     * A bpm of zero (or less) means that there is no tempo to sync to. The
+     * ducking follows the sidechain channels if there are any, otherwise the
+     * dry input.
+     */
+    void process(float* const* channels, int num_channels, int num_samples, const Parameters& parameters, double bpm, float* const* wet_channels = nullptr,
+                 const float* const* sidechain_channels = nullptr, int num_sidechain_channels = 0)
+    {
+        assert( num_channels >= 1 && num_channels <= MAX_CHANNELS );
+
+        const bool stereo = num_channels == 2;
+
+        const float gain = ::powf( 10.0f, parameters.gain_db * 0.05f ); // float dB to float gain
+        const float pan = parameters.pan / 45.0f; // [-45; +45] degrees to float [-1; +1]
+        const float delay = _tempo_sync.getDelayInSamples( parameters.delay, parameters.division, parameters.delay_ms, parameters.synced ? bpm : 0.0 );
+
+        // The delay network may run at a reduced rate, and the resampling
+        // latency of the wet path is taken off the delay time.
+        const float latency = static_cast<float>( _reduced_rate_path.getLatency() );
+        const float rate_factor = static_cast<float>( _reduced_rate_path.getFactor() );
+
+        _shimmer_gain.setTargetValue( _shimmer_enabled ? 1.0f : 0.0f );
+        _exact_modulation_gain.setTargetValue( _exact_modulation ? 1.0f : 0.0f );
+
+        DelayNetworkParameters dnp;
+        dnp.num_channels = num_channels;
+
+        // A delay of zero wraps around to the longest delay, and anything
+        // longer is clamped to it.
+        dnp.num_delayed_samples = static_cast<size_t>( std::max( 0.0f, delay - latency ) / rate_factor );
+        if ( dnp.num_delayed_samples == 0 || dnp.num_delayed_samples > _max_delay )
+            dnp.num_delayed_samples = _max_delay;
+
+        // With a modulated delay, the delay time is fractional and may vary by
+        // +/- the modulation depth around the (unquantized) base delay.
+        dnp.mod_depth = parameters.mod_depth * 0.001f * _delay_rate; // float milliseconds to float samples
+        dnp.modulated = dnp.mod_depth > 0.0f;
+        dnp.base_delay = std::min( (delay - latency) / rate_factor, static_cast<float>( _max_delay ) );
+        dnp.min_modulated_delay = static_cast<size_t>( dspLimit( 1.0f, static_cast<float>( _buffer_size - 2 ), dnp.base_delay - dnp.mod_depth ) );
+
+        // When the delay changes (a tempo ramp, automation, a program change),
+        // the read position glides to the new one rather than jumping, with
+        // fractional reads, over a fixed time that may span several blocks.
+        // A change during a glide continues from where the read position is.
+        if ( _glide_target < 0.0f )
+        {
+            _glide_target = dnp.base_delay;
+        }
+        else if ( dnp.base_delay != _glide_target )
+        {
+            _glide_delay = _glide_remaining > 0 ? _glide_delay : _glide_target;
+            _glide_target = dnp.base_delay;
+            _glide_remaining = _glide_length;
+            _glide_step = (_glide_target - _glide_delay) / static_cast<float>( _glide_remaining );
+        }
+
+        dnp.lfo = &LfoWavetable::get( parameters.mod_shape );
+        dnp.lfo_increment = parameters.mod_rate / _delay_rate / dnp.lfo->getNumCycles();
+        dnp.lfo_offset = parameters.mod_phase * (1.0f/360.0f) / dnp.lfo->getNumCycles(); // degrees to table periods
+
+        // The shimmer pitch-shifts (part of) the signal that is fed back, so
+        // that each repetition ends up another step higher or lower.
+        dnp.shimmer = parameters.shimmer_semitones != 0.0f && parameters.shimmer_mix > 0.0f && (_shimmer_gain.isSmoothing() || _shimmer_gain.getTargetValue() > 0.0f);
+        dnp.shimmer_ratio = ::exp2f( parameters.shimmer_semitones * (1.0f/12.0f) );
+        dnp.shimmer_delay = dnp.modulated ? dnp.base_delay : static_cast<float>( dnp.num_delayed_samples );
+        dnp.shimmer_mix = parameters.shimmer_mix;
+
+        dnp.feedback = parameters.feedback;
+        dnp.pingpong = parameters.pingpong;
+
+        const float cs0 = ::cosf( 0.25f * static_cast<float>( DSP_PI ) * (1.0f + pan) );
+        const float cs1 = ::cosf( 0.25f * static_cast<float>( DSP_PI ) * (1.0f - pan) );
+
+        Ducker::Settings duck_settings;
+        duck_settings.amount_db = parameters.duck_amount_db;
+        duck_settings.threshold_db = parameters.duck_threshold_db;
+        duck_settings.attack_ms = parameters.duck_attack_ms;
+        duck_settings.release_ms = parameters.duck_release_ms;
+        if ( !sidechain_channels )
+            num_sidechain_channels = 0;
+        num_sidechain_channels = dspLimit( 0, MAX_CHANNELS, num_sidechain_channels );
+
+        float* input0 = _input_buffers[0].data();
+        float* input1 = stereo ? _input_buffers[1].data() : input0;
+        float* wet0 = _wet_buffers[0].data();
+        float* wet1 = stereo ? _wet_buffers[1].data() : wet0;
+
+        Level wet_level;
+        _input_level = _feedback_level = Level();
+
+        for ( int offset = 0; offset < num_samples; )
+        {
+            const int n = std::min( num_samples - offset, _max_block_size );
+
+            float* io0 = channels[0] + offset;
+            float* io1 = stereo ? channels[1] + offset : io0;
+
+            _input_level.add( _kernels, io0, n );
+            if ( stereo )
+                _input_level.add( _kernels, io1, n );
+
+            if ( stereo )
+                _kernels.mid_side_pan( io0, io1, input0, input1, n, cs0, cs1, gain );
+            else
+                _kernels.gain( io0, input0, n, gain );
+
+            if ( _reduced_rate_path.getFactor() > 1 )
+            {
+                float* reduced_input0 = _reduced_input_buffers[0].data();
+                float* reduced_input1 = stereo ? _reduced_input_buffers[1].data() : reduced_input0;
+                float* reduced_wet0 = _reduced_wet_buffers[0].data();
+                float* reduced_wet1 = stereo ? _reduced_wet_buffers[1].data() : reduced_wet0;
+
+                const int reduced_n = _reduced_rate_path.decimate( 0, input0, n, reduced_input0 );
+                if ( stereo )
+                    _reduced_rate_path.decimate( 1, input1, n, reduced_input1 );
+
+                _process_delay_network( reduced_input0, reduced_input1, reduced_wet0, reduced_wet1, reduced_n, dnp );
+
+                _reduced_rate_path.interpolate( 0, reduced_wet0, reduced_n, wet0, n );
+                if ( stereo )
+                    _reduced_rate_path.interpolate( 1, reduced_wet1, reduced_n, wet1, n );
+            }
+            else
+            {
+                _process_delay_network( input0, input1, wet0, wet1, n, dnp );
+            }
+
+            // The dry input is still untouched here, so it can be the key.
+            const float* key[MAX_CHANNELS] = { io0, io1 };
+            for ( int c = 0; c < num_sidechain_channels; ++c )
+                key[c] = sidechain_channels[c] + offset;
+            float* const wet[MAX_CHANNELS] = { wet0, wet1 };
+            _ducker.process( _kernels, key, num_sidechain_channels > 0 ? num_sidechain_channels : num_channels, wet, num_channels, n, duck_settings );
+
+            wet_level.add( _kernels, wet0, n );
+            if ( stereo )
+                wet_level.add( _kernels, wet1, n );
+
+            // The dry signal is consumed now, so the output can be mixed in place.
+            if ( wet_channels )
+            {
+                _kernels.gain( wet0, wet_channels[0] + offset, n, parameters.wet );
+                _kernels.gain( io0, io0, n, parameters.dry );
+                if ( stereo )
+                {
+                    _kernels.gain( wet1, wet_channels[1] + offset, n, parameters.wet );
+                    _kernels.gain( io1, io1, n, parameters.dry );
+                }
+            }
+            else
+            {
+                _kernels.mix( io0, wet0, io0, n, parameters.dry, parameters.wet );
+                if ( stereo )
+                    _kernels.mix( io1, wet1, io1, n, parameters.dry, parameters.wet );
+            }
+
+            offset += n;
+        } // for part
+
+        _delay_samples = dnp.num_delayed_samples * static_cast<size_t>( _reduced_rate_path.getFactor() );
+        wet_level.peak *= parameters.wet;
+        wet_level.sum_of_squares *= parameters.wet * parameters.wet;
+        _wet_level = wet_level;
+        _feedback_level.peak *= dnp.feedback;
+        _feedback_level.sum_of_squares *= dnp.feedback * dnp.feedback;
+    }
+
+public:
+    /** The delay of the last block, in samples at the full rate. */
+    size_t getDelayInSamples() const { return _delay_samples; }
+
+    /** The peak level of the (scaled) wet signal in the last block. */
+    float getWetPeak() const { return _wet_level.peak; }
+
+    /** The levels of the last block: the input before gain and pan, the (scaled) wet output, and what was fed back into the delay line. */
+    const Level& getInputLevel() const { return _input_level; }
+    const Level& getWetLevel() const { return _wet_level; }
+    const Level& getFeedbackLevel() const { return _feedback_level; }
+
+    /** The memory held by the ring and scratch buffers. */
+    size_t getBufferBytes() const { return _buffer_bytes; }
+
+    const DspKernels& getKernels() const { return _kernels; }
+
+private:
+    struct DelayNetworkParameters
+    {
+        int num_channels;
+
+        size_t num_delayed_samples;
+
+        bool modulated;
+        float base_delay;
+        float mod_depth;
+        size_t min_modulated_delay;
+        const LfoWavetable* lfo;
+        double lfo_increment;
+        double lfo_offset;
+
+        bool shimmer;
+        float shimmer_ratio;
+        float shimmer_delay;
+        float shimmer_mix;
+
+        float feedback;
+        float pingpong;
+    };
+
+    /** A linear ramp towards a target value, like juce::LinearSmoothedValue. */
+    class Ramp
+    {
+    public:
+        void reset(float rate, float ramp_seconds, float value)
+        {
+            _ramp_length = std::max( 1, static_cast<int>( ::floor( rate * ramp_seconds ) ) );
+            _current = _target = value;
+            _step = 0.0f;
+            _countdown = 0;
+        }
+
+        void setTargetValue(float target)
+        {
+            if ( target == _target )
+                return;
+            _target = target;
+            _countdown = _ramp_length;
+            _step = (_target - _current) / static_cast<float>( _countdown );
+        }
+
+        bool isSmoothing() const { return _countdown > 0; }
+        float getCurrentValue() const { return _current; }
+        float getTargetValue() const { return _target; }
+
+        /** Advances by the given number of samples and returns the new current value. */
+        float skip(int num_samples)
+        {
+            if ( num_samples >= _countdown )
+            {
+                _current = _target;
+                _countdown = 0;
+            }
+            else
+            {
+                _current += _step * static_cast<float>( num_samples );
+                _countdown -= num_samples;
+            }
+            return _current;
+        }
+
+    private:
+        int _ramp_length = 1;
+        float _current = 1.0f;
+        float _target = 1.0f;
+        float _step = 0.0f;
+        int _countdown = 0;
+    };
+
+private:
+    float _sample_rate;
+    int _max_block_size;
+
+    float _delay_rate;
+    ReducedRatePath _reduced_rate_path;
+    std::vector<float> _reduced_input_buffers[MAX_CHANNELS];
+    std::vector<float> _reduced_wet_buffers[MAX_CHANNELS];
+
+    size_t _buffer_index;
+    size_t _buffer_size;
+    size_t _max_delay;          // in samples at the delay rate
+    std::vector<float> _sample_buffers[MAX_CHANNELS];
+
+    const DspKernels& _kernels;
+    std::vector<float> _input_buffers[MAX_CHANNELS];
+    std::vector<float> _wet_buffers[MAX_CHANNELS];
+
+    double _lfo_phase;
+
+    TempoSync _tempo_sync;
+    float _glide_delay;
+    float _glide_target;
+    float _glide_step;
+    int _glide_remaining;
+    int _glide_length;          // in samples at the delay rate
+
+    GrainPitchShifter _pitch_shifter;
+    std::vector<float> _shimmer_buffers[MAX_CHANNELS];
+    std::vector<float> _coarse_buffers[MAX_CHANNELS];
+
+    Ducker _ducker;
+
+    bool _exact_modulation;
+    bool _shimmer_enabled;
+    Ramp _shimmer_gain;
+    Ramp _exact_modulation_gain;
+
+    size_t _delay_samples;
+    Level _input_level;
+    Level _wet_level;
+    Level _feedback_level;
+    size_t _buffer_bytes;
+
+private:
+    // The cheap variant of the modulated read: the LFO is evaluated only once
+    // per few samples and interpolated linearly in between, so that the delay
+    // glides rather than steps. The read itself is the same as the exact one.
+    void _coarse_modulated_read(const float* ring, size_t write_index, double lfo_phase, float* out, int num_samples, const DelayNetworkParameters& dnp) const
+    {
+        const int CONTROL_INTERVAL = 16;
+
+        float lfo_start;
+        dnp.lfo->render( lfo_phase, 0.0, &lfo_start, 1 );
+        for ( int offset = 0; offset < num_samples; offset += CONTROL_INTERVAL )
+        {
+            const int n = std::min( CONTROL_INTERVAL, num_samples - offset );
+
+            float lfo_end;
+            dnp.lfo->render( lfo_phase + dnp.lfo_increment * (offset + n), 0.0, &lfo_end, 1 );
+            const float step = (lfo_end - lfo_start) / static_cast<float>( n );
+            for ( int i = 0; i < n; ++i )
+                out[offset + i] = lfo_start + step * static_cast<float>( i );
+            lfo_start = lfo_end;
+        }
+        _kernels.modulated_read( ring, static_cast<int>( _buffer_size ), static_cast<int>( write_index ), out, out, num_samples, dnp.base_delay, dnp.mod_depth );
+    }
+
+    // The exact modulated read, crossfaded with the coarse one while the
+    // quality changes.
+    void _modulated_read(const float* ring, size_t write_index, double lfo_phase, float* out, float* coarse_out, int num_samples, const DelayNetworkParameters& dnp,
+                         float exact_start, float exact_end)
+    {
+        if ( exact_start == 0.0f && exact_end == 0.0f )
+        {
+            _coarse_modulated_read( ring, write_index, lfo_phase, out, num_samples, dnp );
+            return;
+        }
+
+        dnp.lfo->render( lfo_phase, dnp.lfo_increment, out, num_samples );
+        _kernels.modulated_read( ring, static_cast<int>( _buffer_size ), static_cast<int>( write_index ), out, out, num_samples, dnp.base_delay, dnp.mod_depth );
+        if ( exact_start == 1.0f && exact_end == 1.0f )
+            return;
+
+        const float increment = (exact_end - exact_start) / static_cast<float>( num_samples );
+        _coarse_modulated_read( ring, write_index, lfo_phase, coarse_out, num_samples, dnp );
+        _kernels.gain_ramp( out, out, num_samples, exact_start, increment );
+        _kernels.gain_ramp( coarse_out, coarse_out, num_samples, 1.0f - exact_start, -increment );
+        _kernels.mix( out, coarse_out, out, num_samples, 1.0f, 1.0f );
+    }
+
+    void _process_delay_network(const float* in0, const float* in1, float* wet0, float* wet1, int num_samples, const DelayNetworkParameters& dnp)
+    {
+        // The block is processed in segments within which neither the write nor
+        // the read position wraps around the ring buffer, and which are no longer
+        // than the delay itself, so that no sample is read within the segment
+        // that has been written within the same segment. Each segment can then
+        // be handed to the vectorized kernels as a whole.
+        const bool stereo = dnp.num_channels == 2;
+        const int ring_size = static_cast<int>( _buffer_size );
+
+        float* ring0 = _sample_buffers[ 0 ].data();
+        float* ring1 = stereo ? _sample_buffers[ 1 ].data() : ring0;
+        float* shimmer0 = _shimmer_buffers[0].data();
+        float* shimmer1 = stereo ? _shimmer_buffers[1].data() : shimmer0;
+        float* coarse0 = _coarse_buffers[0].data();
+        float* coarse1 = _coarse_buffers[1].data();
+
+        for ( int offset = 0; offset < num_samples; )
+        {
+            const size_t current_index = _buffer_index;
+            const size_t delayed_index = (_buffer_index + _buffer_size - dnp.num_delayed_samples) % _buffer_size;
+
+            // The modulated read handles the wrap-around of its read positions itself.
+            const bool gliding = _glide_remaining > 0;
+            size_t segment_size = static_cast<size_t>( num_samples - offset );
+            if ( gliding )
+            {
+                const float min_delay = std::min( _glide_delay, _glide_target ) - (dnp.modulated ? dnp.mod_depth : 0.0f);
+                const size_t min_glide_delay = static_cast<size_t>( dspLimit( 1.0f, static_cast<float>( _buffer_size - 2 ), min_delay ) );
+                segment_size = std::min( { segment_size, static_cast<size_t>( _glide_remaining ), _buffer_size - current_index, min_glide_delay } );
+            }
+            else if ( dnp.modulated )
+                segment_size = std::min( { segment_size, _buffer_size - current_index, dnp.min_modulated_delay } );
+            else
+                segment_size = std::min( { segment_size, _buffer_size - current_index, _buffer_size - delayed_index } );
+            if ( !gliding )
+                segment_size = std::min( segment_size, dnp.num_delayed_samples );
+            const int n = static_cast<int>( segment_size );
+
+            const float* input0 = in0 + offset;
+            const float* input1 = in1 + offset;
+            float* tap0 = wet0 + offset;
+            float* tap1 = wet1 + offset;
+
+            const float exact_start = _exact_modulation_gain.getCurrentValue();
+            const float exact_end = _exact_modulation_gain.skip( n );
+
+            if ( gliding )
+            {
+                // The LFO (if any) becomes a per-sample offset from the glide's current delay.
+                for ( int c = 0; c < (stereo ? 2 : 1); ++c )
+                {
+                    float* tap = c == 0 ? tap0 : tap1;
+                    if ( dnp.modulated )
+                    {
+                        dnp.lfo->render( _lfo_phase + (c == 0 ? 0.0 : dnp.lfo_offset), dnp.lfo_increment, tap, n );
+                        _kernels.gain( tap, tap, n, dnp.mod_depth );
+                    }
+                    else
+                        std::fill( tap, tap + n, 0.0f );
+                    for ( int i = 0; i < n; ++i )
+                        tap[i] += _glide_step * static_cast<float>( i );
+                    _kernels.modulated_read( c == 0 ? ring0 : ring1, ring_size, static_cast<int>( current_index ), tap, tap, n, _glide_delay, 1.0f );
+                }
+                _glide_delay += _glide_step * static_cast<float>( n );
+                _glide_remaining -= n;
+                if ( _glide_remaining == 0 )
+                    _glide_delay = _glide_target;
+            }
+            else if ( dnp.modulated )
+            {
+                _modulated_read( ring0, current_index, _lfo_phase, tap0, coarse0, n, dnp, exact_start, exact_end );
+                if ( stereo )
+                    _modulated_read( ring1, current_index, _lfo_phase + dnp.lfo_offset, tap1, coarse1, n, dnp, exact_start, exact_end );
+            }
+            else
+            {
+                std::copy( ring0 + delayed_index, ring0 + delayed_index + n, tap0 );
+                if ( stereo )
+                    std::copy( ring1 + delayed_index, ring1 + delayed_index + n, tap1 );
+            }
+            _lfo_phase += dnp.lfo_increment * n;
+            _lfo_phase -= ::floor( _lfo_phase );
+
+            const float* feedback0 = tap0;
+            const float* feedback1 = tap1;
+
+            if ( dnp.shimmer )
+            {
+                const float shimmer_mix = dnp.shimmer_mix * _shimmer_gain.skip( n );
+
+                _pitch_shifter.advance( dnp.shimmer_ratio, n );
+                _pitch_shifter.read( _kernels, ring0, ring_size, static_cast<int>( current_index ), dnp.shimmer_delay, shimmer0, n );
+                _kernels.mix( shimmer0, tap0, shimmer0, n, shimmer_mix, 1.0f - shimmer_mix );
+                if ( stereo )
+                {
+                    _pitch_shifter.read( _kernels, ring1, ring_size, static_cast<int>( current_index ), dnp.shimmer_delay, shimmer1, n );
+                    _kernels.mix( shimmer1, tap1, shimmer1, n, shimmer_mix, 1.0f - shimmer_mix );
+                }
+                feedback0 = shimmer0;
+                feedback1 = shimmer1;
+            }
+
+            // Measured before the ping-pong mix and scaled by the feedback afterwards, in process().
+            _feedback_level.add( _kernels, feedback0, n );
+            if ( stereo )
+                _feedback_level.add( _kernels, feedback1, n );
+
+            // In mono, both "channels" alias the same memory and thus yield the same values.
+            _kernels.feedback( input0, input1, feedback0, feedback1, ring0 + current_index, ring1 + current_index, n, dnp.feedback, dnp.pingpong );
+
+            _buffer_index = (_buffer_index + segment_size) % _buffer_size;
+            offset += n;
+        } // for segment
+    }
+
+};
@@ -0,0 +1,39 @@
+/*
+  ==============================================================================
+
+    DspCommon.h
+    Created: 19 Oct 2026 8:31:52pm
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+// The few basics the DSP core needs instead of JUCE, so that DrEchoEngine
+// and its building blocks compile without any JUCE module.
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#if defined( __x86_64__ ) || defined( __i386__ ) || defined( _M_X64 ) || defined( _M_IX86 )
+ #define DRECHO_INTEL 1
+#else
+ #define DRECHO_INTEL 0
+#endif
+
+static const double DSP_PI = 3.14159265358979323846;
+static const double DSP_TWO_PI = 2.0 * DSP_PI;
+static const double DSP_HALF_PI = 0.5 * DSP_PI;
+
+/** Clamps value to [lower; upper], with the argument order of juce::jlimit. */
+template <typename T>
+inline T dspLimit(T lower, T upper, T value)
+{
+    return value < lower ? lower : (upper < value ? upper : value);
+}
@@ -0,0 +1,631 @@
+/*
+  ==============================================================================
+
+    DspKernels.cpp
+    Created: 19 Oct 2026 9:12:40am
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#include "DspKernels.h"
+
+#include <cctype>
+#include <cstdlib>
+#include <string>
+
+#if DRECHO_INTEL
+ #include <immintrin.h>
+ #if defined( _MSC_VER )
+  #include <intrin.h>
+  #define DRECHO_TARGET_SSE2
+  #define DRECHO_TARGET_AVX2
+  #define DRECHO_TARGET_AVX512
+ #else
+  #define DRECHO_TARGET_SSE2 __attribute__((target("sse2")))
+  #define DRECHO_TARGET_AVX2 __attribute__((target("avx2")))
+  #define DRECHO_TARGET_AVX512 __attribute__((target("avx512f")))
+ #endif
+#endif
+
+// Every variant has to compute what the scalar reference computes, rounding
+// included: the AVX-512 target (and any -march with FMA) would let the
+// compiler fuse a multiply and an add into one rounding, which, with the
+// fractional read position in a feedback loop, adds up to audible
+// differences. MSVC doesn't contract by default.
+#if defined( __clang__ )
+ #pragma clang fp contract(off)
+#elif defined( __GNUC__ )
+ #pragma GCC optimize ("fp-contract=off")
+#endif
+
+//==============================================================================
+// Scalar reference. The vectorized variants fall back to these for the
+// remainder of a block that doesn't fill a whole register.
+
+static void _mid_side_pan_scalar(const float* in0, const float* in1, float* out0, float* out1, int num_samples, float cs0, float cs1, float gain)
+{
+    for ( int i = 0; i < num_samples; ++i )
+    {
+        const float M = 0.5f * (in0[i] + in1[i]);
+        const float S = in0[i] - in1[i];
+        out0[i] = (cs0 * M + S) * gain;
+        out1[i] = (cs1 * M - S) * gain;
+    }
+}
+
+static void _gain_scalar(const float* in, float* out, int num_samples, float gain)
+{
+    for ( int i = 0; i < num_samples; ++i )
+        out[i] = in[i] * gain;
+}
+
+static void _gain_ramp_scalar(const float* in, float* out, int num_samples, float start, float increment)
+{
+    for ( int i = 0; i < num_samples; ++i )
+        out[i] = in[i] * (start + increment * static_cast<float>( i + 1 ));
+}
+
+static void _mix_scalar(const float* dry, const float* wet, float* out, int num_samples, float dry_gain, float wet_gain)
+{
+    for ( int i = 0; i < num_samples; ++i )
+        out[i] = dry_gain * dry[i] + wet_gain * wet[i];
+}
+
+static void _feedback_scalar(const float* in0, const float* in1, const float* wet0, const float* wet1, float* out0, float* out1, int num_samples, float feedback, float pingpong)
+{
+    for ( int i = 0; i < num_samples; ++i )
+    {
+        const float w0 = wet0[i];
+        const float w1 = wet1[i];
+        out0[i] = in0[i] + feedback * (w0 + pingpong * (w1 - w0));
+        out1[i] = in1[i] + feedback * (w1 + pingpong * (w0 - w1));
+    }
+}
+
+static void _modulated_read_scalar(const float* ring, int ring_size, int write_index, const float* lfo, float* out, int num_samples, float base_delay, float depth)
+{
+    const float min_delay = 1.0f;
+    const float max_delay = static_cast<float>( ring_size - 2 );
+    for ( int i = 0; i < num_samples; ++i )
+    {
+        const float delay = std::min( std::max( base_delay + depth * lfo[i], min_delay ), max_delay );
+        const int delay_int = static_cast<int>( delay );
+        const float t = 1.0f - (delay - static_cast<float>( delay_int ));
+        int index0 = write_index + i - delay_int - 1;
+        if ( index0 < 0 )
+            index0 += ring_size;
+        int index1 = index0 + 1;
+        if ( index1 >= ring_size )
+            index1 -= ring_size;
+        const float a = ring[ index0 ];
+        const float b = ring[ index1 ];
+        out[i] = a + t * (b - a);
+    }
+}
+
+static void _level_scalar(const float* in, int num_samples, float& peak, float& sum_of_squares)
+{
+    float p = peak;
+    float sum = 0.0f;
+    for ( int i = 0; i < num_samples; ++i )
+    {
+        p = std::max( p, std::abs( in[i] ) );
+        sum += in[i] * in[i];
+    }
+    peak = p;
+    sum_of_squares += sum;
+}
+
+#if DRECHO_INTEL
+//==============================================================================
+// SSE2
+
+DRECHO_TARGET_SSE2 static void _mid_side_pan_sse2(const float* in0, const float* in1, float* out0, float* out1, int num_samples, float cs0, float cs1, float gain)
+{
+    const __m128 half = _mm_set1_ps( 0.5f );
+    const __m128 c0 = _mm_set1_ps( cs0 );
+    const __m128 c1 = _mm_set1_ps( cs1 );
+    const __m128 g = _mm_set1_ps( gain );
+    int i = 0;
+    for ( ; i + 4 <= num_samples; i += 4 )
+    {
+        const __m128 a = _mm_loadu_ps( in0 + i );
+        const __m128 b = _mm_loadu_ps( in1 + i );
+        const __m128 M = _mm_mul_ps( half, _mm_add_ps( a, b ) );
+        const __m128 S = _mm_sub_ps( a, b );
+        _mm_storeu_ps( out0 + i, _mm_mul_ps( _mm_add_ps( _mm_mul_ps( c0, M ), S ), g ) );
+        _mm_storeu_ps( out1 + i, _mm_mul_ps( _mm_sub_ps( _mm_mul_ps( c1, M ), S ), g ) );
+    }
+    _mid_side_pan_scalar( in0 + i, in1 + i, out0 + i, out1 + i, num_samples - i, cs0, cs1, gain );
+}
+
+DRECHO_TARGET_SSE2 static void _gain_sse2(const float* in, float* out, int num_samples, float gain)
+{
+    const __m128 g = _mm_set1_ps( gain );
+    int i = 0;
+    for ( ; i + 4 <= num_samples; i += 4 )
+        _mm_storeu_ps( out + i, _mm_mul_ps( _mm_loadu_ps( in + i ), g ) );
+    _gain_scalar( in + i, out + i, num_samples - i, gain );
+}
+
+DRECHO_TARGET_SSE2 static void _gain_ramp_sse2(const float* in, float* out, int num_samples, float start, float increment)
+{
+    const __m128 s = _mm_set1_ps( start );
+    const __m128 inc = _mm_set1_ps( increment );
+    __m128 index = _mm_setr_ps( 1.0f, 2.0f, 3.0f, 4.0f );
+    const __m128 step = _mm_set1_ps( 4.0f );
+    int i = 0;
+    for ( ; i + 4 <= num_samples; i += 4 )
+    {
+        _mm_storeu_ps( out + i, _mm_mul_ps( _mm_loadu_ps( in + i ), _mm_add_ps( s, _mm_mul_ps( inc, index ) ) ) );
+        index = _mm_add_ps( index, step );
+    }
+    _gain_ramp_scalar( in + i, out + i, num_samples - i, start + increment * static_cast<float>( i ), increment );
+}
+
+DRECHO_TARGET_SSE2 static void _mix_sse2(const float* dry, const float* wet, float* out, int num_samples, float dry_gain, float wet_gain)
+{
+    const __m128 dg = _mm_set1_ps( dry_gain );
+    const __m128 wg = _mm_set1_ps( wet_gain );
+    int i = 0;
+    for ( ; i + 4 <= num_samples; i += 4 )
+        _mm_storeu_ps( out + i, _mm_add_ps( _mm_mul_ps( dg, _mm_loadu_ps( dry + i ) ), _mm_mul_ps( wg, _mm_loadu_ps( wet + i ) ) ) );
+    _mix_scalar( dry + i, wet + i, out + i, num_samples - i, dry_gain, wet_gain );
+}
+
+DRECHO_TARGET_SSE2 static void _feedback_sse2(const float* in0, const float* in1, const float* wet0, const float* wet1, float* out0, float* out1, int num_samples, float feedback, float pingpong)
+{
+    const __m128 fb = _mm_set1_ps( feedback );
+    const __m128 pp = _mm_set1_ps( pingpong );
+    int i = 0;
+    for ( ; i + 4 <= num_samples; i += 4 )
+    {
+        const __m128 w0 = _mm_loadu_ps( wet0 + i );
+        const __m128 w1 = _mm_loadu_ps( wet1 + i );
+        const __m128 r0 = _mm_add_ps( _mm_loadu_ps( in0 + i ), _mm_mul_ps( fb, _mm_add_ps( w0, _mm_mul_ps( pp, _mm_sub_ps( w1, w0 ) ) ) ) );
+        const __m128 r1 = _mm_add_ps( _mm_loadu_ps( in1 + i ), _mm_mul_ps( fb, _mm_add_ps( w1, _mm_mul_ps( pp, _mm_sub_ps( w0, w1 ) ) ) ) );
+        _mm_storeu_ps( out0 + i, r0 );
+        _mm_storeu_ps( out1 + i, r1 );
+    }
+    _feedback_scalar( in0 + i, in1 + i, wet0 + i, wet1 + i, out0 + i, out1 + i, num_samples - i, feedback, pingpong );
+}
+
+DRECHO_TARGET_SSE2 static void _modulated_read_sse2(const float* ring, int ring_size, int write_index, const float* lfo, float* out, int num_samples, float base_delay, float depth)
+{
+    const __m128 base = _mm_set1_ps( base_delay );
+    const __m128 dep = _mm_set1_ps( depth );
+    const __m128 min_delay = _mm_set1_ps( 1.0f );
+    const __m128 max_delay = _mm_set1_ps( static_cast<float>( ring_size - 2 ) );
+    const __m128 one = _mm_set1_ps( 1.0f );
+    const __m128i size = _mm_set1_epi32( ring_size );
+    const __m128i last = _mm_set1_epi32( ring_size - 1 );
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ramp = _mm_setr_epi32( -1, 0, 1, 2 ); // i - 1
+    alignas(16) int indices0[4];
+    alignas(16) int indices1[4];
+    int i = 0;
+    for ( ; i + 4 <= num_samples; i += 4 )
+    {
+        const __m128 delay = _mm_min_ps( _mm_max_ps( _mm_add_ps( base, _mm_mul_ps( dep, _mm_loadu_ps( lfo + i ) ) ), min_delay ), max_delay );
+        const __m128i delay_int = _mm_cvttps_epi32( delay );
+        const __m128 t = _mm_sub_ps( one, _mm_sub_ps( delay, _mm_cvtepi32_ps( delay_int ) ) );
+        __m128i index0 = _mm_sub_epi32( _mm_add_epi32( _mm_set1_epi32( write_index + i ), ramp ), delay_int );
+        index0 = _mm_add_epi32( index0, _mm_and_si128( _mm_cmplt_epi32( index0, zero ), size ) );
+        __m128i index1 = _mm_add_epi32( index0, _mm_set1_epi32( 1 ) );
+        index1 = _mm_sub_epi32( index1, _mm_and_si128( _mm_cmpgt_epi32( index1, last ), size ) );
+        _mm_store_si128( reinterpret_cast<__m128i*>( indices0 ), index0 );
+        _mm_store_si128( reinterpret_cast<__m128i*>( indices1 ), index1 );
+        const __m128 a = _mm_setr_ps( ring[ indices0[0] ], ring[ indices0[1] ], ring[ indices0[2] ], ring[ indices0[3] ] );
+        const __m128 b = _mm_setr_ps( ring[ indices1[0] ], ring[ indices1[1] ], ring[ indices1[2] ], ring[ indices1[3] ] );
+        _mm_storeu_ps( out + i, _mm_add_ps( a, _mm_mul_ps( t, _mm_sub_ps( b, a ) ) ) );
+    }
+    _modulated_read_scalar( ring, ring_size, write_index + i, lfo + i, out + i, num_samples - i, base_delay, depth );
+}
+
+DRECHO_TARGET_SSE2 static void _level_sse2(const float* in, int num_samples, float& peak, float& sum_of_squares)
+{
+    const __m128 sign = _mm_set1_ps( -0.0f );
+    __m128 p = _mm_setzero_ps();
+    __m128 sum = _mm_setzero_ps();
+    int i = 0;
+    for ( ; i + 4 <= num_samples; i += 4 )
+    {
+        const __m128 x = _mm_loadu_ps( in + i );
+        p = _mm_max_ps( p, _mm_andnot_ps( sign, x ) );
+        sum = _mm_add_ps( sum, _mm_mul_ps( x, x ) );
+    }
+    alignas(16) float lanes_p[4];
+    alignas(16) float lanes_sum[4];
+    _mm_store_ps( lanes_p, p );
+    _mm_store_ps( lanes_sum, sum );
+    peak = std::max( { peak, lanes_p[0], lanes_p[1], lanes_p[2], lanes_p[3] } );
+    sum_of_squares += (lanes_sum[0] + lanes_sum[1]) + (lanes_sum[2] + lanes_sum[3]);
+    _level_scalar( in + i, num_samples - i, peak, sum_of_squares );
+}
+
+//==============================================================================
+// AVX2
+//
+// The remainders go to the SSE2 kernels, which aren't VEX-encoded: the upper
+// halves of the registers are cleared before, or else every SSE instruction
+// after a wide loop would pay for the transition (several times the cost of
+// the kernel itself at small block sizes).
+
+DRECHO_TARGET_AVX2 static void _mid_side_pan_avx2(const float* in0, const float* in1, float* out0, float* out1, int num_samples, float cs0, float cs1, float gain)
+{
+    const __m256 half = _mm256_set1_ps( 0.5f );
+    const __m256 c0 = _mm256_set1_ps( cs0 );
+    const __m256 c1 = _mm256_set1_ps( cs1 );
+    const __m256 g = _mm256_set1_ps( gain );
+    int i = 0;
+    for ( ; i + 8 <= num_samples; i += 8 )
+    {
+        const __m256 a = _mm256_loadu_ps( in0 + i );
+        const __m256 b = _mm256_loadu_ps( in1 + i );
+        const __m256 M = _mm256_mul_ps( half, _mm256_add_ps( a, b ) );
+        const __m256 S = _mm256_sub_ps( a, b );
+        _mm256_storeu_ps( out0 + i, _mm256_mul_ps( _mm256_add_ps( _mm256_mul_ps( c0, M ), S ), g ) );
+        _mm256_storeu_ps( out1 + i, _mm256_mul_ps( _mm256_sub_ps( _mm256_mul_ps( c1, M ), S ), g ) );
+    }
+    _mm256_zeroupper();
+    _mid_side_pan_sse2( in0 + i, in1 + i, out0 + i, out1 + i, num_samples - i, cs0, cs1, gain );
+}
+
+DRECHO_TARGET_AVX2 static void _gain_avx2(const float* in, float* out, int num_samples, float gain)
+{
+    const __m256 g = _mm256_set1_ps( gain );
+    int i = 0;
+    for ( ; i + 8 <= num_samples; i += 8 )
+        _mm256_storeu_ps( out + i, _mm256_mul_ps( _mm256_loadu_ps( in + i ), g ) );
+    _mm256_zeroupper();
+    _gain_sse2( in + i, out + i, num_samples - i, gain );
+}
+
+DRECHO_TARGET_AVX2 static void _gain_ramp_avx2(const float* in, float* out, int num_samples, float start, float increment)
+{
+    const __m256 s = _mm256_set1_ps( start );
+    const __m256 inc = _mm256_set1_ps( increment );
+    __m256 index = _mm256_setr_ps( 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f );
+    const __m256 step = _mm256_set1_ps( 8.0f );
+    int i = 0;
+    for ( ; i + 8 <= num_samples; i += 8 )
+    {
+        _mm256_storeu_ps( out + i, _mm256_mul_ps( _mm256_loadu_ps( in + i ), _mm256_add_ps( s, _mm256_mul_ps( inc, index ) ) ) );
+        index = _mm256_add_ps( index, step );
+    }
+    _mm256_zeroupper();
+    _gain_ramp_sse2( in + i, out + i, num_samples - i, start + increment * static_cast<float>( i ), increment );
+}
+
+DRECHO_TARGET_AVX2 static void _mix_avx2(const float* dry, const float* wet, float* out, int num_samples, float dry_gain, float wet_gain)
+{
+    const __m256 dg = _mm256_set1_ps( dry_gain );
+    const __m256 wg = _mm256_set1_ps( wet_gain );
+    int i = 0;
+    for ( ; i + 8 <= num_samples; i += 8 )
+        _mm256_storeu_ps( out + i, _mm256_add_ps( _mm256_mul_ps( dg, _mm256_loadu_ps( dry + i ) ), _mm256_mul_ps( wg, _mm256_loadu_ps( wet + i ) ) ) );
+    _mm256_zeroupper();
+    _mix_sse2( dry + i, wet + i, out + i, num_samples - i, dry_gain, wet_gain );
+}
+
+DRECHO_TARGET_AVX2 static void _feedback_avx2(const float* in0, const float* in1, const float* wet0, const float* wet1, float* out0, float* out1, int num_samples, float feedback, float pingpong)
+{
+    const __m256 fb = _mm256_set1_ps( feedback );
+    const __m256 pp = _mm256_set1_ps( pingpong );
+    int i = 0;
+    for ( ; i + 8 <= num_samples; i += 8 )
+    {
+        const __m256 w0 = _mm256_loadu_ps( wet0 + i );
+        const __m256 w1 = _mm256_loadu_ps( wet1 + i );
+        const __m256 r0 = _mm256_add_ps( _mm256_loadu_ps( in0 + i ), _mm256_mul_ps( fb, _mm256_add_ps( w0, _mm256_mul_ps( pp, _mm256_sub_ps( w1, w0 ) ) ) ) );
+        const __m256 r1 = _mm256_add_ps( _mm256_loadu_ps( in1 + i ), _mm256_mul_ps( fb, _mm256_add_ps( w1, _mm256_mul_ps( pp, _mm256_sub_ps( w0, w1 ) ) ) ) );
+        _mm256_storeu_ps( out0 + i, r0 );
+        _mm256_storeu_ps( out1 + i, r1 );
+    }
+    _mm256_zeroupper();
+    _feedback_sse2( in0 + i, in1 + i, wet0 + i, wet1 + i, out0 + i, out1 + i, num_samples - i, feedback, pingpong );
+}
+
+DRECHO_TARGET_AVX2 static void _modulated_read_avx2(const float* ring, int ring_size, int write_index, const float* lfo, float* out, int num_samples, float base_delay, float depth)
+{
+    const __m256 base = _mm256_set1_ps( base_delay );
+    const __m256 dep = _mm256_set1_ps( depth );
+    const __m256 min_delay = _mm256_set1_ps( 1.0f );
+    const __m256 max_delay = _mm256_set1_ps( static_cast<float>( ring_size - 2 ) );
+    const __m256 one = _mm256_set1_ps( 1.0f );
+    const __m256i size = _mm256_set1_epi32( ring_size );
+    const __m256i last = _mm256_set1_epi32( ring_size - 1 );
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i ramp = _mm256_setr_epi32( -1, 0, 1, 2, 3, 4, 5, 6 ); // i - 1
+    int i = 0;
+    for ( ; i + 8 <= num_samples; i += 8 )
+    {
+        const __m256 delay = _mm256_min_ps( _mm256_max_ps( _mm256_add_ps( base, _mm256_mul_ps( dep, _mm256_loadu_ps( lfo + i ) ) ), min_delay ), max_delay );
+        const __m256i delay_int = _mm256_cvttps_epi32( delay );
+        const __m256 t = _mm256_sub_ps( one, _mm256_sub_ps( delay, _mm256_cvtepi32_ps( delay_int ) ) );
+        __m256i index0 = _mm256_sub_epi32( _mm256_add_epi32( _mm256_set1_epi32( write_index + i ), ramp ), delay_int );
+        index0 = _mm256_add_epi32( index0, _mm256_and_si256( _mm256_cmpgt_epi32( zero, index0 ), size ) );
+        __m256i index1 = _mm256_add_epi32( index0, _mm256_set1_epi32( 1 ) );
+        index1 = _mm256_sub_epi32( index1, _mm256_and_si256( _mm256_cmpgt_epi32( index1, last ), size ) );
+        const __m256 a = _mm256_i32gather_ps( ring, index0, 4 );
+        const __m256 b = _mm256_i32gather_ps( ring, index1, 4 );
+        _mm256_storeu_ps( out + i, _mm256_add_ps( a, _mm256_mul_ps( t, _mm256_sub_ps( b, a ) ) ) );
+    }
+    _mm256_zeroupper();
+    _modulated_read_sse2( ring, ring_size, write_index + i, lfo + i, out + i, num_samples - i, base_delay, depth );
+}
+
+DRECHO_TARGET_AVX2 static void _level_avx2(const float* in, int num_samples, float& peak, float& sum_of_squares)
+{
+    const __m256 sign = _mm256_set1_ps( -0.0f );
+    __m256 p = _mm256_setzero_ps();
+    __m256 sum = _mm256_setzero_ps();
+    int i = 0;
+    for ( ; i + 8 <= num_samples; i += 8 )
+    {
+        const __m256 x = _mm256_loadu_ps( in + i );
+        p = _mm256_max_ps( p, _mm256_andnot_ps( sign, x ) );
+        sum = _mm256_add_ps( sum, _mm256_mul_ps( x, x ) );
+    }
+    alignas(32) float lanes_p[8];
+    alignas(32) float lanes_sum[8];
+    _mm256_store_ps( lanes_p, p );
+    _mm256_store_ps( lanes_sum, sum );
+    for ( int lane = 0; lane < 8; ++lane )
+    {
+        peak = std::max( peak, lanes_p[lane] );
+        sum_of_squares += lanes_sum[lane];
+    }
+    _mm256_zeroupper();
+    _level_sse2( in + i, num_samples - i, peak, sum_of_squares );
+}
+
+//==============================================================================
+// AVX-512
+
+DRECHO_TARGET_AVX512 static void _mid_side_pan_avx512(const float* in0, const float* in1, float* out0, float* out1, int num_samples, float cs0, float cs1, float gain)
+{
+    const __m512 half = _mm512_set1_ps( 0.5f );
+    const __m512 c0 = _mm512_set1_ps( cs0 );
+    const __m512 c1 = _mm512_set1_ps( cs1 );
+    const __m512 g = _mm512_set1_ps( gain );
+    int i = 0;
+    for ( ; i + 16 <= num_samples; i += 16 )
+    {
+        const __m512 a = _mm512_loadu_ps( in0 + i );
+        const __m512 b = _mm512_loadu_ps( in1 + i );
+        const __m512 M = _mm512_mul_ps( half, _mm512_add_ps( a, b ) );
+        const __m512 S = _mm512_sub_ps( a, b );
+        _mm512_storeu_ps( out0 + i, _mm512_mul_ps( _mm512_add_ps( _mm512_mul_ps( c0, M ), S ), g ) );
+        _mm512_storeu_ps( out1 + i, _mm512_mul_ps( _mm512_sub_ps( _mm512_mul_ps( c1, M ), S ), g ) );
+    }
+    _mm256_zeroupper();
+    _mid_side_pan_sse2( in0 + i, in1 + i, out0 + i, out1 + i, num_samples - i, cs0, cs1, gain );
+}
+
+DRECHO_TARGET_AVX512 static void _gain_avx512(const float* in, float* out, int num_samples, float gain)
+{
+    const __m512 g = _mm512_set1_ps( gain );
+    int i = 0;
+    for ( ; i + 16 <= num_samples; i += 16 )
+        _mm512_storeu_ps( out + i, _mm512_mul_ps( _mm512_loadu_ps( in + i ), g ) );
+    _mm256_zeroupper();
+    _gain_sse2( in + i, out + i, num_samples - i, gain );
+}
+
+DRECHO_TARGET_AVX512 static void _gain_ramp_avx512(const float* in, float* out, int num_samples, float start, float increment)
+{
+    const __m512 s = _mm512_set1_ps( start );
+    const __m512 inc = _mm512_set1_ps( increment );
+    __m512 index = _mm512_setr_ps( 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f, 10.0f, 11.0f, 12.0f, 13.0f, 14.0f, 15.0f, 16.0f );
+    const __m512 step = _mm512_set1_ps( 16.0f );
+    int i = 0;
+    for ( ; i + 16 <= num_samples; i += 16 )
+    {
+        _mm512_storeu_ps( out + i, _mm512_mul_ps( _mm512_loadu_ps( in + i ), _mm512_add_ps( s, _mm512_mul_ps( inc, index ) ) ) );
+        index = _mm512_add_ps( index, step );
+    }
+    _mm256_zeroupper();
+    _gain_ramp_sse2( in + i, out + i, num_samples - i, start + increment * static_cast<float>( i ), increment );
+}
+
+DRECHO_TARGET_AVX512 static void _mix_avx512(const float* dry, const float* wet, float* out, int num_samples, float dry_gain, float wet_gain)
+{
+    const __m512 dg = _mm512_set1_ps( dry_gain );
+    const __m512 wg = _mm512_set1_ps( wet_gain );
+    int i = 0;
+    for ( ; i + 16 <= num_samples; i += 16 )
+        _mm512_storeu_ps( out + i, _mm512_add_ps( _mm512_mul_ps( dg, _mm512_loadu_ps( dry + i ) ), _mm512_mul_ps( wg, _mm512_loadu_ps( wet + i ) ) ) );
+    _mm256_zeroupper();
+    _mix_sse2( dry + i, wet + i, out + i, num_samples - i, dry_gain, wet_gain );
+}
+
+DRECHO_TARGET_AVX512 static void _feedback_avx512(const float* in0, const float* in1, const float* wet0, const float* wet1, float* out0, float* out1, int num_samples, float feedback, float pingpong)
+{
+    const __m512 fb = _mm512_set1_ps( feedback );
+    const __m512 pp = _mm512_set1_ps( pingpong );
+    int i = 0;
+    for ( ; i + 16 <= num_samples; i += 16 )
+    {
+        const __m512 w0 = _mm512_loadu_ps( wet0 + i );
+        const __m512 w1 = _mm512_loadu_ps( wet1 + i );
+        const __m512 r0 = _mm512_add_ps( _mm512_loadu_ps( in0 + i ), _mm512_mul_ps( fb, _mm512_add_ps( w0, _mm512_mul_ps( pp, _mm512_sub_ps( w1, w0 ) ) ) ) );
+        const __m512 r1 = _mm512_add_ps( _mm512_loadu_ps( in1 + i ), _mm512_mul_ps( fb, _mm512_add_ps( w1, _mm512_mul_ps( pp, _mm512_sub_ps( w0, w1 ) ) ) ) );
+        _mm512_storeu_ps( out0 + i, r0 );
+        _mm512_storeu_ps( out1 + i, r1 );
+    }
+    _mm256_zeroupper();
+    _feedback_sse2( in0 + i, in1 + i, wet0 + i, wet1 + i, out0 + i, out1 + i, num_samples - i, feedback, pingpong );
+}
+DRECHO_TARGET_AVX512 static void _modulated_read_avx512(const float* ring, int ring_size, int write_index, const float* lfo, float* out, int num_samples, float base_delay, float depth)
+{
+    const __m512 base = _mm512_set1_ps( base_delay );
+    const __m512 dep = _mm512_set1_ps( depth );
+    const __m512 min_delay = _mm512_set1_ps( 1.0f );
+    const __m512 max_delay = _mm512_set1_ps( static_cast<float>( ring_size - 2 ) );
+    const __m512 one = _mm512_set1_ps( 1.0f );
+    const __m512i size = _mm512_set1_epi32( ring_size );
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i ramp = _mm512_setr_epi32( -1, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14 ); // i - 1
+    int i = 0;
+    for ( ; i + 16 <= num_samples; i += 16 )
+    {
+        const __m512 delay = _mm512_min_ps( _mm512_max_ps( _mm512_add_ps( base, _mm512_mul_ps( dep, _mm512_loadu_ps( lfo + i ) ) ), min_delay ), max_delay );
+        const __m512i delay_int = _mm512_cvttps_epi32( delay );
+        const __m512 t = _mm512_sub_ps( one, _mm512_sub_ps( delay, _mm512_cvtepi32_ps( delay_int ) ) );
+        __m512i index0 = _mm512_sub_epi32( _mm512_add_epi32( _mm512_set1_epi32( write_index + i ), ramp ), delay_int );
+        index0 = _mm512_mask_add_epi32( index0, _mm512_cmplt_epi32_mask( index0, zero ), index0, size );
+        __m512i index1 = _mm512_add_epi32( index0, _mm512_set1_epi32( 1 ) );
+        index1 = _mm512_mask_sub_epi32( index1, _mm512_cmpge_epi32_mask( index1, size ), index1, size );
+        const __m512 a = _mm512_i32gather_ps( index0, ring, 4 );
+        const __m512 b = _mm512_i32gather_ps( index1, ring, 4 );
+        _mm512_storeu_ps( out + i, _mm512_add_ps( a, _mm512_mul_ps( t, _mm512_sub_ps( b, a ) ) ) );
+    }
+    _mm256_zeroupper();
+    _modulated_read_sse2( ring, ring_size, write_index + i, lfo + i, out + i, num_samples - i, base_delay, depth );
+}
+
+DRECHO_TARGET_AVX512 static void _level_avx512(const float* in, int num_samples, float& peak, float& sum_of_squares)
+{
+    __m512 p = _mm512_setzero_ps();
+    __m512 sum = _mm512_setzero_ps();
+    int i = 0;
+    for ( ; i + 16 <= num_samples; i += 16 )
+    {
+        const __m512 x = _mm512_loadu_ps( in + i );
+        p = _mm512_max_ps( p, _mm512_abs_ps( x ) );
+        sum = _mm512_add_ps( sum, _mm512_mul_ps( x, x ) );
+    }
+    peak = std::max( peak, _mm512_reduce_max_ps( p ) );
+    sum_of_squares += _mm512_reduce_add_ps( sum );
+    _mm256_zeroupper();
+    _level_sse2( in + i, num_samples - i, peak, sum_of_squares );
+}
+#endif // DRECHO_INTEL
+
+//==============================================================================
+#if DRECHO_INTEL
+enum class _CpuFeature
+{
+    SSE2,
+    AVX2,
+    AVX512F,
+};
+
+// Besides the CPU, the OS has to preserve the wider registers, which both
+// __builtin_cpu_supports and the XCR0 check take into account.
+static bool _cpu_has(_CpuFeature feature)
+{
+   #if defined( _MSC_VER )
+    int info1[4] = {};
+    int info7[4] = {};
+    __cpuid( info1, 0 );
+    const int max_leaf = info1[0];
+    __cpuid( info1, 1 );
+    if ( max_leaf >= 7 )
+        __cpuidex( info7, 7, 0 );
+
+    const bool sse2 = (info1[3] & (1 << 26)) != 0;
+    const bool osxsave = (info1[2] & (1 << 27)) != 0;
+    const bool avx2 = (info7[1] & (1 << 5)) != 0;
+    const bool avx512f = (info7[1] & (1 << 16)) != 0;
+    const unsigned long long xcr0 = osxsave ? _xgetbv( 0 ) : 0;
+
+    switch ( feature )
+    {
+    case _CpuFeature::SSE2:     return sse2;
+    case _CpuFeature::AVX2:     return sse2 && avx2 && (xcr0 & 0x06) == 0x06;
+    case _CpuFeature::AVX512F:  return sse2 && avx512f && (xcr0 & 0xe6) == 0xe6;
+    }
+    return false;
+   #else
+    __builtin_cpu_init();
+    switch ( feature )
+    {
+    case _CpuFeature::SSE2:     return __builtin_cpu_supports( "sse2" );
+    case _CpuFeature::AVX2:     return __builtin_cpu_supports( "sse2" ) && __builtin_cpu_supports( "avx2" );
+    case _CpuFeature::AVX512F:  return __builtin_cpu_supports( "sse2" ) && __builtin_cpu_supports( "avx512f" );
+    }
+    return false;
+   #endif
+}
+#endif
+
+static const DspKernels _scalar_kernels = { DspKernels::InstructionSet::Scalar, "scalar", _mid_side_pan_scalar, _gain_scalar, _gain_ramp_scalar, _mix_scalar, _feedback_scalar, _modulated_read_scalar, _level_scalar };
+#if DRECHO_INTEL
+static const DspKernels _sse2_kernels = { DspKernels::InstructionSet::SSE2, "sse2", _mid_side_pan_sse2, _gain_sse2, _gain_ramp_sse2, _mix_sse2, _feedback_sse2, _modulated_read_sse2, _level_sse2 };
+static const DspKernels _avx2_kernels = { DspKernels::InstructionSet::AVX2, "avx2", _mid_side_pan_avx2, _gain_avx2, _gain_ramp_avx2, _mix_avx2, _feedback_avx2, _modulated_read_avx2, _level_avx2 };
+static const DspKernels _avx512_kernels = { DspKernels::InstructionSet::AVX512, "avx512", _mid_side_pan_avx512, _gain_avx512, _gain_ramp_avx512, _mix_avx512, _feedback_avx512, _modulated_read_avx512, _level_avx512 };
+#endif
+
+const DspKernels& DspKernels::scalar()
+{
+    return _scalar_kernels;
+}
+
+const DspKernels* DspKernels::find(InstructionSet instruction_set)
+{
+    switch ( instruction_set )
+    {
+    case InstructionSet::Scalar:
+        return &_scalar_kernels;
+   #if DRECHO_INTEL
+    case InstructionSet::SSE2:
+        return _cpu_has( _CpuFeature::SSE2 ) ? &_sse2_kernels : nullptr;
+    case InstructionSet::AVX2:
+        return _cpu_has( _CpuFeature::AVX2 ) ? &_avx2_kernels : nullptr;
+    case InstructionSet::AVX512:
+        return _cpu_has( _CpuFeature::AVX512F ) ? &_avx512_kernels : nullptr;
+   #endif
+    default:
+        return nullptr;
+    }
+}
+
+static const DspKernels& _select_kernels()
+{
+    std::string requested;
+    if ( const char* value = std::getenv( "DRECHO_SIMD" ) )
+    {
+        for ( const char* c = value; *c; ++c )
+        {
+            if ( !std::isspace( static_cast<unsigned char>( *c ) ) )
+                requested += static_cast<char>( std::tolower( static_cast<unsigned char>( *c ) ) );
+        }
+    }
+
+    const DspKernels::InstructionSet instruction_sets[] = {
+        DspKernels::InstructionSet::AVX512,
+        DspKernels::InstructionSet::AVX2,
+        DspKernels::InstructionSet::SSE2,
+        DspKernels::InstructionSet::Scalar,
+    };
+
+    // An explicit request is honoured if it is available at all, so that a
+    // narrower variant can be forced on a wider CPU (but not vice versa).
+    if ( !requested.empty() )
+    {
+        for ( auto instruction_set : instruction_sets )
+        {
+            const DspKernels* kernels = DspKernels::find( instruction_set );
+            if ( kernels && requested == kernels->name )
+                return *kernels;
+        }
+    }
+
+    for ( auto instruction_set : instruction_sets )
+    {
+        const DspKernels* kernels = DspKernels::find( instruction_set );
+        if ( kernels )
+            return *kernels;
+    }
+
+    return _scalar_kernels;
+}
+
+const DspKernels& DspKernels::select()
+{
+    static const DspKernels& kernels = _select_kernels();
+    return kernels;
+}
@@ -0,0 +1,75 @@
+/*
+  ==============================================================================
+
+    DspKernels.h
+    Created: 19 Oct 2026 9:12:40am
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "DspCommon.h"
+
+/**
+ * The block-based DSP kernels behind DrEchoAudioProcessor::processBlock,
+ * compiled for several instruction sets. All variants perform the same
+ * arithmetic in the same order as the scalar reference, without fused
+ * multiply-adds, so they give the same results; only the level reduction
+ * sums its squares in another order.
+ */
+struct DspKernels
+{
+    enum class InstructionSet
+    {
+        Scalar,
+        SSE2,
+        AVX2,
+        AVX512,
+    };
+
+    /** out0 = (cs0 * M + S) * gain, out1 = (cs1 * M - S) * gain, with M = (in0 + in1) / 2 and S = in0 - in1. */
+    using MidSidePanFunc = void (*)(const float* in0, const float* in1, float* out0, float* out1, int num_samples, float cs0, float cs1, float gain);
+    /** out = in * gain (out may alias in) */
+    using GainFunc = void (*)(const float* in, float* out, int num_samples, float gain);
+    /** out[i] = in[i] * (start + increment * (i + 1)), i.e. a gain ramp that ends on start + increment * num_samples (out may alias in) */
+    using GainRampFunc = void (*)(const float* in, float* out, int num_samples, float start, float increment);
+    /** out = dry_gain * dry + wet_gain * wet (out may alias dry) */
+    using MixFunc = void (*)(const float* dry, const float* wet, float* out, int num_samples, float dry_gain, float wet_gain);
+    /** outN = inN + feedback * jmap( pingpong, wetN, wetM ) (outN may alias wetN) */
+    using FeedbackFunc = void (*)(const float* in0, const float* in1, const float* wet0, const float* wet1, float* out0, float* out1, int num_samples, float feedback, float pingpong);
+    /**
+     * out = ring[ write_index + i - delay ], linearly interpolated, with
+     * delay = base_delay + depth * lfo[i] clamped to [1; ring_size - 2]
+     * samples (out may alias lfo). The write positions must not wrap within
+     * the block, the read positions may.
+     */
+    using ModulatedReadFunc = void (*)(const float* ring, int ring_size, int write_index, const float* lfo, float* out, int num_samples, float base_delay, float depth);
+    /** peak = max( peak, |in| ), sum_of_squares += in^2, i.e. accumulating over several calls. */
+    using LevelFunc = void (*)(const float* in, int num_samples, float& peak, float& sum_of_squares);
+
+    InstructionSet instruction_set;
+    const char* name;
+
+    MidSidePanFunc mid_side_pan;
+    GainFunc gain;
+    GainRampFunc gain_ramp;
+    MixFunc mix;
+    FeedbackFunc feedback;
+    ModulatedReadFunc modulated_read;
+    LevelFunc level;
+
+    /** The plain C++ reference implementation. */
+    static const DspKernels& scalar();
+
+    /** Returns the kernels for the given instruction set, or nullptr if they are not compiled in or not supported by this CPU. */
+    static const DspKernels* find(InstructionSet instruction_set);
+
+    /**
+     * Returns the widest kernels supported by this CPU. The choice is made
+     * once and can be overridden for testing via the environment variable
+     * DRECHO_SIMD ("scalar", "sse2", "avx2" or "avx512").
+     */
+    static const DspKernels& select();
+};
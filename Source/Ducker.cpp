@@ -0,0 +1,87 @@
+/*
+  ==============================================================================
+
+    Ducker.cpp
+    Created: 20 Oct 2026 2:41:08am
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#include "Ducker.h"
+
+const int Ducker::SUB_BLOCK_SIZE;
+
+// Below this, log10 isn't worth calling: the key is silent as far as any threshold is concerned.
+static const float _SILENCE = 1.0e-6f;
+
+Ducker::Ducker()
+    : _sample_rate( 44100.0f )
+    , _envelope( 0.0f )
+    , _gain( 1.0f )
+{
+}
+
+void Ducker::prepare(float sample_rate)
+{
+    _sample_rate = sample_rate;
+    reset();
+}
+
+void Ducker::reset()
+{
+    _envelope = 0.0f;
+    _gain = 1.0f;
+}
+
+void Ducker::process(const DspKernels& kernels, const float* const* key, int num_key_channels,
+                     float* const* wet, int num_wet_channels, int num_samples, const Settings& settings)
+{
+    // Switched off: nothing to do once the gain is back at unity.
+    if ( settings.amount_db <= 0.0f && _gain == 1.0f )
+    {
+        _envelope = 0.0f;
+        return;
+    }
+
+    const float samples_per_ms = _sample_rate * 0.001f;
+    const float attack_coefficient = 1.0f - ::expf( -static_cast<float>( SUB_BLOCK_SIZE ) / std::max( 1.0f, settings.attack_ms * samples_per_ms ) );
+    const float release_coefficient = 1.0f - ::expf( -static_cast<float>( SUB_BLOCK_SIZE ) / std::max( 1.0f, settings.release_ms * samples_per_ms ) );
+
+    for ( int offset = 0; offset < num_samples; offset += SUB_BLOCK_SIZE )
+    {
+        const int n = std::min( SUB_BLOCK_SIZE, num_samples - offset );
+
+        float peak = 0.0f;
+        float sum_of_squares = 0.0f;
+        for ( int c = 0; c < num_key_channels; ++c )
+            kernels.level( key[c] + offset, n, peak, sum_of_squares );
+
+        // A partial sub-block moves the follower by its share of a whole one.
+        const float share = static_cast<float>( n ) / static_cast<float>( SUB_BLOCK_SIZE );
+        _envelope += share * (peak > _envelope ? attack_coefficient : release_coefficient) * (peak - _envelope);
+
+        float reduction_db = 0.0f;
+        if ( settings.amount_db > 0.0f && _envelope > _SILENCE )
+            reduction_db = dspLimit( 0.0f, settings.amount_db, 20.0f * ::log10f( _envelope ) - settings.threshold_db );
+        const float gain = ::powf( 10.0f, -0.05f * reduction_db );
+
+        const float increment = (gain - _gain) / static_cast<float>( n );
+        for ( int c = 0; c < num_wet_channels; ++c )
+        {
+            if ( increment == 0.0f )
+            {
+                if ( gain != 1.0f )
+                    kernels.gain( wet[c] + offset, wet[c] + offset, n, gain );
+            }
+            else
+                kernels.gain_ramp( wet[c] + offset, wet[c] + offset, n, _gain, increment );
+        }
+        _gain = gain;
+    }
+}
+
+float Ducker::getGainReductionDb() const
+{
+    return -20.0f * ::log10f( std::max( _gain, _SILENCE ) );
+}
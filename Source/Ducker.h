@@ -0,0 +1,58 @@
+/*
+  ==============================================================================
+
+    Ducker.h
+    Created: 20 Oct 2026 2:41:08am
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "DspCommon.h"
+#include "DspKernels.h"
+
+/**
+ * Ducks the wet signal while a key signal (the sidechain, or else the dry
+ * input) is loud. Works in sub-blocks of SUB_BLOCK_SIZE samples: the key's
+ * peak per sub-block comes from the vectorized level kernel, the peak
+ * follower and the gain computer run once per sub-block, and the gain is
+ * ramped across the sub-block by the vectorized gain ramp kernel. The
+ * reduction grows dB for dB with the key above the threshold, up to the
+ * amount.
+ */
+class Ducker
+{
+
+public:
+    static const int SUB_BLOCK_SIZE = 16;
+
+    struct Settings
+    {
+        float amount_db;        // maximum reduction, 0 is off
+        float threshold_db;
+        float attack_ms;
+        float release_ms;
+    };
+
+public:
+    Ducker();
+
+public:
+    void prepare(float sample_rate);
+    void reset();
+
+    /** Ducks the wet channels in place, following the key channels. */
+    void process(const DspKernels& kernels, const float* const* key, int num_key_channels,
+                 float* const* wet, int num_wet_channels, int num_samples, const Settings& settings);
+
+    /** The current reduction in dB (0 or positive). */
+    float getGainReductionDb() const;
+
+private:
+    float _sample_rate;
+    float _envelope;    // linear peak
+    float _gain;        // linear, applied at the end of the last sub-block
+
+};
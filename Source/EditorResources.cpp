@@ -0,0 +1,26 @@
+/*
+  ==============================================================================
+
+    EditorResources.cpp
+    Created: 20 Oct 2026 12:41:19am
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#include "EditorResources.h"
+
+EditorResources::EditorResources()
+    : title_font( "Arial", 24.0f, juce::Font::bold )
+    , section_font( "Arial", 18.0f, juce::Font::bold )
+    , logo_font( "Arial", 32.0f, juce::Font::bold )
+    , italic_font( "Arial", 14.0f, juce::Font::italic )
+    , bold_font( "Arial", 14.0f, juce::Font::bold )
+    , label_font( 15.0f, juce::Font::bold ) // juce::Label's default, in bold
+    , meter_font( 11.0f, juce::Font::bold )
+    , w_Dr( logo_font.getStringWidth( "Dr" ) )
+    , w_dot( logo_font.getStringWidth( "." ) )
+    , w_Echo( logo_font.getStringWidth( "Echo" ) )
+    , w_author_name( bold_font.getStringWidth( JucePlugin_Manufacturer ) )
+{
+}
@@ -0,0 +1,50 @@
+/*
+  ==============================================================================
+
+    EditorResources.h
+    Created: 20 Oct 2026 12:41:19am
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "DefaultLookAndFeel.h"
+#include "MetaLookAndFeel.h"
+
+/**
+ * Everything the editors need that doesn't depend on the instance: the
+ * look-and-feels, the fonts and the measured widths of the fixed texts.
+ * Editors hold it through a juce::SharedResourcePointer, so it's built when
+ * the first editor opens and shared by all editors of the process until the
+ * last one closes. Message thread only.
+ */
+class EditorResources
+{
+
+public:
+    EditorResources();
+
+public:
+    DefaultLookAndFeel default_look_and_feel;
+    MetaLookAndFeel meta_look_and_feel;
+
+    juce::Font title_font;
+    juce::Font section_font;
+    juce::Font logo_font;
+    juce::Font italic_font;
+    juce::Font bold_font;
+    juce::Font label_font;
+    juce::Font meter_font;
+
+    // The logo's parts, measured in logo_font, and the author's name in bold_font.
+    int w_Dr;
+    int w_dot;
+    int w_Echo;
+    int w_author_name;
+
+    JUCE_DECLARE_NON_COPYABLE( EditorResources )
+};
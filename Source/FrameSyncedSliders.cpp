@@ -0,0 +1,198 @@
+/*
+  ==============================================================================
+
+    FrameSyncedSliders.cpp
+    Created: 20 Oct 2026 12:58:04am
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#include "FrameSyncedSliders.h"
+
+// While hidden and holding the changes back, the timer still has to notice when the owner shows again.
+static const double _MIN_POLL_HZ = 4.0;
+
+FrameSyncedSliders::FrameSyncedSliders(juce::Component& owner)
+    : _owner( owner )
+#if JUCE_MAJOR_VERSION >= 7
+    , _vblank_attachment( &owner, [this] { _on_frame(); } )
+#endif
+{
+#if JUCE_MAJOR_VERSION < 7
+    _timer_for_visible = true;
+    startTimerHz( static_cast<int>( _visible_hz ) );
+#endif
+}
+
+FrameSyncedSliders::~FrameSyncedSliders()
+{
+    // After this, no parameter calls back anymore (the parameters' listener list is locked).
+    for ( int i = 0; i < _num_bindings; ++i )
+    {
+        _bindings[i].parameter->removeListener( this );
+        if ( _bindings[i].in_gesture )
+            _bindings[i].parameter->endChangeGesture();
+    }
+}
+
+//==============================================================================
+void FrameSyncedSliders::attach(juce::RangedAudioParameter& parameter, juce::Slider& slider)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+    jassert( _num_bindings < MAX_SLIDERS );
+
+    const int binding_index = _num_bindings;
+
+    // The same range, texts and default as a SliderAttachment sets up.
+    const juce::NormalisableRange<float> range = parameter.getNormalisableRange();
+    juce::NormalisableRange<double> slider_range( range.start, range.end,
+        [range](double start, double end, double proportion) mutable {
+            range.start = static_cast<float>( start );
+            range.end = static_cast<float>( end );
+            return static_cast<double>( range.convertFrom0to1( static_cast<float>( proportion ) ) );
+        },
+        [range](double start, double end, double value) mutable {
+            range.start = static_cast<float>( start );
+            range.end = static_cast<float>( end );
+            return static_cast<double>( range.convertTo0to1( static_cast<float>( value ) ) );
+        },
+        [range](double start, double end, double value) mutable {
+            range.start = static_cast<float>( start );
+            range.end = static_cast<float>( end );
+            return static_cast<double>( range.snapToLegalValue( static_cast<float>( value ) ) );
+        } );
+    slider_range.interval = range.interval;
+    slider_range.skew = range.skew;
+    slider_range.symmetricSkew = range.symmetricSkew;
+
+    _ignore_slider_changes = true;
+    slider.setNormalisableRange( slider_range );
+    slider.valueFromTextFunction = [&parameter](const juce::String& text) { return static_cast<double>( parameter.convertFrom0to1( parameter.getValueForText( text ) ) ); };
+    slider.textFromValueFunction = [&parameter](double value) { return parameter.getText( parameter.convertTo0to1( static_cast<float>( value ) ), 0 ); };
+    slider.setDoubleClickReturnValue( true, parameter.convertFrom0to1( parameter.getDefaultValue() ) );
+    slider.setValue( parameter.convertFrom0to1( parameter.getValue() ), juce::NotificationType::dontSendNotification );
+    slider.updateText();
+    _ignore_slider_changes = false;
+
+    slider.onValueChange = [this, binding_index] { _on_slider_value_change( binding_index ); };
+    slider.onDragStart = [this, binding_index] {
+        _Binding& binding = _bindings[binding_index];
+        binding.in_gesture = true;
+        binding.parameter->beginChangeGesture();
+    };
+    slider.onDragEnd = [this, binding_index] {
+        _Binding& binding = _bindings[binding_index];
+        binding.in_gesture = false;
+        binding.parameter->endChangeGesture();
+    };
+
+    _bindings[binding_index] = { &parameter, &slider, false };
+    _num_bindings = binding_index + 1;
+
+    parameter.addListener( this );
+}
+
+void FrameSyncedSliders::setUpdateRates(double visible_hz, double hidden_hz)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    _visible_hz = juce::jmax( 0.0, visible_hz );
+    _hidden_hz = juce::jmax( 0.0, hidden_hz );
+
+#if JUCE_MAJOR_VERSION < 7
+    // Picked up again with the right rate on the next tick.
+    _timer_for_visible = ! _owner.isShowing();
+#endif
+}
+
+//==============================================================================
+void FrameSyncedSliders::parameterValueChanged(int parameter_index, float)
+{
+    // Any thread, including the audio thread: only marks the binding.
+    for ( int i = 0; i < _num_bindings; ++i )
+    {
+        if ( _bindings[i].parameter->getParameterIndex() == parameter_index )
+        {
+            _changed.fetch_or( 1u << i, std::memory_order_release );
+            return;
+        }
+    }
+}
+
+void FrameSyncedSliders::parameterGestureChanged(int, bool)
+{
+}
+
+#if JUCE_MAJOR_VERSION < 7
+void FrameSyncedSliders::timerCallback()
+{
+    const bool visible = _owner.isShowing();
+    if ( visible != _timer_for_visible )
+    {
+        _timer_for_visible = visible;
+        const double hz = visible ? _visible_hz : juce::jmax( _hidden_hz, _MIN_POLL_HZ );
+        startTimerHz( juce::jmax( 1, static_cast<int>( hz ) ) );
+    }
+
+    _on_frame();
+}
+#endif
+
+void FrameSyncedSliders::_on_frame()
+{
+    if ( _changed.load( std::memory_order_relaxed ) == 0 )
+        return;
+
+    const double hz = _owner.isShowing() ? _visible_hz : _hidden_hz;
+    if ( hz <= 0.0 )
+        return;
+
+    // A little slack, so that a frame that comes slightly early isn't skipped.
+    const double now_ms = juce::Time::getMillisecondCounterHiRes();
+    if ( now_ms - _last_update_ms < 1000.0 / hz - 2.0 )
+        return;
+    _last_update_ms = now_ms;
+
+    _apply_changes();
+}
+
+void FrameSyncedSliders::_apply_changes()
+{
+    juce::uint32 changed = _changed.exchange( 0, std::memory_order_acquire );
+
+    _ignore_slider_changes = true;
+    for ( int i = 0; changed != 0; ++i, changed >>= 1 )
+    {
+        if ( ( changed & 1 ) == 0 )
+            continue;
+
+        // Slider::setValue ignores unchanged values, so only actual changes repaint.
+        const _Binding& binding = _bindings[i];
+        binding.slider->setValue( binding.parameter->convertFrom0to1( binding.parameter->getValue() ), juce::NotificationType::dontSendNotification );
+    }
+    _ignore_slider_changes = false;
+}
+
+void FrameSyncedSliders::_on_slider_value_change(int binding_index)
+{
+    if ( _ignore_slider_changes )
+        return;
+
+    _Binding& binding = _bindings[binding_index];
+    const float value = binding.parameter->convertTo0to1( static_cast<float>( binding.slider->getValue() ) );
+    if ( value == binding.parameter->getValue() )
+        return;
+
+    // Changes outside of a drag (text entry, double click, mouse wheel) are gestures of their own.
+    if ( binding.in_gesture )
+    {
+        binding.parameter->setValueNotifyingHost( value );
+    }
+    else
+    {
+        binding.parameter->beginChangeGesture();
+        binding.parameter->setValueNotifyingHost( value );
+        binding.parameter->endChangeGesture();
+    }
+}
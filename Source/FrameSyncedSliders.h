@@ -0,0 +1,94 @@
+/*
+  ==============================================================================
+
+    FrameSyncedSliders.h
+    Created: 20 Oct 2026 12:58:04am
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <atomic>
+
+/**
+ * Binds sliders to parameters like SliderAttachments do, but without one
+ * async update (and repaint) per parameter change: the parameter listeners
+ * just mark the changed parameters in a lock-free bit set, from whatever
+ * thread the change comes, and once per display frame the marked sliders
+ * are updated on the message thread. Dense automation therefore repaints
+ * each knob at most once per frame, and untouched knobs not at all.
+ *
+ * The frame clock is a juce::VBlankAttachment where JUCE has one (7 and up),
+ * otherwise a timer at the visible rate. While the owner isn't showing (e.g.
+ * the window is minimised or the host has hidden it) the changes are applied
+ * at the lower hidden rate, or held back until it shows again.
+ */
+class FrameSyncedSliders
+    : private juce::AudioProcessorParameter::Listener
+#if JUCE_MAJOR_VERSION < 7
+    , private juce::Timer
+#endif
+{
+
+public:
+    static const int MAX_SLIDERS = 32;
+
+public:
+    /** The owner is the component whose visibility decides the update rate; it must outlive this. */
+    explicit FrameSyncedSliders(juce::Component& owner);
+    ~FrameSyncedSliders() override;
+
+public:
+    /** Binds the slider to the parameter (range, texts, default and gestures) and sets its current value. Both must outlive this. */
+    void attach(juce::RangedAudioParameter& parameter, juce::Slider& slider);
+
+    /** Maximum updates per second while the owner is showing, and while it isn't; 0 holds the changes back. */
+    void setUpdateRates(double visible_hz, double hidden_hz);
+
+private:
+    void parameterValueChanged(int parameter_index, float new_value) override;
+    void parameterGestureChanged(int parameter_index, bool gesture_is_starting) override;
+
+#if JUCE_MAJOR_VERSION < 7
+    void timerCallback() override;
+#endif
+
+    void _on_frame();
+    void _apply_changes();
+    void _on_slider_value_change(int binding_index);
+
+private:
+    struct _Binding
+    {
+        juce::RangedAudioParameter* parameter;
+        juce::Slider* slider;
+        bool in_gesture;
+    };
+
+    juce::Component& _owner;
+
+    _Binding _bindings[MAX_SLIDERS];
+    int _num_bindings = 0;
+
+    // Bit i is set when the parameter of binding i has changed since the last applied frame.
+    std::atomic<juce::uint32> _changed { 0 };
+
+    // Set while the sliders are updated from the parameters, so that this doesn't echo back.
+    bool _ignore_slider_changes = false;
+
+    double _visible_hz = 60.0;
+    double _hidden_hz = 4.0;
+    double _last_update_ms = 0.0;
+
+#if JUCE_MAJOR_VERSION >= 7
+    juce::VBlankAttachment _vblank_attachment;
+#else
+    bool _timer_for_visible = false;
+#endif
+
+    JUCE_DECLARE_NON_COPYABLE( FrameSyncedSliders )
+};
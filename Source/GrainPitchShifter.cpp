@@ -0,0 +1,112 @@
+/*
+  ==============================================================================
+
+    GrainPitchShifter.cpp
+    Created: 19 Oct 2026 1:27:53pm
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#include "GrainPitchShifter.h"
+
+constexpr float GrainPitchShifter::GRAIN_SECONDS;
+
+GrainPitchShifter::GrainPitchShifter()
+    : _grain_size( 0.0f )
+    , _phase( 0.0 )
+{
+    // Make sure the shared window table is built here rather than in the audio thread.
+    _get_window_table();
+}
+
+void GrainPitchShifter::prepare(float sample_rate, int max_block_size)
+{
+    _grain_size = sample_rate * GRAIN_SECONDS;
+
+    const size_t size = static_cast<size_t>( std::max( 1, max_block_size ) );
+    for ( int k = 0; k < NUM_GRAINS; ++k )
+    {
+        _grain_phases[k].resize( size );
+        _grain_windows[k].resize( size );
+    }
+    _grain_samples.resize( size );
+
+    reset();
+}
+
+void GrainPitchShifter::reset()
+{
+    _phase = 0.0;
+}
+
+void GrainPitchShifter::seek(float pitch_ratio, double num_samples)
+{
+    const double phase_increment = (1.0 - pitch_ratio) / _grain_size;
+    _phase = phase_increment * num_samples;
+    _phase -= ::floor( _phase );
+}
+
+void GrainPitchShifter::advance(float pitch_ratio, int num_samples)
+{
+    assert( num_samples <= static_cast<int>( _grain_samples.size() ) );
+
+    // The read position has to move at pitch_ratio samples per sample, so
+    // the grain offset changes by (1 - pitch_ratio) samples per sample.
+    const double phase_increment = (1.0 - pitch_ratio) / _grain_size;
+    const float* window_table = _get_window_table();
+
+    for ( int k = 0; k < NUM_GRAINS; ++k )
+    {
+        float* phases = _grain_phases[k].data();
+        float* windows = _grain_windows[k].data();
+
+        double phase = _phase + static_cast<double>( k ) / NUM_GRAINS;
+        for ( int i = 0; i < num_samples; ++i )
+        {
+            phase -= ::floor( phase );
+            phases[i] = static_cast<float>( phase );
+
+            const float position = phases[i] * static_cast<float>( WINDOW_TABLE_SIZE );
+            const int index = std::min( static_cast<int>( position ), WINDOW_TABLE_SIZE - 1 );
+            const float frac = position - static_cast<float>( index );
+            windows[i] = window_table[ index ] + frac * (window_table[ index + 1 ] - window_table[ index ]);
+
+            phase += phase_increment;
+        }
+    }
+
+    _phase += phase_increment * num_samples;
+    _phase -= ::floor( _phase );
+}
+
+void GrainPitchShifter::read(const DspKernels& kernels, const float* ring, int ring_size, int write_index, float base_delay, float* out, int num_samples)
+{
+    // The grains never read closer than the base delay, and the engine sizes
+    // its ring buffers so that they don't reach beyond them either.
+    assert( base_delay + _grain_size <= static_cast<float>( ring_size - 2 ) );
+
+    float* samples = _grain_samples.data();
+
+    std::fill( out, out + num_samples, 0.0f );
+    for ( int k = 0; k < NUM_GRAINS; ++k )
+    {
+        const float* windows = _grain_windows[k].data();
+        kernels.modulated_read( ring, ring_size, write_index, _grain_phases[k].data(), samples, num_samples, base_delay, _grain_size );
+        for ( int i = 0; i < num_samples; ++i )
+            out[i] += windows[i] * samples[i];
+    }
+}
+
+const float* GrainPitchShifter::_get_window_table()
+{
+    // Hann windows half a period apart sum up to unity.
+    static const std::vector<float> table = []() {
+        std::vector<float> t( WINDOW_TABLE_SIZE + 1 );
+        for ( int i = 0; i <= WINDOW_TABLE_SIZE; ++i )
+            t[i] = 0.5f - 0.5f * ::cosf( static_cast<float>( DSP_TWO_PI ) * static_cast<float>( i ) / static_cast<float>( WINDOW_TABLE_SIZE ) );
+        return t;
+    }();
+
+    return table.data();
+}
@@ -0,0 +1,60 @@
+/*
+  ==============================================================================
+
+    GrainPitchShifter.h
+    Created: 19 Oct 2026 1:27:53pm
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "DspCommon.h"
+
+#include "DspKernels.h"
+
+/**
+ * A granular pitch shifter that reads directly from the echo's ring
+ * buffers: two Hann-windowed grains, half a grain apart, slide along the
+ * delay line at a rate that depends on the pitch ratio. The grain phases
+ * and windows are computed once per block and shared by all channels.
+ */
+class GrainPitchShifter
+{
+
+public:
+    static const int NUM_GRAINS = 2;
+    static const int WINDOW_TABLE_SIZE = 1024;
+
+    /** How far behind the base delay the grains read; the ring buffer has to hold that much more. */
+    static constexpr float GRAIN_SECONDS = 0.06f;
+
+public:
+    GrainPitchShifter();
+
+public:
+    void prepare(float sample_rate, int max_block_size);
+    void reset();
+
+    /** Moves the grains to where they are the given number of samples after a reset(), at a constant pitch ratio. */
+    void seek(float pitch_ratio, double num_samples);
+
+    /** Computes the grain phases and windows of the next block. */
+    void advance(float pitch_ratio, int num_samples);
+
+    /** Reads the pitch-shifted signal of one ring buffer behind the given base delay, which must leave room for a grain. */
+    void read(const DspKernels& kernels, const float* ring, int ring_size, int write_index, float base_delay, float* out, int num_samples);
+
+private:
+    float _grain_size;
+    double _phase;
+
+    std::vector<float> _grain_phases[NUM_GRAINS];
+    std::vector<float> _grain_windows[NUM_GRAINS];
+    std::vector<float> _grain_samples;
+
+private:
+    static const float* _get_window_table();
+
+};
@@ -0,0 +1,108 @@
+/*
+  ==============================================================================
+
+    LevelMeterComponent.cpp
+    Created: 20 Oct 2026 1:24:51am
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#include "LevelMeterComponent.h"
+
+static const float _MIN_DB = -60.0f;
+static const float _MAX_DB = 6.0f;
+
+static const float _PEAK_FALL_DB_PER_SECOND = 20.0f;
+static const double _HOLD_SECONDS = 1.5;
+static const double _RMS_SECONDS = 0.3;
+
+static const int _CAPTION_HEIGHT = 12;
+
+LevelMeterComponent::LevelMeterComponent(const juce::String& caption, const juce::Font& font, juce::Colour background, juce::Colour foreground)
+    : _caption( caption )
+    , _font( font )
+    , _background( background )
+    , _foreground( foreground )
+    , _peak_db( _MIN_DB )
+    , _hold_db( _MIN_DB )
+    , _hold_remaining( 0.0 )
+    , _mean_square( 0.0f )
+    , _painted_peak( -1 )
+    , _painted_hold( -1 )
+    , _painted_rms( -1 )
+{
+    setOpaque( false );
+}
+
+void LevelMeterComponent::update(const LevelMeters::Reading& reading, double elapsed_seconds)
+{
+    const float reading_db = juce::Decibels::gainToDecibels( reading.peak, _MIN_DB );
+
+    _peak_db = juce::jmax( reading_db, _peak_db - _PEAK_FALL_DB_PER_SECOND * static_cast<float>( elapsed_seconds ) );
+
+    if ( reading_db >= _hold_db )
+    {
+        _hold_db = reading_db;
+        _hold_remaining = _HOLD_SECONDS;
+    }
+    else if ( (_hold_remaining -= elapsed_seconds) <= 0.0 )
+    {
+        _hold_db = _peak_db;
+        _hold_remaining = 0.0;
+    }
+
+    // Without new blocks (e.g. the host stopped processing), the RMS decays towards silence.
+    const float coefficient = static_cast<float>( 1.0 - std::exp( -elapsed_seconds / _RMS_SECONDS ) );
+    _mean_square += coefficient * ((reading.num_samples > 0 ? reading.mean_square : 0.0f) - _mean_square);
+
+    const float width = static_cast<float>( getWidth() );
+    const int peak = juce::roundToInt( width * _get_proportion( _peak_db ) );
+    const int hold = juce::roundToInt( width * _get_proportion( _hold_db ) );
+    const int rms = juce::roundToInt( width * _get_proportion( juce::Decibels::gainToDecibels( std::sqrt( _mean_square ), _MIN_DB ) ) );
+    if ( peak != _painted_peak || hold != _painted_hold || rms != _painted_rms )
+    {
+        _painted_peak = peak;
+        _painted_hold = hold;
+        _painted_rms = rms;
+        repaint( 0, _CAPTION_HEIGHT, getWidth(), getHeight() - _CAPTION_HEIGHT );
+    }
+}
+
+void LevelMeterComponent::paint(juce::Graphics& g)
+{
+    const int w = getWidth();
+    const int h = getHeight() - _CAPTION_HEIGHT;
+    const int y = _CAPTION_HEIGHT;
+
+    g.setColour( _foreground.withMultipliedAlpha( 0.5f ) );
+    g.setFont( _font );
+    g.drawText( _caption, 0, 0, w, _CAPTION_HEIGHT, juce::Justification::centredLeft, false );
+
+    g.setColour( _background );
+    g.fillRect( 0, y, w, h );
+
+    g.setColour( _foreground.withMultipliedAlpha( 0.35f ) );
+    g.fillRect( 0, y, juce::jmax( 0, _painted_peak ), h );
+    g.setColour( _foreground.withMultipliedAlpha( 0.8f ) );
+    g.fillRect( 0, y + h / 4, juce::jmax( 0, _painted_rms ), h - h / 2 );
+
+    // Anything above 0 dBFS shows in red, including the hold marker.
+    const int zero_db = juce::roundToInt( static_cast<float>( w ) * _get_proportion( 0.0f ) );
+    g.setColour( juce::Colours::red.withAlpha( 0.8f ) );
+    if ( _painted_peak > zero_db )
+        g.fillRect( zero_db, y, _painted_peak - zero_db, h );
+    if ( _painted_hold > 0 )
+    {
+        g.setColour( _painted_hold > zero_db ? juce::Colours::red : _foreground );
+        g.fillRect( juce::jmin( _painted_hold, w - 2 ), y, 2, h );
+    }
+
+    g.setColour( _foreground.withMultipliedAlpha( 0.5f ) );
+    g.fillRect( zero_db, y, 1, h );
+}
+
+float LevelMeterComponent::_get_proportion(float decibels) const
+{
+    return juce::jlimit( 0.0f, 1.0f, (decibels - _MIN_DB) / (_MAX_DB - _MIN_DB) );
+}
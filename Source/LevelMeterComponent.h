@@ -0,0 +1,57 @@
+/*
+  ==============================================================================
+
+    LevelMeterComponent.h
+    Created: 20 Oct 2026 1:24:51am
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "LevelMeters.h"
+
+/**
+ * A horizontal peak/RMS meter with its caption. The ballistics live here,
+ * on the message thread: the peak jumps up, holds for a moment and then
+ * falls back at a fixed rate, and the RMS is averaged over a few hundred
+ * milliseconds. It only repaints when what it shows has visibly changed.
+ */
+class LevelMeterComponent
+    : public juce::Component
+{
+
+public:
+    /** The caption font is shared, so it must outlive this. */
+    LevelMeterComponent(const juce::String& caption, const juce::Font& font, juce::Colour background, juce::Colour foreground);
+
+public:
+    /** Feeds the reading taken after the given time, and repaints if needed. */
+    void update(const LevelMeters::Reading& reading, double elapsed_seconds);
+
+    void paint(juce::Graphics& g) override;
+
+private:
+    float _get_proportion(float decibels) const;
+
+private:
+    juce::String _caption;
+    const juce::Font& _font;
+    juce::Colour _background;
+    juce::Colour _foreground;
+
+    float _peak_db;
+    float _hold_db;
+    double _hold_remaining;
+    float _mean_square;
+
+    // What was painted last, in pixels.
+    int _painted_peak;
+    int _painted_hold;
+    int _painted_rms;
+
+    JUCE_DECLARE_NON_COPYABLE( LevelMeterComponent )
+};
@@ -0,0 +1,85 @@
+/*
+  ==============================================================================
+
+    LevelMeters.cpp
+    Created: 20 Oct 2026 1:24:51am
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#include "LevelMeters.h"
+
+#include <cstring>
+
+static_assert( ATOMIC_INT_LOCK_FREE == 2 && ATOMIC_LLONG_LOCK_FREE == 2, "The meters must not lock in the audio thread." );
+
+// Without a reader (no editor open), the accumulation restarts rather than overflowing.
+static const juce::uint32 _MAX_COUNT = 1u << 24;
+
+static juce::uint64 _pack(float sum, juce::uint32 count)
+{
+    juce::uint32 bits;
+    std::memcpy( &bits, &sum, sizeof( bits ) );
+    return (static_cast<juce::uint64>( bits ) << 32) | count;
+}
+
+static void _unpack(juce::uint64 packed, float& sum, juce::uint32& count)
+{
+    const juce::uint32 bits = static_cast<juce::uint32>( packed >> 32 );
+    std::memcpy( &sum, &bits, sizeof( sum ) );
+    count = static_cast<juce::uint32>( packed );
+}
+
+LevelMeters::LevelMeters()
+{
+    for ( _Accumulator& accumulator : _accumulators )
+    {
+        accumulator.peak.store( 0.0f );
+        accumulator.sum_and_count.store( 0 );
+    }
+}
+
+void LevelMeters::publish(Meter meter, const DrEchoEngine::Level& level)
+{
+    if ( level.num_samples <= 0 )
+        return;
+
+    _Accumulator& accumulator = _accumulators[ static_cast<int>( meter ) ];
+
+    float peak = accumulator.peak.load( std::memory_order_relaxed );
+    while ( level.peak > peak && !accumulator.peak.compare_exchange_weak( peak, level.peak, std::memory_order_relaxed ) )
+    {
+    }
+
+    juce::uint64 packed = accumulator.sum_and_count.load( std::memory_order_relaxed );
+    for ( ;; )
+    {
+        float sum;
+        juce::uint32 count;
+        _unpack( packed, sum, count );
+        if ( count >= _MAX_COUNT )
+        {
+            sum = 0.0f;
+            count = 0;
+        }
+        const juce::uint64 updated = _pack( sum + level.sum_of_squares, count + static_cast<juce::uint32>( level.num_samples ) );
+        if ( accumulator.sum_and_count.compare_exchange_weak( packed, updated, std::memory_order_relaxed ) )
+            break;
+    }
+}
+
+LevelMeters::Reading LevelMeters::take(Meter meter)
+{
+    _Accumulator& accumulator = _accumulators[ static_cast<int>( meter ) ];
+
+    float sum;
+    juce::uint32 count;
+    _unpack( accumulator.sum_and_count.exchange( 0, std::memory_order_relaxed ), sum, count );
+
+    Reading reading;
+    reading.peak = accumulator.peak.exchange( 0.0f, std::memory_order_relaxed );
+    reading.mean_square = count > 0 ? sum / static_cast<float>( count ) : 0.0f;
+    reading.num_samples = static_cast<int>( count );
+    return reading;
+}
@@ -0,0 +1,68 @@
+/*
+  ==============================================================================
+
+    LevelMeters.h
+    Created: 20 Oct 2026 1:24:51am
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <atomic>
+
+#include "DrEchoEngine.h"
+
+/**
+ * Hands the block levels from the audio thread to the editor. The audio
+ * thread accumulates each block's peak and sum of squares into atomics; the
+ * editor takes (and clears) what has accumulated since it last looked, so
+ * no block is missed however seldom it looks. Both sides are lock-free; the
+ * audio thread does one compare-exchange per value and block. Ballistics are
+ * left to the editor (see LevelMeterComponent).
+ */
+class LevelMeters
+{
+
+public:
+    enum class Meter
+    {
+        Input,      // before gain and pan
+        Wet,        // the scaled wet output
+        Feedback,   // what is fed back into the delay line
+    };
+
+    static const int NUM_METERS = 3;
+
+    /** What has accumulated since the last take. */
+    struct Reading
+    {
+        float peak;
+        float mean_square;
+        int num_samples;    // 0 if nothing was published in between
+    };
+
+public:
+    LevelMeters();
+
+public:
+    /** Audio thread: adds the levels of one block (or part of it). */
+    void publish(Meter meter, const DrEchoEngine::Level& level);
+
+    /** Single reader, typically the editor's timer: returns and clears what has accumulated. */
+    Reading take(Meter meter);
+
+private:
+    struct _Accumulator
+    {
+        std::atomic<float> peak;
+        std::atomic<juce::uint64> sum_and_count;    // float sum of squares in the upper, sample count in the lower half
+    };
+
+    _Accumulator _accumulators[NUM_METERS];
+
+    JUCE_DECLARE_NON_COPYABLE( LevelMeters )
+};
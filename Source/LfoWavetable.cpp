@@ -0,0 +1,92 @@
+/*
+  ==============================================================================
+
+    LfoWavetable.cpp
+    Created: 19 Oct 2026 10:41:17am
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#include "LfoWavetable.h"
+
+// The same sequence as juce::Random::nextFloat(), so that the random shape
+// stays what it was when the tables were still built with JUCE.
+static float _next_random_float(int64_t& seed)
+{
+    seed = static_cast<int64_t>( ((static_cast<uint64_t>( seed ) * 0x5deece66dULL) + 11) & 0xffffffffffffULL );
+    const uint32_t value = static_cast<uint32_t>( static_cast<int>( seed >> 16 ) );
+    return std::min( static_cast<float>( value ) / 4294967296.0f, 1.0f - 1.1920929e-7f );
+}
+
+LfoWavetable::LfoWavetable(Shape shape)
+    : _num_cycles( shape == Shape::Random ? RANDOM_STEPS : 1 )
+    , _table( TABLE_SIZE + 1 )
+{
+    switch ( shape )
+    {
+    case Shape::Sine:
+        for ( int i = 0; i < TABLE_SIZE; ++i )
+            _table[i] = ::sinf( static_cast<float>( DSP_TWO_PI ) * static_cast<float>( i ) / static_cast<float>( TABLE_SIZE ) );
+        break;
+
+    case Shape::Triangle:
+        for ( int i = 0; i < TABLE_SIZE; ++i )
+        {
+            const float x = static_cast<float>( i ) / static_cast<float>( TABLE_SIZE ); // [0; 1)
+            _table[i] = x < 0.25f ? 4.0f * x : x < 0.75f ? 2.0f - 4.0f * x : 4.0f * x - 4.0f;
+        }
+        break;
+
+    case Shape::Random:
+    {
+        // A fixed seed, so that renders are reproducible.
+        int64_t seed = 0x0ec40ec4;
+        float steps[RANDOM_STEPS];
+        for ( int k = 0; k < RANDOM_STEPS; ++k )
+            steps[k] = _next_random_float( seed ) * 2.0f - 1.0f;
+
+        const int step_size = TABLE_SIZE / RANDOM_STEPS;
+        for ( int i = 0; i < TABLE_SIZE; ++i )
+        {
+            const int k = i / step_size;
+            const float x = static_cast<float>( i % step_size ) / static_cast<float>( step_size );
+            const float a = steps[ k ];
+            const float b = steps[ (k + 1) % RANDOM_STEPS ];
+            _table[i] = a + (0.5f - 0.5f * ::cosf( static_cast<float>( DSP_PI ) * x )) * (b - a); // cosine interpolation
+        }
+        break;
+    }
+    }
+
+    _table[ TABLE_SIZE ] = _table[ 0 ];
+}
+
+const LfoWavetable& LfoWavetable::get(Shape shape)
+{
+    static const LfoWavetable tables[] = {
+        LfoWavetable( Shape::Sine ),
+        LfoWavetable( Shape::Triangle ),
+        LfoWavetable( Shape::Random ),
+    };
+
+    return tables[ static_cast<int>( shape ) ];
+}
+
+void LfoWavetable::render(double phase, double phase_increment, float* out, int num_samples) const
+{
+    const float* table = _table.data();
+
+    phase -= ::floor( phase );
+    for ( int i = 0; i < num_samples; ++i )
+    {
+        const float position = static_cast<float>( phase ) * static_cast<float>( TABLE_SIZE );
+        const int index = std::min( static_cast<int>( position ), TABLE_SIZE - 1 );
+        const float frac = position - static_cast<float>( index );
+        out[i] = table[ index ] + frac * (table[ index + 1 ] - table[ index ]);
+
+        phase += phase_increment;
+        if ( phase >= 1.0 )
+            phase -= 1.0;
+    }
+}
@@ -0,0 +1,55 @@
+/*
+  ==============================================================================
+
+    LfoWavetable.h
+    Created: 19 Oct 2026 10:41:17am
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "DspCommon.h"
+
+/**
+ * Precomputed single-period LFO waveforms, shared by all processor
+ * instances. The random shape stores several smoothly interpolated random
+ * steps per table period, so that it doesn't audibly repeat.
+ */
+class LfoWavetable
+{
+
+public:
+    enum class Shape
+    {
+        Sine,
+        Triangle,
+        Random,
+    };
+
+    static const int TABLE_SIZE = 2048;
+    static const int RANDOM_STEPS = 32;
+
+private:
+    explicit LfoWavetable(Shape shape);
+
+private:
+    int _num_cycles;
+    std::vector<float> _table; // TABLE_SIZE + 1 guard point
+
+public:
+    /** Returns the shared table of the given shape. The first call builds all of them, so don't let that be the audio thread. */
+    static const LfoWavetable& get(Shape shape);
+
+public:
+    /** The number of LFO cycles stored in one table period. */
+    int getNumCycles() const { return _num_cycles; }
+
+    /**
+     * Renders a block of values in [-1; +1], starting at the given phase and
+     * advancing by the given increment per sample (both in table periods).
+     */
+    void render(double phase, double phase_increment, float* out, int num_samples) const;
+
+};
@@ -25,4 +25,8 @@ MetaLookAndFeel::MetaLookAndFeel()
     setColour( juce::Slider::textBoxBackgroundColourId, juce::Colours::transparentBlack );
     //setColour( juce::Slider::textBoxHighlightColourId, juce::Colours::red );
     setColour( juce::Slider::textBoxOutlineColourId, juce::Colours::transparentBlack );
+
+    setColour( juce::ToggleButton::textColourId, juce::Colour( 0xff878787 ) );
+    setColour( juce::ToggleButton::tickColourId, juce::Colour( 0xffd7d7d7 ) );
+    setColour( juce::ToggleButton::tickDisabledColourId, juce::Colour( 0xff878787 ) );
 }
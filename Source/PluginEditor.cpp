@@ -12,31 +12,156 @@
 #include "MyLogger.h"
 
 //==============================================================================
-DrEchoAudioProcessorEditor::DrEchoAudioProcessorEditor (DrEchoAudioProcessor& p)
-    : AudioProcessorEditor (&p), audioProcessor (p)
+static const int W = 560;
+static const int H = 720;
+
+static const int sw = 80;
+static const int sh = 100;
+
+static const int cw = W / 4;
+static const int ch = H / 6;
+
+static const int ox = (cw - sw) / 2;
+static const int oy = (ch - sh) / 2 + ch / 2;
+
+static const int msw = 64;
+static const int msh = 84;
+static const int mcw = cw / 2;
+static const int mox = (mcw - msw) / 2;
+static const int moy = oy + ch * 2 + 16;
+
+// The sections below the modulation follow it a row apart.
+static const int soy = moy + ch;
+
+// The tempo sync controls flank the delay knob: the division on its left,
+// sync and the unsynced time on its right.
+static const int tlx = cw + 8;
+static const int trx = cw * 3 - 8 - msw;
+static const int tsh = msh - 8;
+
+struct _SliderLayout
+{
+    const char* parameter_id;
+    const char* suffix; // UTF-8
+    int x, y, w, h;
+    bool meta;
+};
+
+static const _SliderLayout _slider_layouts[] =
 {
-    const int W = 560;
-    const int H = 360;
+    { "gain",       " dB",          ox + cw * 0,        oy + ch * 0,        sw,     sh,     true },
+    { "pan",        " \xc2\xb0",    ox + cw * 0,        oy + ch * 1,        sw,     sh,     true },
+
+    { "delay",      " / 16th",      ox + cw * 3/2-20,   oy + ch * 0-20,     sw+40,  sh+40,  false },
+
+    { "division",   "",             tlx,                oy + 8,             msw,    msh,    false },
+    { "sync",       "",             trx,                oy - 38,            msw,    tsh,    false },
+    { "delayms",    " ms",          trx,                oy - 38 + tsh,      msw,    tsh,    false },
+
+    { "pingpong",   " %",           ox + cw * 1,        oy + ch * 1,        sw,     sh,     false },
+    { "feedback",   " %",           ox + cw * 2,        oy + ch * 1,        sw,     sh,     false },
+
+    { "dry",        " %",           ox + cw * 3,        oy + ch * 0,        sw,     sh,     true },
+    { "wet",        " %",           ox + cw * 3,        oy + ch * 1,        sw,     sh,     true },
 
-    const int sw = 80;
-    const int sh = 100;
+    { "modrate",    " Hz",          mox + cw + mcw * 0, moy,                msw,    msh,    false },
+    { "moddepth",   " ms",          mox + cw + mcw * 1, moy,                msw,    msh,    false },
+    { "modshape",   "",             mox + cw + mcw * 2, moy,                msw,    msh,    false },
+    { "modphase",   " \xc2\xb0",    mox + cw + mcw * 3, moy,                msw,    msh,    false },
 
-    const int cw = W / 4;
-    const int ch = H / 3;
+    { "shimmer",    "",             mox + cw + mcw * 1, soy,                msw,    msh,    false },
+    { "shimmermix", " %",           mox + cw + mcw * 2, soy,                msw,    msh,    false },
 
-    const int ox = (cw - sw) / 2;
-    const int oy = (ch - sh) / 2 + ch / 2;
+    { "duckamount", " dB",          mox + cw + mcw * 0, soy + ch,           msw,    msh,    false },
+    { "duckthreshold"," dB",        mox + cw + mcw * 1, soy + ch,           msw,    msh,    false },
+    { "duckattack", " ms",          mox + cw + mcw * 2, soy + ch,           msw,    msh,    false },
+    { "duckrelease"," ms",          mox + cw + mcw * 3, soy + ch,           msw,    msh,    false },
+};
 
-    _add_slider( "gain",        { ox + cw * 0,      oy + ch * 0,      sw, sh }, " dB", true );
-    _add_slider( "pan",         { ox + cw * 0,      oy + ch * 1,      sw, sh }, L" \u00b0", true );
+static_assert( sizeof( _slider_layouts ) / sizeof( _slider_layouts[0] ) == 20, "NUM_SLIDERS must match the layout table" );
 
-    _add_slider( "delay",       { ox + cw * 3/2-20, oy + ch * 0-20,   sw+40, sh+40 }, " / 16th" );
+static const juce::Rectangle<int> _reduced_rate_bounds( cw * 3 + 12, moy, cw - 24, 24 );
 
-    _add_slider( "pingpong",    { ox + cw * 1,      oy + ch * 1,      sw, sh }, " %" );
-    _add_slider( "feedback",    { ox + cw * 2,      oy + ch * 1,      sw, sh }, " %" );
+static const juce::Rectangle<int> _input_meter_bounds( 8, 304, cw - 16, 28 );
+static const juce::Rectangle<int> _presets_bounds( 12, 344, cw - 24, 24 );
+static const juce::Rectangle<int> _preset_browser_bounds( cw, 0, cw * 2, H );
+static const juce::Rectangle<int> _parallel_bounds( cw * 3 + 12, moy + 26, cw - 24, 24 );
+static const juce::Rectangle<int> _wet_meter_bounds( cw * 3 + 8, 382, cw - 16, 28 );
+static const juce::Rectangle<int> _feedback_meter_bounds( cw * 3 + 8, 414, cw - 16, 28 );
 
-    _add_slider( "dry",         { ox + cw * 3,      oy + ch * 0,      sw, sh }, " %", true );
-    _add_slider( "wet",         { ox + cw * 3,      oy + ch * 1,      sw, sh }, " %", true );
+// Meter updates per second; the ballistics make more pointless.
+static const int _METER_UPDATE_HZ = 30;
+
+// Knob updates from parameter changes per second, while the editor is showing and while it isn't.
+static const double _VISIBLE_UPDATE_HZ = 60.0;
+static const double _HIDDEN_UPDATE_HZ = 4.0;
+
+//==============================================================================
+DrEchoAudioProcessorEditor::DrEchoAudioProcessorEditor (DrEchoAudioProcessor& p)
+    : AudioProcessorEditor (&p), audioProcessor (p)
+    , _input_meter( "INPUT", _resources->meter_font, juce::Colour( 0x3f000000 ), juce::Colours::white )
+    , _wet_meter( "WET", _resources->meter_font, juce::Colour( 0x3f000000 ), juce::Colours::white )
+    , _feedback_meter( "FEEDBACK", _resources->meter_font, juce::Colour( 0x3f000000 ), juce::Colours::white )
+    , _last_meter_update_ms( juce::Time::getMillisecondCounterHiRes() )
+    , _frame_synced_sliders( *this )
+{
+    for ( int i = 0; i < NUM_SLIDERS; ++i )
+    {
+        const _SliderLayout& layout = _slider_layouts[i];
+        juce::Slider& slider = _sliders[i];
+        juce::Label& label = _labels[i];
+        juce::LookAndFeel& look_and_feel = layout.meta ? static_cast<juce::LookAndFeel&>( _resources->meta_look_and_feel ) : _resources->default_look_and_feel;
+
+        slider.setName( layout.parameter_id );
+        slider.setLookAndFeel( &look_and_feel );
+        slider.setSliderStyle( juce::Slider::SliderStyle::RotaryHorizontalVerticalDrag );
+        slider.setTextBoxStyle( juce::Slider::TextEntryBoxPosition::TextBoxBelow, false, layout.w, slider.getTextBoxHeight() );
+        slider.setTextValueSuffix( juce::String::fromUTF8( layout.suffix ) );
+        _frame_synced_sliders.attach( *audioProcessor.apvts.getParameter( layout.parameter_id ), slider );
+        addAndMakeVisible( slider );
+
+        label.setLookAndFeel( &look_and_feel );
+        label.setText( audioProcessor.apvts.getParameter( layout.parameter_id )->getLabel(), juce::NotificationType::dontSendNotification );
+        label.setJustificationType( juce::Justification::centred );
+        label.setFont( _resources->label_font );
+        addAndMakeVisible( label );
+    }
+
+    _frame_synced_sliders.setUpdateRates( _VISIBLE_UPDATE_HZ, _HIDDEN_UPDATE_HZ );
+
+    _reduced_rate_button.setName( "reducedrate" );
+    _reduced_rate_button.setButtonText( "REDUCED RATE" );
+    _reduced_rate_button.setLookAndFeel( &_resources->meta_look_and_feel );
+    _reduced_rate_button.setToggleState( audioProcessor.isReducedRateEnabled(), juce::NotificationType::dontSendNotification );
+    _reduced_rate_button.onClick = [this] { audioProcessor.setReducedRateEnabled( _reduced_rate_button.getToggleState() ); };
+    addAndMakeVisible( _reduced_rate_button );
+
+    _parallel_button.setName( "parallel" );
+    _parallel_button.setButtonText( "PARALLEL" );
+    _parallel_button.setLookAndFeel( &_resources->meta_look_and_feel );
+    _parallel_button.setToggleState( audioProcessor.isParallelProcessingEnabled(), juce::NotificationType::dontSendNotification );
+    _parallel_button.onClick = [this] { audioProcessor.setParallelProcessingEnabled( _parallel_button.getToggleState() ); };
+    addAndMakeVisible( _parallel_button );
+
+    _presets_button.setName( "presets" );
+    _presets_button.setButtonText( "PRESETS" );
+    _presets_button.setLookAndFeel( &_resources->meta_look_and_feel );
+    _presets_button.onClick = [this]
+    {
+        if ( _presets_button.getToggleState() )
+        {
+            _preset_browser.reset( new PresetBrowser( audioProcessor, *_resources ) );
+            _preset_browser->setBounds( _preset_browser_bounds );
+            addAndMakeVisible( *_preset_browser );
+        }
+        else
+            _preset_browser.reset();
+    };
+    addAndMakeVisible( _presets_button );
+
+    for ( LevelMeterComponent* meter : { &_input_meter, &_wet_meter, &_feedback_meter } )
+        addAndMakeVisible( meter );
+    startTimerHz( _METER_UPDATE_HZ );
 
     // Make sure that before the constructor has finished, you've set the
     // editor's size to whatever you need it to be.
@@ -44,24 +169,32 @@ DrEchoAudioProcessorEditor::DrEchoAudioProcessorEditor (DrEchoAudioProcessor& p)
 
     constrainer.setSizeLimits( W, H, W, H );
     this->setConstrainer( &constrainer );
+
+    // With tracing compiled in, the trace can be exported by a key press.
+    setWantsKeyboardFocus( TraceEvents::isEnabled() );
 }
 
 DrEchoAudioProcessorEditor::~DrEchoAudioProcessorEditor()
 {
-    // The attachments have to be deleted before their respective components.
-    // And the components have to be deleted or at least detached from the
-    // look-and-feel object before deleting it. So let's do this explicitly.
-    for ( auto& p : _component_infos )
+    stopTimer();
+
+    // The shared look-and-feels outlive this editor; detach from them anyway,
+    // so that none of them is ever deleted while still in use.
+    for ( int i = 0; i < NUM_SLIDERS; ++i )
     {
-        ComponentInfo& ci = p.second;
-        ci.component_attachment_wrapper_ptr.reset();
-        ci.component_ptr.reset();
+        _sliders[i].setLookAndFeel( nullptr );
+        _labels[i].setLookAndFeel( nullptr );
     }
+    _reduced_rate_button.setLookAndFeel( nullptr );
+    _parallel_button.setLookAndFeel( nullptr );
+    _presets_button.setLookAndFeel( nullptr );
 }
 
 //==============================================================================
 void DrEchoAudioProcessorEditor::paint (juce::Graphics& g)
 {
+    DRECHO_TRACE_SCOPE( "paint" );
+
     // (Our component is opaque, so we must completely fill the background with a solid colour)
     /*g.fillAll (getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));
 
@@ -69,10 +202,7 @@ void DrEchoAudioProcessorEditor::paint (juce::Graphics& g)
     g.setFont (15.0f);
     g.drawFittedText ("Hello World!", getLocalBounds(), juce::Justification::centred, 1);*/
 
-    const int W = getWidth();
-    const int H = getHeight();
-
-    const int cw = W / 4;
+    const EditorResources& resources = *_resources;
 
     g.setFillType( juce::FillType( juce::Colour( 0xff131b30 ) ) );
     g.fillRect( 0 * cw, 0, 1 * cw, H );
@@ -81,7 +211,7 @@ void DrEchoAudioProcessorEditor::paint (juce::Graphics& g)
     g.setFillType( juce::FillType( juce::Colour( 0xff131b30 ) ) );
     g.fillRect( 3 * cw, 0, 3 * cw, H );
 
-    g.setFont( juce::Font( "Arial", 24.0f, juce::Font::bold ) );
+    g.setFont( resources.title_font );
     g.setColour( juce::Colour( 0x7fffffff ) );
     g.drawFittedText( "INPUT MIX", 8, 4, cw - 16, 28, juce::Justification::centredTop, 1 );
     g.setColour( juce::Colour( 0x7f000000 ) );
@@ -89,19 +219,19 @@ void DrEchoAudioProcessorEditor::paint (juce::Graphics& g)
     g.setColour( juce::Colour( 0x7fffffff ) );
     g.drawFittedText( "OUTPUT MIX", cw * 3 + 8, 4, cw - 16, 28, juce::Justification::centredTop, 1 );
 
-    const juce::Font logo_font = juce::Font( "Arial", 32.0f, juce::Font::bold );
-    const juce::Font italic_font = juce::Font( "Arial", 14.0f, juce::Font::italic );
-    const juce::Font bold_font = juce::Font( "Arial", 14.0f, juce::Font::bold );
+    g.setFont( resources.section_font );
+    g.setColour( juce::Colour( 0x7f000000 ) );
+    g.drawFittedText( "MODULATION", cw + 8, ch * 2 + ch / 2 - 4, cw * 2 - 16, 22, juce::Justification::centredTop, 1 );
+    g.drawFittedText( "SHIMMER", cw + 8, ch * 3 + ch / 2 - 4, cw * 2 - 16, 22, juce::Justification::centredTop, 1 );
+    g.drawFittedText( "DUCKING", cw + 8, ch * 4 + ch / 2 - 4, cw * 2 - 16, 22, juce::Justification::centredTop, 1 );
 
     const juce::StringRef logo_Dr( "Dr" );
     const juce::StringRef logo_dot( "." );
     const juce::StringRef logo_Echo( "Echo" );
-    static const int w_Dr = logo_font.getStringWidth( logo_Dr );
-    static const int w_dot = logo_font.getStringWidth( logo_dot );
-    static const int w_Echo = logo_font.getStringWidth( logo_Echo );
-    static const int w_Dr_Echo = w_Dr + w_dot / 2 + w_Echo;
+    const int w_Dr = resources.w_Dr;
+    const int w_dot = resources.w_dot;
 
-    g.setFont( logo_font );
+    g.setFont( resources.logo_font );
     g.setColour( juce::Colour( 0x7fffffff ) );
     g.drawSingleLineText( logo_Dr, 4, H - 6 );
     g.setColour( juce::Colour( 0x3fffffff ) );
@@ -111,102 +241,76 @@ void DrEchoAudioProcessorEditor::paint (juce::Graphics& g)
 
     const juce::StringRef author_name( JucePlugin_Manufacturer );
     const juce::StringRef version( JucePlugin_VersionString );
-    static const int w_author_name = bold_font.getStringWidth( author_name );
+    const int w_author_name = resources.w_author_name;
 
-    g.setFont( italic_font );
+    g.setFont( resources.italic_font );
     g.setColour( juce::Colour( 0x3fffffff ) );
     g.drawFittedText( "A plug-in by", W - w_author_name - 4, H - 12 - 12 - 4, w_author_name, 12, juce::Justification::bottomLeft, 1 );
-    g.setFont( bold_font );
+    g.setFont( resources.bold_font );
     g.setColour( juce::Colour( 0x7fffffff ) );
     g.drawFittedText( author_name, W - w_author_name - 4, H - 12 - 2, w_author_name, 12, juce::Justification::bottomRight, 1 );
 
-    g.setFont( italic_font );
+    g.setFont( resources.italic_font );
     g.setColour( juce::Colour( 0x3f000000 ) );
     g.drawFittedText( "Version", cw, H - 10 - 10 - 4, cw * 2, 10, juce::Justification::centredBottom, 1 );
-    g.setFont( bold_font );
+    g.setFont( resources.bold_font );
     g.setColour( juce::Colour( 0x7f000000 ) );
     g.drawFittedText( version, cw, H - 10 - 2, cw * 2, 10, juce::Justification::centredBottom, 1 );
 
-    /*for ( auto& p : _component_infos )
+    /*for ( const juce::Component* component : getChildren() )
     {
-        ComponentInfo& ci = p.second;
-        juce::Component& component = *ci.component_ptr;
         g.setColour( juce::Colours::red );
-        g.drawRect( ci.bounds, 2 );
-        for ( auto& p : component.getChildren() )
-        {
-            g.setColour( juce::Colours::pink );
-            g.drawRect( p->getBounds().translated( component.getX(), component.getY() ), 1 );
-        }
+        g.drawRect( component->getBounds(), 2 );
     }*/
 }
 
-void DrEchoAudioProcessorEditor::resized()
+bool DrEchoAudioProcessorEditor::keyPressed (const juce::KeyPress& key)
 {
-    // This is generally where you'll want to lay out the positions of any
-    // subcomponents in your editor..
-
-    for ( auto& p : _component_infos )
+    // Ctrl/Cmd+Shift+T writes the recorded trace events to the desktop.
+    if ( TraceEvents::isEnabled() && key == juce::KeyPress( 't', juce::ModifierKeys::commandModifier | juce::ModifierKeys::shiftModifier, 0 ) )
     {
-        ComponentInfo& ci = p.second;
-        juce::Component& component = *ci.component_ptr;
-        component.setBounds( ci.bounds );
+        const juce::File file = juce::File::getSpecialLocation( juce::File::userDesktopDirectory )
+            .getNonexistentChildFile( JucePlugin_Name + juce::String( "-trace" ), ".json" );
+        if ( TraceEvents::exportTo( file ) )
+            MyLogger::log( "Trace events written to " + file.getFullPathName() );
+        return true;
     }
+
+    return false;
 }
 
-juce::Label& DrEchoAudioProcessorEditor::_add_label(const juce::String& text, const juce::Rectangle<int>& bounds, bool meta)
+void DrEchoAudioProcessorEditor::resized()
 {
-    ComponentInfo& ci = _component_infos.emplace( text + " (" + juce::String(::rand()) + ")", ComponentInfo{
-        std::make_unique<juce::Label>(),
-        bounds,
-        nullptr,
-    } ).first->second;
-
-    juce::Label& label = *dynamic_cast<juce::Label*>( ci.component_ptr.get() );
-
-    label.setLookAndFeel( meta ? &_meta_look_and_feel : &_default_look_and_feel );
+    // This is generally where you'll want to lay out the positions of any
+    // subcomponents in your editor..
 
-    label.setText( text, juce::NotificationType::dontSendNotification );
-    label.setJustificationType( juce::Justification::centred );
-    
-    juce::Font font = label.getFont();
-    font.setBold( true );
-    label.setFont( font );
+    // The label takes the lower part of the slider's text box, which the
+    // look-and-feel moves up into the slider's bounds accordingly.
+    for ( int i = 0; i < NUM_SLIDERS; ++i )
+    {
+        const _SliderLayout& layout = _slider_layouts[i];
+        const int text_box_height = _sliders[i].getTextBoxHeight() * 2 / 3;
+        _sliders[i].setBounds( layout.x, layout.y, layout.w, layout.h - text_box_height );
+        _labels[i].setBounds( layout.x, layout.y + layout.h - text_box_height, layout.w, text_box_height );
+    }
 
-    addAndMakeVisible( label );
+    _reduced_rate_button.setBounds( _reduced_rate_bounds );
+    _parallel_button.setBounds( _parallel_bounds );
+    _presets_button.setBounds( _presets_bounds );
 
-    return label;
+    _input_meter.setBounds( _input_meter_bounds );
+    _wet_meter.setBounds( _wet_meter_bounds );
+    _feedback_meter.setBounds( _feedback_meter_bounds );
 }
 
-juce::Slider& DrEchoAudioProcessorEditor::_add_slider(const juce::String& parameterID, const juce::Rectangle<int>& bounds, const juce::String& textValueSuffix, bool meta)
+void DrEchoAudioProcessorEditor::timerCallback()
 {
-    const juce::String name = parameterID;
-
-    ComponentInfo& ci = _component_infos.emplace( parameterID, ComponentInfo{
-        std::make_unique<juce::Slider>( name ),
-        bounds,
-        nullptr,
-    } ).first->second;
-
-    juce::Slider& slider = *dynamic_cast<juce::Slider*>( ci.component_ptr.get() );
-    ci.component_attachment_wrapper_ptr.reset( _create_component_attachment_wrapper<juce::AudioProcessorValueTreeState::SliderAttachment>( parameterID, slider ) );
-
-    slider.setLookAndFeel( meta ? &_meta_look_and_feel : &_default_look_and_feel );
-
-    int text_box_height = slider.getTextBoxHeight() * 2 / 3;
-
-    ci.bounds.setHeight( bounds.getHeight() - text_box_height );
-
-    slider.setSliderStyle( juce::Slider::SliderStyle::RotaryHorizontalVerticalDrag );
-
-    slider.setTextBoxStyle( juce::Slider::TextEntryBoxPosition::TextBoxBelow, false, bounds.getWidth(), slider.getTextBoxHeight() );
-    slider.setTextValueSuffix( textValueSuffix );
-
-    //slider.setPopupMenuEnabled( true );
-
-    addAndMakeVisible( slider );
-
-    _add_label( audioProcessor.apvts.getParameter( parameterID )->getLabel(), { bounds.getX(), bounds.getBottom() - text_box_height, bounds.getWidth(), text_box_height }, meta );
-
-    return slider;
+    const double now_ms = juce::Time::getMillisecondCounterHiRes();
+    const double elapsed_seconds = (now_ms - _last_meter_update_ms) * 0.001;
+    _last_meter_update_ms = now_ms;
+
+    LevelMeters& level_meters = audioProcessor.getLevelMeters();
+    _input_meter.update( level_meters.take( LevelMeters::Meter::Input ), elapsed_seconds );
+    _wet_meter.update( level_meters.take( LevelMeters::Meter::Wet ), elapsed_seconds );
+    _feedback_meter.update( level_meters.take( LevelMeters::Meter::Feedback ), elapsed_seconds );
 }
@@ -11,14 +11,16 @@
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
 
-#include "ComponentAttachmentWrapper.h"
-#include "DefaultLookAndFeel.h"
-#include "MetaLookAndFeel.h"
+#include "EditorResources.h"
+#include "FrameSyncedSliders.h"
+#include "LevelMeterComponent.h"
+#include "PresetBrowser.h"
 
 //==============================================================================
 /**
 */
 class DrEchoAudioProcessorEditor  : public juce::AudioProcessorEditor
+                                   , private juce::Timer
 {
 public:
     DrEchoAudioProcessorEditor (DrEchoAudioProcessor&);
@@ -27,6 +29,7 @@ public:
     //==============================================================================
     void paint (juce::Graphics&) override;
     void resized() override;
+    bool keyPressed (const juce::KeyPress&) override;
 
 private:
     // This reference is provided as a quick way for your editor to
@@ -34,29 +37,33 @@ private:
     DrEchoAudioProcessor& audioProcessor;
 
 private:
-    struct ComponentInfo
-    {
-        std::unique_ptr<juce::Component> component_ptr;
-        juce::Rectangle<int> bounds;
-        std::unique_ptr<AbstractComponentAttachmentWrapper> component_attachment_wrapper_ptr;
-    };
+    static const int NUM_SLIDERS = 20;
 
-    std::map<juce::String, ComponentInfo> _component_infos;
+    // Shared by all editors, and declared first so that it outlives the components using its look-and-feels.
+    juce::SharedResourcePointer<EditorResources> _resources;
 
-    juce::ComponentBoundsConstrainer constrainer;
+    // Laid out from a static table (see PluginEditor.cpp), each slider with its label below.
+    juce::Slider _sliders[NUM_SLIDERS];
+    juce::Label _labels[NUM_SLIDERS];
+    juce::ToggleButton _reduced_rate_button;
+    juce::ToggleButton _parallel_button;
+    juce::ToggleButton _presets_button;
+
+    // Over the delay section while the presets button is on; the library stays mapped only as long.
+    std::unique_ptr<PresetBrowser> _preset_browser;
+
+    LevelMeterComponent _input_meter;
+    LevelMeterComponent _wet_meter;
+    LevelMeterComponent _feedback_meter;
+    double _last_meter_update_ms;
 
-    DefaultLookAndFeel _default_look_and_feel;
-    MetaLookAndFeel _meta_look_and_feel;
+    // Declared after the components, so that it is destroyed before them.
+    FrameSyncedSliders _frame_synced_sliders;
+
+    juce::ComponentBoundsConstrainer constrainer;
 
 private:
-    juce::Label& _add_label(const juce::String& text, const juce::Rectangle<int>& bounds, bool meta = false);
-    juce::Slider& _add_slider(const juce::String& parameterID, const juce::Rectangle<int>& bounds, const juce::String& textValueSuffix, bool meta = false);
-
-    template <class TComponentAttachment, class TComponent>
-    AbstractComponentAttachmentWrapper* _create_component_attachment_wrapper(const juce::String& parameterID, TComponent& component)
-    {
-        return new ComponentAttachmentWrapper<TComponentAttachment>( std::make_unique<TComponentAttachment>( audioProcessor.apvts, parameterID, component ) );
-    }
+    void timerCallback() override;
 
 private:
     //==============================================================================
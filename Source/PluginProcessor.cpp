@@ -10,6 +10,7 @@
 #include "PluginEditor.h"
 
 #include "MyLogger.h"
+#include "RealtimeSafety.h"
 
 juce::AudioProcessorValueTreeState::ParameterLayout _create_parameter_layout()
 {
@@ -18,6 +19,13 @@ juce::AudioProcessorValueTreeState::ParameterLayout _create_parameter_layout()
     const float abs_gain_db = 24.0f;
     const juce::NormalisableRange<float> gain_range( -abs_gain_db, +abs_gain_db, 0.1f );
     const juce::NormalisableRange<float> delay_range( 0.05f, 16.0f, 0.05f );
+    const juce::NormalisableRange<float> mod_rate_range( 0.05f, 10.0f, 0.01f, 0.5f );
+    const juce::NormalisableRange<float> mod_depth_range( 0.0f, 20.0f, 0.1f, 0.5f );
+    const juce::NormalisableRange<float> delay_ms_range( 1.0f, 1000.0f, 0.1f, 0.5f );
+    const juce::NormalisableRange<float> duck_amount_range( 0.0f, 40.0f, 0.1f );
+    const juce::NormalisableRange<float> duck_threshold_range( -60.0f, 0.0f, 0.1f );
+    const juce::NormalisableRange<float> duck_attack_range( 0.1f, 100.0f, 0.1f, 0.4f );
+    const juce::NormalisableRange<float> duck_release_range( 10.0f, 2000.0f, 1.0f, 0.4f );
 
     params.add( std::make_unique<juce::AudioParameterFloat>(    "gain",     "Gain",     gain_range,     0.0f,   "GAIN",
         juce::AudioProcessorParameter::Category::genericParameter,
@@ -34,6 +42,27 @@ juce::AudioProcessorValueTreeState::ParameterLayout _create_parameter_layout()
     params.add( std::make_unique<juce::AudioParameterInt>(      "dry",      "Dry",      0,      100,    100,    "DRY" ) );
     params.add( std::make_unique<juce::AudioParameterInt>(      "wet",      "Wet",      0,      100,    50,     "WET" ) );
 
+    params.add( std::make_unique<juce::AudioParameterFloat>(    "modrate",  "Mod Rate", mod_rate_range, 0.5f,   "RATE",
+        juce::AudioProcessorParameter::Category::genericParameter,
+        [](float value, int maximumStringLength) -> juce::String { return juce::String::formatted("%.2f", value); } ) );
+    params.add( std::make_unique<juce::AudioParameterFloat>(    "moddepth", "Mod Depth",mod_depth_range,0.0f,   "DEPTH",
+        juce::AudioProcessorParameter::Category::genericParameter,
+        [](float value, int maximumStringLength) -> juce::String { return juce::String::formatted("%.1f", value); } ) );
+    params.add( std::make_unique<juce::AudioParameterChoice>(   "modshape", "Mod Shape",juce::StringArray( "Sine", "Triangle", "Random" ), 0, "SHAPE" ) );
+    params.add( std::make_unique<juce::AudioParameterInt>(      "modphase", "Mod Phase",0,      180,    0,      "PHASE" ) );
+
+    params.add( std::make_unique<juce::AudioParameterChoice>(   "shimmer",  "Shimmer",  juce::StringArray( "Off", "-24 st", "-12 st", "+12 st", "+24 st" ), 0, "SHIMMER" ) );
+    params.add( std::make_unique<juce::AudioParameterInt>(      "shimmermix","Shimmer Mix",0,   100,    50,     "SHIMMER MIX" ) );
+
+    params.add( std::make_unique<juce::AudioParameterChoice>(   "division", "Division", juce::StringArray( "Straight", "Dotted", "Triplet" ), 0, "DIVISION" ) );
+    params.add( std::make_unique<juce::AudioParameterBool>(     "sync",     "Sync",     true,                                   "SYNC" ) );
+    params.add( std::make_unique<juce::AudioParameterFloat>(    "delayms",  "Delay (ms)",delay_ms_range,250.0f, "TIME (MS)" ) );
+
+    params.add( std::make_unique<juce::AudioParameterFloat>(    "duckamount","Duck Amount",duck_amount_range,0.0f,"DUCK" ) );
+    params.add( std::make_unique<juce::AudioParameterFloat>(    "duckthreshold","Duck Threshold",duck_threshold_range,-30.0f,"THRESHOLD" ) );
+    params.add( std::make_unique<juce::AudioParameterFloat>(    "duckattack","Duck Attack",duck_attack_range,5.0f,"ATTACK" ) );
+    params.add( std::make_unique<juce::AudioParameterFloat>(    "duckrelease","Duck Release",duck_release_range,250.0f,"RELEASE" ) );
+
     return params;
 }
 
@@ -44,17 +73,60 @@ DrEchoAudioProcessor::DrEchoAudioProcessor()
                      #if ! JucePlugin_IsMidiEffect
                       #if ! JucePlugin_IsSynth
                        .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
+                       .withInput  ("Sidechain", juce::AudioChannelSet::stereo(), false)
                       #endif
                        .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
+                       .withOutput ("Wet",    juce::AudioChannelSet::stereo(), false)
                      #endif
                        )
 #endif
     , apvts(*this, nullptr, "PARAMETERS", _create_parameter_layout())
+    , _sample_rate( 0.0f )
+    , _samples_per_block( 0 )
+    , _reduced_rate( false )
+    , _parallel( false )
+    , _pending_program_parameters( 0 )
+    , _telemetry_peak_wet( 0.0f )
+    , _preset_library_file( PresetLibrary::getDefaultFile() )
 {
+    // Looking the parameters up by name allocates, so it is done once here rather than in the audio thread.
+    _parameter_values.gain = apvts.getRawParameterValue( "gain" );
+    _parameter_values.pan = apvts.getRawParameterValue( "pan" );
+    _parameter_values.delay = apvts.getRawParameterValue( "delay" );
+    _parameter_values.pingpong = apvts.getRawParameterValue( "pingpong" );
+    _parameter_values.feedback = apvts.getRawParameterValue( "feedback" );
+    _parameter_values.dry = apvts.getRawParameterValue( "dry" );
+    _parameter_values.wet = apvts.getRawParameterValue( "wet" );
+    _parameter_values.modrate = apvts.getRawParameterValue( "modrate" );
+    _parameter_values.moddepth = apvts.getRawParameterValue( "moddepth" );
+    _parameter_values.modshape = apvts.getRawParameterValue( "modshape" );
+    _parameter_values.modphase = apvts.getRawParameterValue( "modphase" );
+    _parameter_values.shimmer = apvts.getRawParameterValue( "shimmer" );
+    _parameter_values.shimmermix = apvts.getRawParameterValue( "shimmermix" );
+    _parameter_values.division = apvts.getRawParameterValue( "division" );
+    _parameter_values.sync = apvts.getRawParameterValue( "sync" );
+    _parameter_values.delayms = apvts.getRawParameterValue( "delayms" );
+    _parameter_values.duckamount = apvts.getRawParameterValue( "duckamount" );
+    _parameter_values.duckthreshold = apvts.getRawParameterValue( "duckthreshold" );
+    _parameter_values.duckattack = apvts.getRawParameterValue( "duckattack" );
+    _parameter_values.duckrelease = apvts.getRawParameterValue( "duckrelease" );
+
+    if ( wrapperType == wrapperType_Standalone )
+    {
+        const StandaloneSupport::Settings settings = StandaloneSupport::Settings::fromEnvironment();
+        if ( settings.isActive() )
+            _standalone_support.reset( new StandaloneSupport( settings ) );
+    }
+
+    startTimerHz( 10 );
 }
 
 DrEchoAudioProcessor::~DrEchoAudioProcessor()
 {
+    stopTimer();
+
+    if ( _standalone_support )
+        _standalone_support->printReport();
 }
 
 //==============================================================================
@@ -97,22 +169,37 @@ double DrEchoAudioProcessor::getTailLengthSeconds() const
 
 int DrEchoAudioProcessor::getNumPrograms()
 {
-    return 1;   // NB: some hosts don't cope very well if you tell them there are 0 programs,
-                // so this should be at least 1, even if you're not really implementing programs.
+    return ProgramBank::getNumPrograms();
 }
 
 int DrEchoAudioProcessor::getCurrentProgram()
 {
-    return 0;
+    return _program_bank.getCurrentProgram();
 }
 
 void DrEchoAudioProcessor::setCurrentProgram (int index)
 {
+    // The audio thread crossfades to the program's snapshot right away; the
+    // parameters follow so that the host and the editor show the new values,
+    // and take over again once the crossfade is done. Setting them notifies
+    // the host, which may lock or allocate, so when the host changes the
+    // program from the audio thread, that is left to timerCallback(), and
+    // the audio thread keeps to the snapshot until then.
+    _program_bank.select( index );
+    if ( juce::MessageManager::existsAndIsCurrentThread() )
+    {
+        _pending_program_parameters.store( 0 );
+        _set_parameters( ProgramBank::getProgram( index ).parameters );
+    }
+    else
+    {
+        _pending_program_parameters.store( 1 + _program_bank.getCurrentProgram() );
+    }
 }
 
 const juce::String DrEchoAudioProcessor::getProgramName (int index)
 {
-    return {};
+    return ProgramBank::getProgram( index ).name;
 }
 
 void DrEchoAudioProcessor::changeProgramName (int index, const juce::String& newName)
@@ -125,15 +212,95 @@ void DrEchoAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock
     // Use this method as the place to do any pre-playback
     // initialisation that you need..
 
+    DRECHO_TRACE_SCOPE( "prepareToPlay" );
+
     _sample_rate = static_cast<float>( sampleRate );
     _samples_per_block = samplesPerBlock;
 
-    const double MAX_SECONDS = 1.0;
+    _prepare_delay_network();
+
+    _quality_governor.prepare( sampleRate );
+
+    if ( _standalone_support )
+        _standalone_support->prepare( sampleRate );
+}
+
+void DrEchoAudioProcessor::_prepare_delay_network()
+{
+    const int num_channels = juce::jmax( 1, getMainBusNumInputChannels() );
+    _engines.prepare( _sample_rate, _samples_per_block, _reduced_rate, num_channels );
+    _sidechain_buffer.setSize( DrEchoEngine::MAX_CHANNELS, juce::jmax( 1, _samples_per_block ) );
+
+    // One group runs on the audio thread itself, the others on as many workers as there are spare cores.
+    const int num_spare_cores = juce::jmax( 0, juce::SystemStats::getNumCpus() - 1 );
+    const int num_workers = _parallel ? juce::jmin( _engines.getNumGroups() - 1, num_spare_cores ) : 0;
+    if ( num_workers <= 0 )
+        _worker_pool.reset();
+    else if ( !_worker_pool || _worker_pool->getNumWorkers() != num_workers )
+    {
+        _worker_pool.reset();
+        _worker_pool.reset( new RealtimeWorkerPool( num_workers ) );
+        MyLogger::log( juce::String::formatted( "Parallel processing: %d channel groups, %d workers", _engines.getNumGroups(), num_workers ) );
+    }
+
+    _telemetry_peak_wet = 0.0f;
+    _telemetry.publishConfiguration( _sample_rate, _engines.getBufferBytes() );
+}
+
+void DrEchoAudioProcessor::_set_parameters(const DrEchoEngine::Parameters& parameters)
+{
+    // In the order of _create_parameter_layout(), so that no lookup by name is needed.
+    const float values[] =
+    {
+        parameters.gain_db,
+        parameters.pan,
+        parameters.delay,
+        parameters.pingpong * 100.0f, // float to integer percentage
+        parameters.feedback * 100.0f, // float to integer percentage
+        parameters.dry * 100.0f, // float to integer percentage
+        parameters.wet * 100.0f, // float to integer percentage
+        parameters.mod_rate,
+        parameters.mod_depth,
+        static_cast<float>( parameters.mod_shape ), // shape to choice index
+        parameters.mod_phase,
+        static_cast<float>( DrEchoEngine::Parameters::getShimmerChoice( parameters.shimmer_semitones ) ), // semitones to choice index
+        parameters.shimmer_mix * 100.0f, // float to integer percentage
+        static_cast<float>( parameters.division ), // division to choice index
+        parameters.synced ? 1.0f : 0.0f,
+        parameters.delay_ms,
+        parameters.duck_amount_db,
+        parameters.duck_threshold_db,
+        parameters.duck_attack_ms,
+        parameters.duck_release_ms,
+    };
+
+    const juce::Array<juce::AudioProcessorParameter*>& processor_parameters = getParameters();
+    jassert( processor_parameters.size() == juce::numElementsInArray( values ) );
+    for ( int i = 0; i < juce::numElementsInArray( values ); ++i )
+    {
+        auto* parameter = static_cast<juce::RangedAudioParameter*>( processor_parameters[i] );
+        parameter->setValueNotifyingHost( parameter->convertTo0to1( values[i] ) );
+    }
+}
 
-    _buffer_index = 0;
-    _buffer_size = static_cast<size_t>( ::ceil( _sample_rate * MAX_SECONDS ) );
-    for ( int i = 0; i < 2; ++i )
-        _sample_buffers[i].resize( _buffer_size );
+void DrEchoAudioProcessor::loadPreset(const PresetLibrary& library, int index)
+{
+    // The library's columns are matched by parameter ID, since it may come from an older or newer version.
+    for ( juce::AudioProcessorParameter* processor_parameter : getParameters() )
+    {
+        auto* parameter = static_cast<juce::RangedAudioParameter*>( processor_parameter );
+        float value = parameter->getDefaultValue();
+        for ( int column = 0; column < library.getNumParameters(); ++column )
+        {
+            if ( library.getParameterId( column ) != parameter->paramID )
+                continue;
+            const float plain_value = library.getValue( index, column );
+            if ( !std::isnan( plain_value ) )
+                value = parameter->convertTo0to1( plain_value );
+            break;
+        }
+        parameter->setValueNotifyingHost( value );
+    }
 }
 
 void DrEchoAudioProcessor::releaseResources()
@@ -150,11 +317,12 @@ bool DrEchoAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) c
     return true;
   #else
     // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
+    // Besides mono and stereo, multichannel layouts of up to 16 channels are
+    // processed as independent stereo pairs (see ChannelGroupEngine).
     // Some plugin hosts, such as certain GarageBand versions, will only
     // load plugins that support stereo bus layouts.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    const int num_output_channels = layouts.getMainOutputChannelSet().size();
+    if (num_output_channels < 1 || num_output_channels > ChannelGroupEngine::MAX_CHANNELS)
         return false;
 
     // This checks if the input layout matches the output layout
@@ -163,6 +331,24 @@ bool DrEchoAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) c
         return false;
    #endif
 
+    // The optional wet output is either off or has the same layout as the main output.
+    if ( layouts.outputBuses.size() > 1 )
+    {
+        const juce::AudioChannelSet& wet_set = layouts.getChannelSet( false, 1 );
+        if ( !wet_set.isDisabled() && wet_set != layouts.getMainOutputChannelSet() )
+            return false;
+    }
+
+    // The optional sidechain is either off, mono or stereo.
+   #if ! JucePlugin_IsSynth
+    if ( layouts.inputBuses.size() > 1 )
+    {
+        const juce::AudioChannelSet& sidechain_set = layouts.getChannelSet( true, 1 );
+        if ( !sidechain_set.isDisabled() && sidechain_set != juce::AudioChannelSet::mono() && sidechain_set != juce::AudioChannelSet::stereo() )
+            return false;
+    }
+   #endif
+
     return true;
   #endif
 }
@@ -170,37 +356,65 @@ bool DrEchoAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) c
 
 void DrEchoAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
+    DRECHO_TRACE_SCOPE( "processBlock" );
     juce::ScopedNoDenormals noDenormals;
+    RealtimeSafety::ScopedAudioThread scoped_audio_thread;
+    const juce::int64 start_ticks = juce::Time::getHighResolutionTicks();
+
+    if ( _standalone_support )
+    {
+        _standalone_support->beginBlock( start_ticks, buffer.getNumSamples() );
+        if ( _standalone_support->isMeasuringLatency() )
+        {
+            _standalone_support->measureLatency( buffer, getMainBusNumInputChannels() );
+            _standalone_support->endBlock( start_ticks );
+            return;
+        }
+    }
+
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
-    jassert( totalNumInputChannels == totalNumOutputChannels );
-    jassert( totalNumInputChannels == 2 );
+    const int num_main_channels = getMainBusNumInputChannels();
 
+    jassert( num_main_channels <= ChannelGroupEngine::MAX_CHANNELS );
+
+    // Without a play head (or a tempo from it), a synced delay falls back to its time in milliseconds.
     juce::AudioPlayHead* play_head = getPlayHead();
     juce::AudioPlayHead::CurrentPositionInfo cpi;
-    if ( play_head )
-        play_head->getCurrentPosition( cpi );
-    else
-        cpi.bpm = 140.0; // Just some arbitrary but halfway meaningful value.
-    const float bpm = static_cast<float>( cpi.bpm );
-    const float bps = bpm * (1.0f/60.0f);
-
-    const float gain = juce::Decibels::decibelsToGain( static_cast<float>( *apvts.getRawParameterValue("gain") ) ); // float dB to float gain
-    const float pan = *apvts.getRawParameterValue("pan") / 45.0f; // integer [-45; +45] to float [-1; +1]
-
-    const float delay = *apvts.getRawParameterValue("delay") * (1.0f/16.0f) * 4.0f / bps; // float 1/64th to float seconds
-
-    const float pingpong = *apvts.getRawParameterValue("pingpong") * 0.01f; // integer percentage to float
-    const float feedback = *apvts.getRawParameterValue("feedback") * 0.01f; // integer percentage to float
-
-    const float dry = *apvts.getRawParameterValue("dry") * 0.01f; // integer percentage to float
-    const float wet = *apvts.getRawParameterValue("wet") * 0.01f; // integer percentage to float
-
-    const size_t num_delayed_samples = static_cast<size_t>( _sample_rate * delay );
-
-    const float cs0 = ::cosf( 0.25f * juce::float_Pi * (1.0f + pan) );
-    const float cs1 = ::cosf( 0.25f * juce::float_Pi * (1.0f - pan) );
+    if ( !play_head || !play_head->getCurrentPosition( cpi ) )
+        cpi.bpm = 0.0;
+
+    DrEchoEngine::Parameters parameters;
+    parameters.gain_db = *_parameter_values.gain;
+    parameters.pan = *_parameter_values.pan;
+    parameters.delay = *_parameter_values.delay;
+    parameters.pingpong = *_parameter_values.pingpong * 0.01f; // integer percentage to float
+    parameters.feedback = *_parameter_values.feedback * 0.01f; // integer percentage to float
+    parameters.dry = *_parameter_values.dry * 0.01f; // integer percentage to float
+    parameters.wet = *_parameter_values.wet * 0.01f; // integer percentage to float
+    parameters.mod_rate = *_parameter_values.modrate;
+    parameters.mod_depth = *_parameter_values.moddepth;
+    parameters.mod_shape = static_cast<LfoWavetable::Shape>( static_cast<int>( *_parameter_values.modshape ) ); // choice index to shape
+    parameters.mod_phase = *_parameter_values.modphase;
+    parameters.shimmer_semitones = DrEchoEngine::Parameters::getShimmerSemitones( static_cast<int>( *_parameter_values.shimmer ) ); // choice index to semitones
+    parameters.shimmer_mix = *_parameter_values.shimmermix * 0.01f; // integer percentage to float
+    parameters.division = static_cast<TempoSync::Division>( static_cast<int>( *_parameter_values.division ) ); // choice index to division
+    parameters.synced = *_parameter_values.sync >= 0.5f;
+    parameters.delay_ms = *_parameter_values.delayms;
+    parameters.duck_amount_db = *_parameter_values.duckamount;
+    parameters.duck_threshold_db = *_parameter_values.duckthreshold;
+    parameters.duck_attack_ms = *_parameter_values.duckattack;
+    parameters.duck_release_ms = *_parameter_values.duckrelease;
+
+    // Until the message thread has set the parameters of a program the host
+    // changed to from this thread, they still have the old values.
+    if ( const int pending = _pending_program_parameters.load( std::memory_order_relaxed ) )
+        parameters = ProgramBank::getProgram( pending - 1 ).parameters;
+
+    // Under CPU pressure, the shimmer is faded out and the modulation gets coarser.
+    const QualityGovernor::Tier tier = _quality_governor.getTier();
+    _engines.setOptionalStages( tier != QualityGovernor::Tier::Minimal, tier == QualityGovernor::Tier::Full );
 
     // In case we have more outputs than inputs, this code clears any output
     // channels that didn't contain input data, (because these aren't
@@ -211,62 +425,173 @@ void DrEchoAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce:
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
-    // This is the place where you'd normally do the guts of your plugin's
-    // audio processing...
-    // Make sure to reset the state if your inner loop is processing
-    // the samples and the outer loop is handling the channels.
-    // Alternatively, you can process the samples with the channels
-    // interleaved by keeping the same state.
-    struct SampleInfo
+    const int num_samples = buffer.getNumSamples();
+    const int num_channels = juce::jmin( num_main_channels, ChannelGroupEngine::MAX_CHANNELS );
+
+    // The sidechain input shares its channels in the buffer with the wet output,
+    // which the engine writes before it's done reading the key, so the key is
+    // copied aside first. Without a sidechain, the dry input is the key.
+    const juce::AudioProcessor::Bus* sidechain_bus = getBus( true, 1 );
+    const float* sidechain_channels[DrEchoEngine::MAX_CHANNELS] = {};
+    int first_sidechain_channel = 0;
+    int num_sidechain_channels = 0;
+    if ( sidechain_bus && sidechain_bus->isEnabled() )
     {
-        float dry_sample;
-        float input_sample;
-        float wet_sample;
-    } channel_sample_info[2];
-
-    for ( int block_index = 0; block_index < buffer.getNumSamples(); ++block_index )
+        first_sidechain_channel = sidechain_bus->getChannelIndexInProcessBlockBuffer( 0 );
+        num_sidechain_channels = juce::jmin( sidechain_bus->getNumberOfChannels(), _sidechain_buffer.getNumChannels() );
+        for ( int c = 0; c < num_sidechain_channels; ++c )
+            sidechain_channels[c] = _sidechain_buffer.getReadPointer( c );
+    }
+
+    // With the wet output enabled, the wet signal goes there and the main output
+    // keeps the dry signal, so that the two add up to the usual mix.
+    const juce::AudioProcessor::Bus* wet_bus = getBus( false, 1 );
+    float* const* wet_channels = nullptr;
+    if ( wet_bus && wet_bus->isEnabled() && wet_bus->getNumberOfChannels() == num_channels )
+        wet_channels = buffer.getArrayOfWritePointers() + wet_bus->getChannelIndexInProcessBlockBuffer( 0 );
+
+    // A program change crossfades from the parameters of the last block to the
+    // program's snapshot, in short parts, over 50 milliseconds.
+    if ( const ProgramBank::Program* program = _program_bank.takePending() )
+        _program_crossfade.start( _last_parameters, program->parameters, static_cast<int>( 0.05f * _sample_rate ) );
+
+    // A block longer than announced is processed in parts of the prepared
+    // size, which is what the key buffer holds, so that it is keyed the same.
+    const int max_part_size = _sidechain_buffer.getNumSamples();
+    float* const* channels = buffer.getArrayOfWritePointers();
+    float* part_channels[ChannelGroupEngine::MAX_CHANNELS];
+    float* part_wet_channels[ChannelGroupEngine::MAX_CHANNELS];
+    float wet_peak = 0.0f;
+    for ( int offset = 0; offset < num_samples; offset += max_part_size )
     {
-        const auto current_index = _buffer_index;
-        const auto delayed_index = (_buffer_index + _buffer_size - num_delayed_samples) % _buffer_size;
-        
-        for ( int channel = 0; channel < totalNumInputChannels; ++channel )
-        {
-            SampleInfo& si = channel_sample_info[ channel ];
-            si.dry_sample = buffer.getReadPointer( channel )[ block_index ];
-        } // for channel
-
-        SampleInfo& si0 = channel_sample_info[ 0 ];
-        SampleInfo& si1 = channel_sample_info[ 1 ];
-        if ( totalNumInputChannels == 2 )
+        const int n = juce::jmin( max_part_size, num_samples - offset );
+        for ( int c = 0; c < num_sidechain_channels; ++c )
+            _sidechain_buffer.copyFrom( c, 0, buffer, first_sidechain_channel + c, offset, n );
+        for ( int i = 0; i < num_channels; ++i )
         {
-            const float M = 0.5f * (si0.dry_sample + si1.dry_sample);
-            const float S = si0.dry_sample - si1.dry_sample;
-            si0.input_sample = cs0 * M + S;
-            si1.input_sample = cs1 * M - S;
+            part_channels[i] = channels[i] + offset;
+            part_wet_channels[i] = wet_channels ? wet_channels[i] + offset : nullptr;
         }
-        else
+
+        wet_peak = juce::jmax( wet_peak, _process_part( part_channels, num_channels, n, parameters, cpi.bpm, wet_channels ? part_wet_channels : nullptr,
+                                                        sidechain_channels, num_sidechain_channels ) );
+    }
+    _last_parameters = parameters;
+
+    const float load = _quality_governor.update( juce::Time::getHighResolutionTicks() - start_ticks, num_samples, !isNonRealtime() );
+
+    // The published peak falls back at about 20 dB per second.
+    const float peak_decay = ::powf( 0.1f, static_cast<float>( num_samples ) / _sample_rate );
+    _telemetry_peak_wet = juce::jmax( wet_peak, _telemetry_peak_wet * peak_decay );
+    _telemetry.publishBlock( load, _quality_governor.getNumOverruns(), static_cast<juce::uint32>( _engines.getEngine( 0 ).getDelayInSamples() ), _telemetry_peak_wet );
+
+    if ( _standalone_support )
+        _standalone_support->endBlock( start_ticks );
+}
+
+float DrEchoAudioProcessor::_process_part(float* const* channels, int num_channels, int num_samples, DrEchoEngine::Parameters& parameters, double bpm,
+                                          float* const* wet_channels, const float* const* sidechain_channels, int num_sidechain_channels)
+{
+    if ( !_program_crossfade.isActive() )
+    {
+        _engines.process( channels, num_channels, num_samples, parameters, bpm, wet_channels,
+                          sidechain_channels, num_sidechain_channels, _worker_pool.get() );
+        _publish_levels();
+        return _engines.getWetPeak();
+    }
+
+    const int PART_SIZE = 32;
+
+    float* part_channels[ChannelGroupEngine::MAX_CHANNELS];
+    float* part_wet_channels[ChannelGroupEngine::MAX_CHANNELS];
+    const float* part_sidechain_channels[DrEchoEngine::MAX_CHANNELS];
+    float wet_peak = 0.0f;
+    for ( int offset = 0; offset < num_samples; offset += PART_SIZE )
+    {
+        const int n = juce::jmin( PART_SIZE, num_samples - offset );
+        for ( int i = 0; i < num_channels; ++i )
         {
-            si0.input_sample = si0.dry_sample;
+            part_channels[i] = channels[i] + offset;
+            part_wet_channels[i] = wet_channels ? wet_channels[i] + offset : nullptr;
         }
+        for ( int i = 0; i < num_sidechain_channels; ++i )
+            part_sidechain_channels[i] = sidechain_channels[i] + offset;
+
+        parameters = _program_crossfade.isActive() ? _program_crossfade.advance( n ) : parameters;
+        _engines.process( part_channels, num_channels, n, parameters, bpm, wet_channels ? part_wet_channels : nullptr,
+                          part_sidechain_channels, num_sidechain_channels, _worker_pool.get() );
+        wet_peak = juce::jmax( wet_peak, _engines.getWetPeak() );
+        _publish_levels();
+    }
+    return wet_peak;
+}
 
-        for ( int channel = 0; channel < totalNumInputChannels; ++channel )
-        {
-            SampleInfo& si = channel_sample_info[ channel ];
-            si.input_sample *= gain;
-            si.wet_sample = _sample_buffers[ channel ][ delayed_index ];
-            buffer.getWritePointer( channel )[ block_index ] = dry * si.dry_sample + wet * si.wet_sample;
-        } // for channel
+void DrEchoAudioProcessor::timerCallback()
+{
+    // Should the audio thread select yet another program meanwhile, it stays pending for the next tick.
+    int pending = _pending_program_parameters.load();
+    if ( pending == 0 )
+        return;
+    _set_parameters( ProgramBank::getProgram( pending - 1 ).parameters );
+    _pending_program_parameters.compare_exchange_strong( pending, 0 );
+}
 
-        for ( int channel = 0; channel < totalNumInputChannels; ++channel )
-        {
-            const int other_channel = totalNumInputChannels - 1 - channel;
-            SampleInfo& si = channel_sample_info[ channel ];
-            SampleInfo& si2 = channel_sample_info[ other_channel ];
-            _sample_buffers[ channel ][ current_index ] = si.input_sample + feedback * juce::jmap( pingpong, si.wet_sample, si2.wet_sample );
-        } // for channel
+void DrEchoAudioProcessor::_publish_levels()
+{
+    // The meters accumulate, so each group just adds its share.
+    for ( int g = 0; g < _engines.getNumGroups(); ++g )
+    {
+        const DrEchoEngine& engine = _engines.getEngine( g );
+        _level_meters.publish( LevelMeters::Meter::Input, engine.getInputLevel() );
+        _level_meters.publish( LevelMeters::Meter::Wet, engine.getWetLevel() );
+        _level_meters.publish( LevelMeters::Meter::Feedback, engine.getFeedbackLevel() );
+    }
+}
+
+QualityGovernor::Tier DrEchoAudioProcessor::getQualityTier() const
+{
+    return _quality_governor.getTier();
+}
+
+float DrEchoAudioProcessor::getCpuLoad() const
+{
+    return _quality_governor.getLoad();
+}
+
+bool DrEchoAudioProcessor::isReducedRateEnabled() const
+{
+    return _reduced_rate;
+}
+
+void DrEchoAudioProcessor::setReducedRateEnabled(bool enabled)
+{
+    if ( enabled == _reduced_rate )
+        return;
+
+    // Reallocating the delay network mustn't race with the audio thread.
+    suspendProcessing( true );
+    _reduced_rate = enabled;
+    if ( _sample_rate > 0.0f )
+        _prepare_delay_network();
+    suspendProcessing( false );
+}
 
-        _buffer_index = (_buffer_index + 1) % _buffer_size;
-    } // for sample
+bool DrEchoAudioProcessor::isParallelProcessingEnabled() const
+{
+    return _parallel;
+}
+
+void DrEchoAudioProcessor::setParallelProcessingEnabled(bool enabled)
+{
+    if ( enabled == _parallel )
+        return;
+
+    // Starting or stopping the workers mustn't race with the audio thread.
+    suspendProcessing( true );
+    _parallel = enabled;
+    if ( _sample_rate > 0.0f )
+        _prepare_delay_network();
+    suspendProcessing( false );
 }
 
 //==============================================================================
@@ -288,6 +613,10 @@ void DrEchoAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
     // as intermediaries to make it easy to save and load complex data.
 
     std::unique_ptr<juce::XmlElement> root_element( new juce::XmlElement( "DrEcho" ) );
+    root_element->setAttribute( "reducedRate", _reduced_rate );
+    root_element->setAttribute( "parallel", _parallel );
+    root_element->setAttribute( "program", _program_bank.getCurrentProgram() );
+    root_element->setAttribute( "presetLibrary", _preset_library_file.getFullPathName() );
     juce::XmlElement* parameters_element = apvts.copyState().createXml().release();
     root_element->addChildElement( parameters_element );
     copyXmlToBinary( *root_element, destData );
@@ -298,9 +627,17 @@ void DrEchoAudioProcessor::setStateInformation (const void* data, int sizeInByte
     // You should use this method to restore your parameters from this memory block,
     // whose contents will have been created by the getStateInformation() call.
 
+    DRECHO_TRACE_SCOPE( "setStateInformation" );
+
     std::unique_ptr<juce::XmlElement> root_element( getXmlFromBinary( data, sizeInBytes ) );
     if ( !root_element )
         return;
+    setReducedRateEnabled( root_element->getBoolAttribute( "reducedRate", false ) );
+    setParallelProcessingEnabled( root_element->getBoolAttribute( "parallel", false ) );
+    _program_bank.restore( root_element->getIntAttribute( "program", 0 ) );
+    _pending_program_parameters.store( 0 ); // the state's parameters win
+    const juce::String preset_library_path = root_element->getStringAttribute( "presetLibrary" );
+    _preset_library_file = juce::File::isAbsolutePath( preset_library_path ) ? juce::File( preset_library_path ) : PresetLibrary::getDefaultFile();
     juce::XmlElement* parameters_element = root_element->getChildByName( apvts.state.getType() );
     if ( !parameters_element )
         return;
@@ -10,10 +10,22 @@
 
 #include <JuceHeader.h>
 
+#include "DrEchoEngine.h"
+#include "ProgramBank.h"
+#include "QualityGovernor.h"
+#include "RealtimeSafetyReporter.h"
+#include "ChannelGroupEngine.h"
+#include "LevelMeters.h"
+#include "PresetLibrary.h"
+#include "Telemetry.h"
+#include "TraceEvents.h"
+#include "StandaloneSupport.h"
+
 //==============================================================================
 /**
 */
 class DrEchoAudioProcessor  : public juce::AudioProcessor
+                            , private juce::Timer
 {
 public:
     //==============================================================================
@@ -53,16 +65,102 @@ public:
     void getStateInformation (juce::MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
 
+    //==============================================================================
+    /** Whether the wet/feedback path runs at a reduced internal rate at high sample rates. */
+    bool isReducedRateEnabled() const;
+    void setReducedRateEnabled(bool enabled);
+
+    /** Whether the channel groups of a multichannel layout are processed in parallel, on real-time worker threads. */
+    bool isParallelProcessingEnabled() const;
+    void setParallelProcessingEnabled(bool enabled);
+
+    /** The quality tier the CPU-budget governor currently runs at, and the smoothed load it is based on. */
+    QualityGovernor::Tier getQualityTier() const;
+    float getCpuLoad() const;
+
+    /** The input, wet and feedback levels, published by the audio thread for the editor's meters. */
+    LevelMeters& getLevelMeters() { return _level_meters; }
+
+    /** The preset library the editor browses; saved with the state. */
+    const juce::File& getPresetLibraryFile() const { return _preset_library_file; }
+    void setPresetLibraryFile(const juce::File& file) { _preset_library_file = file; }
+
+    /** Sets all parameters to the given preset of a library, and those it has no value for to their defaults. */
+    void loadPreset(const PresetLibrary& library, int index);
+
 public:
     juce::AudioProcessorValueTreeState apvts;
 
 private:
+    struct ParameterValues
+    {
+        std::atomic<float>* gain;
+        std::atomic<float>* pan;
+        std::atomic<float>* delay;
+        std::atomic<float>* pingpong;
+        std::atomic<float>* feedback;
+        std::atomic<float>* dry;
+        std::atomic<float>* wet;
+        std::atomic<float>* modrate;
+        std::atomic<float>* moddepth;
+        std::atomic<float>* modshape;
+        std::atomic<float>* modphase;
+        std::atomic<float>* shimmer;
+        std::atomic<float>* shimmermix;
+        std::atomic<float>* division;
+        std::atomic<float>* sync;
+        std::atomic<float>* delayms;
+        std::atomic<float>* duckamount;
+        std::atomic<float>* duckthreshold;
+        std::atomic<float>* duckattack;
+        std::atomic<float>* duckrelease;
+    };
+
+private:
+    ParameterValues _parameter_values;
+
     float _sample_rate;
     int _samples_per_block;
 
-    size_t _buffer_index;
-    size_t _buffer_size;
-    std::vector<float> _sample_buffers[2];
+    bool _reduced_rate;
+    ChannelGroupEngine _engines;
+
+    bool _parallel;
+    std::unique_ptr<RealtimeWorkerPool> _worker_pool;
+
+    juce::AudioBuffer<float> _sidechain_buffer;
+
+    ProgramBank _program_bank;
+    std::atomic<int> _pending_program_parameters;  // 1 + the program whose parameters are still to be set on the message thread, or 0
+    juce::File _preset_library_file;
+    ParameterCrossfade _program_crossfade;
+    DrEchoEngine::Parameters _last_parameters;
+
+    QualityGovernor _quality_governor;
+
+    RealtimeSafetyReporter _realtime_safety_reporter;
+
+    Telemetry _telemetry;
+    float _telemetry_peak_wet;
+
+    LevelMeters _level_meters;
+
+    std::unique_ptr<StandaloneSupport> _standalone_support;    // only in the standalone build, when configured
+
+private:
+    void _prepare_delay_network();
+    void _set_parameters(const DrEchoEngine::Parameters& parameters);
+
+    /**
+     * Processes a part of the block of at most the prepared size, in short
+     * parts while a program crossfade advances the parameters. Returns the
+     * peak of the wet signal.
+     */
+    float _process_part(float* const* channels, int num_channels, int num_samples, DrEchoEngine::Parameters& parameters, double bpm,
+                        float* const* wet_channels, const float* const* sidechain_channels, int num_sidechain_channels);
+    void _publish_levels();
+
+    void timerCallback() override;
 
 private:
     //==============================================================================
@@ -0,0 +1,191 @@
+/*
+  ==============================================================================
+
+    PresetBrowser.cpp
+    Created: 20 Oct 2026 3:52:40am
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#include "PresetBrowser.h"
+
+#include "PluginProcessor.h"
+#include "MyLogger.h"
+
+static const juce::Colour _background( 0xf0131b30 );
+static const juce::Colour _foreground( 0xefffffff );
+static const juce::Colour _dimmed( 0x7fffffff );
+static const juce::Colour _highlight( 0x3fffffff );
+
+static const int _MARGIN = 8;
+static const int _ROW_HEIGHT = 20;
+static const int _BUTTON_HEIGHT = 24;
+
+//==============================================================================
+PresetBrowser::PresetBrowser(DrEchoAudioProcessor& processor, EditorResources& resources)
+    : _processor( processor )
+    , _resources( resources )
+    , _list( "presets", this )
+{
+    _search_box.setTextToShowWhenEmpty( "Search: words in the name, #tag", _dimmed );
+    _search_box.onTextChange = [this] { _update_results(); };
+    // Down from the search box into the list, so that browsing never needs the mouse.
+    _search_box.onReturnKey = [this] { _list.selectRow( 0 ); _list.grabKeyboardFocus(); };
+    addAndMakeVisible( _search_box );
+
+    _list.setRowHeight( _ROW_HEIGHT );
+    _list.setColour( juce::ListBox::backgroundColourId, juce::Colours::transparentBlack );
+    addAndMakeVisible( _list );
+
+    _open_button.setButtonText( "OPEN" );
+    _open_button.onClick = [this] { _choose_library(); };
+    addAndMakeVisible( _open_button );
+
+    _import_button.setButtonText( "IMPORT" );
+    _import_button.onClick = [this] { _choose_import_directory(); };
+    addAndMakeVisible( _import_button );
+
+    _status.setFont( _resources.italic_font );
+    _status.setColour( juce::Label::textColourId, _dimmed );
+    addAndMakeVisible( _status );
+
+    for ( juce::Component* component : std::initializer_list<juce::Component*>{ &_search_box, &_list, &_open_button, &_import_button, &_status } )
+        component->setLookAndFeel( &_resources.meta_look_and_feel );
+
+    _open( _processor.getPresetLibraryFile() );
+}
+
+PresetBrowser::~PresetBrowser()
+{
+    for ( juce::Component* component : std::initializer_list<juce::Component*>{ &_search_box, &_list, &_open_button, &_import_button, &_status } )
+        component->setLookAndFeel( nullptr );
+}
+
+//==============================================================================
+void PresetBrowser::paint(juce::Graphics& g)
+{
+    g.fillAll( _background );
+}
+
+void PresetBrowser::resized()
+{
+    juce::Rectangle<int> bounds = getLocalBounds().reduced( _MARGIN );
+
+    juce::Rectangle<int> buttons = bounds.removeFromBottom( _BUTTON_HEIGHT );
+    _open_button.setBounds( buttons.removeFromLeft( buttons.getWidth() / 2 - _MARGIN / 2 ) );
+    _import_button.setBounds( buttons.removeFromRight( buttons.getWidth() - _MARGIN ) );
+    bounds.removeFromBottom( _MARGIN / 2 );
+    _status.setBounds( bounds.removeFromBottom( _ROW_HEIGHT ) );
+
+    _search_box.setBounds( bounds.removeFromTop( _BUTTON_HEIGHT ) );
+    bounds.removeFromTop( _MARGIN / 2 );
+    _list.setBounds( bounds );
+}
+
+//==============================================================================
+int PresetBrowser::getNumRows()
+{
+    return _results.size();
+}
+
+void PresetBrowser::paintListBoxItem(int row, juce::Graphics& g, int width, int height, bool selected)
+{
+    if ( !_library || row < 0 || row >= _results.size() )
+        return;
+
+    // Only the visible rows get here, so only their index entries are read.
+    const int index = _results[row];
+    if ( selected )
+        g.fillAll( _highlight );
+
+    const juce::String tags = _library->getTags( index ).joinIntoString( " " );
+    const int tags_width = juce::jmin( width / 2, _resources.italic_font.getStringWidth( tags ) + 4 );
+
+    g.setFont( _resources.label_font );
+    g.setColour( _foreground );
+    g.drawFittedText( _library->getName( index ), 4, 0, width - tags_width - 8, height, juce::Justification::centredLeft, 1 );
+    g.setFont( _resources.italic_font );
+    g.setColour( _dimmed );
+    g.drawFittedText( tags, width - tags_width - 4, 0, tags_width, height, juce::Justification::centredRight, 1 );
+}
+
+void PresetBrowser::selectedRowsChanged(int last_row_selected)
+{
+    if ( _library && last_row_selected >= 0 && last_row_selected < _results.size() )
+        _processor.loadPreset( *_library, _results[last_row_selected] );
+}
+
+//==============================================================================
+void PresetBrowser::_open(const juce::File& file)
+{
+    _library.reset( new PresetLibrary( file ) );
+    _update_results();
+}
+
+void PresetBrowser::_update_results()
+{
+    if ( _library && _library->isOpen() )
+    {
+        _library->search( _search_box.getText(), _results );
+        _status.setText( _library->getFile().getFileNameWithoutExtension() + ": "
+                         + juce::String( _results.size() ) + " of " + juce::String( _library->getNumPresets() ) + " presets",
+                         juce::NotificationType::dontSendNotification );
+    }
+    else
+    {
+        _results.clearQuick();
+        _status.setText( "No preset library; OPEN one or IMPORT presets", juce::NotificationType::dontSendNotification );
+    }
+
+    _list.deselectAllRows();
+    _list.updateContent();
+    _list.repaint();
+}
+
+void PresetBrowser::_choose_library()
+{
+    _file_chooser.reset( new juce::FileChooser( "Open a preset library", _processor.getPresetLibraryFile(), "*.drpresets" ) );
+    _file_chooser->launchAsync( juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles,
+                                [this](const juce::FileChooser& chooser)
+    {
+        const juce::File file = chooser.getResult();
+        if ( file == juce::File() )
+            return;
+        _processor.setPresetLibraryFile( file );
+        _open( file );
+    } );
+}
+
+void PresetBrowser::_choose_import_directory()
+{
+    _file_chooser.reset( new juce::FileChooser( "Import the .xml presets of a directory into " + _processor.getPresetLibraryFile().getFileName() ) );
+    _file_chooser->launchAsync( juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectDirectories,
+                                [this](const juce::FileChooser& chooser)
+    {
+        const juce::File directory = chooser.getResult();
+        if ( directory == juce::File() )
+            return;
+
+        // The import is the one time the XML gets parsed; from then on, browsing only reads the mapped index.
+        const juce::Array<PresetLibrary::Preset> imported = PresetLibrary::readXmlPresets( directory );
+        const juce::File file = _processor.getPresetLibraryFile();
+
+        // The presets already in the library are kept, so importing never loses any.
+        juce::Array<PresetLibrary::Preset> presets;
+        _library.reset(); // unmapped before the file is replaced
+        {
+            const PresetLibrary existing( file );
+            for ( int i = 0; i < existing.getNumPresets(); ++i )
+                presets.add( existing.getPreset( i ) );
+        }
+        const int num_replaced = PresetLibrary::merge( presets, imported );
+
+        if ( PresetLibrary::write( file, presets ) )
+            MyLogger::log( juce::String( imported.size() ) + " presets imported from " + directory.getFullPathName() + " into " + file.getFullPathName()
+                           + " (" + juce::String( num_replaced ) + " replaced, " + juce::String( presets.size() ) + " in total)" );
+        else
+            MyLogger::log( "Could not write the preset library " + file.getFullPathName() );
+        _open( file );
+    } );
+}
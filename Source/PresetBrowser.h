@@ -0,0 +1,68 @@
+/*
+  ==============================================================================
+
+    PresetBrowser.h
+    Created: 20 Oct 2026 3:52:40am
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "EditorResources.h"
+#include "PresetLibrary.h"
+
+class DrEchoAudioProcessor;
+
+/**
+ * Browses the processor's preset library: a search box, searched on every
+ * key stroke (see PresetLibrary::search()), and the list of matches, where
+ * selecting a preset loads it right away, so that the arrow keys audition
+ * one preset after another. OPEN switches to another library file, IMPORT
+ * adds a directory of .xml presets to the library the browser shows.
+ */
+class PresetBrowser
+    : public juce::Component
+    , private juce::ListBoxModel
+{
+
+public:
+    /** The resources are shared, so they must outlive this. */
+    PresetBrowser(DrEchoAudioProcessor& processor, EditorResources& resources);
+    ~PresetBrowser() override;
+
+public:
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+
+private:
+    int getNumRows() override;
+    void paintListBoxItem(int row, juce::Graphics& g, int width, int height, bool selected) override;
+    void selectedRowsChanged(int last_row_selected) override;
+
+private:
+    void _open(const juce::File& file);
+    void _update_results();
+    void _choose_library();
+    void _choose_import_directory();
+
+private:
+    DrEchoAudioProcessor& _processor;
+    EditorResources& _resources;
+
+    std::unique_ptr<PresetLibrary> _library;
+    juce::Array<int> _results;
+
+    juce::TextEditor _search_box;
+    juce::ListBox _list;
+    juce::TextButton _open_button;
+    juce::TextButton _import_button;
+    juce::Label _status;
+
+    std::unique_ptr<juce::FileChooser> _file_chooser;
+
+    JUCE_DECLARE_NON_COPYABLE( PresetBrowser )
+};
@@ -0,0 +1,343 @@
+/*
+  ==============================================================================
+
+    PresetLibrary.cpp
+    Created: 20 Oct 2026 3:52:40am
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#include "PresetLibrary.h"
+
+#include "MyLogger.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+static uint64_t _align(uint64_t offset)
+{
+    return (offset + PRESET_LIBRARY_ALIGNMENT - 1) / PRESET_LIBRARY_ALIGNMENT * PRESET_LIBRARY_ALIGNMENT;
+}
+
+/** The length of a zero-padded field, which isn't terminated when it's full. */
+static int _get_length(const char* field, int size)
+{
+    int length = 0;
+    while ( length < size && field[length] != 0 )
+        ++length;
+    return length;
+}
+
+/** Copies a string into a zero-padded field, cutting it (but no UTF-8 sequence) so that it stays terminated. */
+static void _copy_to_field(const juce::String& text, char* field, int size)
+{
+    const char* utf8 = text.toRawUTF8();
+    int length = static_cast<int>( std::strlen( utf8 ) );
+    if ( length > size - 1 )
+    {
+        length = size - 1;
+        while ( length > 0 && (static_cast<unsigned char>( utf8[length] ) & 0xc0) == 0x80 )
+            --length;
+    }
+    std::memcpy( field, utf8, static_cast<size_t>( length ) );
+}
+
+static char _to_lower(char c)
+{
+    return c >= 'A' && c <= 'Z' ? static_cast<char>( c - 'A' + 'a' ) : c;
+}
+
+static bool _contains_ignoring_case(const char* text, int length, const std::string& lower_word)
+{
+    const int word_length = static_cast<int>( lower_word.size() );
+    for ( int start = 0; start + word_length <= length; ++start )
+    {
+        int i = 0;
+        while ( i < word_length && _to_lower( text[start + i] ) == lower_word[i] )
+            ++i;
+        if ( i == word_length )
+            return true;
+    }
+    return false;
+}
+
+static std::string _to_lower(const juce::String& text)
+{
+    std::string result( text.toRawUTF8() );
+    for ( char& c : result )
+        c = _to_lower( c );
+    return result;
+}
+
+//==============================================================================
+juce::File PresetLibrary::getDefaultFile()
+{
+    return juce::File::getSpecialLocation( juce::File::userApplicationDataDirectory )
+        .getChildFile( JucePlugin_Name ).getChildFile( "Presets.drpresets" );
+}
+
+bool PresetLibrary::write(const juce::File& file, const juce::Array<Preset>& presets)
+{
+    juce::StringArray tags;
+    juce::StringArray parameter_ids;
+    for ( const Preset& preset : presets )
+    {
+        for ( const juce::String& tag : preset.tags )
+            if ( tags.size() < PRESET_LIBRARY_MAX_TAGS )
+                tags.addIfNotAlreadyThere( tag, true );
+        for ( const juce::String& parameter_id : preset.values.getAllKeys() )
+            if ( parameter_ids.size() < PRESET_LIBRARY_MAX_PARAMETERS && static_cast<int>( std::strlen( parameter_id.toRawUTF8() ) ) < PRESET_LIBRARY_ID_LENGTH )
+                parameter_ids.addIfNotAlreadyThere( parameter_id );
+    }
+
+    PresetLibraryHeader header = {};
+    header.magic = PRESET_LIBRARY_MAGIC;
+    header.version = PRESET_LIBRARY_VERSION;
+    header.num_presets = static_cast<uint32_t>( presets.size() );
+    header.num_parameters = static_cast<uint32_t>( parameter_ids.size() );
+    header.num_tags = static_cast<uint32_t>( tags.size() );
+    header.record_size = header.num_parameters * static_cast<uint32_t>( sizeof( float ) );
+    header.index_offset = _align( sizeof( PresetLibraryHeader ) );
+    header.records_offset = _align( header.index_offset + header.num_presets * sizeof( PresetIndexEntry ) );
+    for ( int p = 0; p < parameter_ids.size(); ++p )
+        _copy_to_field( parameter_ids[p], header.parameter_ids[p], PRESET_LIBRARY_ID_LENGTH );
+    for ( int t = 0; t < tags.size(); ++t )
+        _copy_to_field( tags[t], header.tags[t], PRESET_LIBRARY_TAG_LENGTH );
+
+    juce::MemoryBlock data( static_cast<size_t>( header.records_offset + header.num_presets * header.record_size ), true );
+    std::memcpy( data.getData(), &header, sizeof( header ) );
+    auto* index = reinterpret_cast<PresetIndexEntry*>( static_cast<char*>( data.getData() ) + header.index_offset );
+    auto* records = reinterpret_cast<float*>( static_cast<char*>( data.getData() ) + header.records_offset );
+    for ( int i = 0; i < presets.size(); ++i )
+    {
+        const Preset& preset = presets.getReference( i );
+        _copy_to_field( preset.name, index[i].name, PRESET_LIBRARY_NAME_LENGTH );
+        for ( const juce::String& tag : preset.tags )
+        {
+            const int t = tags.indexOf( tag, true );
+            if ( t >= 0 )
+                index[i].tags |= uint64_t( 1 ) << t;
+        }
+        for ( int p = 0; p < parameter_ids.size(); ++p )
+        {
+            const juce::String value = preset.values.getValue( parameter_ids[p], juce::String() );
+            records[i * parameter_ids.size() + p] = value.isEmpty() ? std::numeric_limits<float>::quiet_NaN() : value.getFloatValue();
+        }
+    }
+
+    // Written next to the old file and moved over it, so that a library
+    // which is mapped somewhere else stays intact.
+    juce::TemporaryFile temporary_file( file );
+    return file.getParentDirectory().createDirectory()
+        && temporary_file.getFile().replaceWithData( data.getData(), data.getSize() )
+        && temporary_file.overwriteTargetFileWithTemporary();
+}
+
+juce::Array<PresetLibrary::Preset> PresetLibrary::readXmlPresets(const juce::File& directory)
+{
+    juce::Array<juce::File> files = directory.findChildFiles( juce::File::findFiles, true, "*.xml" );
+    files.sort();
+
+    juce::Array<Preset> presets;
+    for ( const juce::File& file : files )
+    {
+        std::unique_ptr<juce::XmlElement> root_element = juce::XmlDocument::parse( file );
+        if ( !root_element )
+            continue;
+
+        // Either a saved plug-in state or only the parameters in it.
+        const juce::XmlElement* parameters_element = root_element->hasTagName( "PARAMETERS" ) ? root_element.get() : root_element->getChildByName( "PARAMETERS" );
+        if ( !parameters_element )
+            continue;
+
+        Preset preset;
+        preset.name = file.getFileNameWithoutExtension();
+        for ( const juce::XmlElement* parameter_element : parameters_element->getChildWithTagNameIterator( "PARAM" ) )
+            if ( parameter_element->hasAttribute( "id" ) && parameter_element->hasAttribute( "value" ) )
+                preset.values.set( parameter_element->getStringAttribute( "id" ), parameter_element->getStringAttribute( "value" ) );
+        if ( preset.values.size() == 0 )
+            continue;
+
+        preset.tags.addTokens( file.getParentDirectory().getRelativePathFrom( directory ), "/\\", "" );
+        preset.tags.addTokens( root_element->getStringAttribute( "tags" ), ",", "" );
+        preset.tags.trim();
+        preset.tags.removeString( "." );
+        preset.tags.removeEmptyStrings();
+        preset.tags.removeDuplicates( true );
+        presets.add( preset );
+    }
+    return presets;
+}
+
+int PresetLibrary::merge(juce::Array<Preset>& presets, const juce::Array<Preset>& imported)
+{
+    int num_replaced = 0;
+    for ( const Preset& preset : imported )
+    {
+        Preset* existing = nullptr;
+        for ( Preset& candidate : presets )
+            if ( candidate.name == preset.name )
+                existing = &candidate;
+
+        if ( !existing )
+        {
+            presets.add( preset );
+            continue;
+        }
+        existing->values = preset.values;
+        existing->tags.addArray( preset.tags );
+        existing->tags.removeDuplicates( true );
+        ++num_replaced;
+    }
+    return num_replaced;
+}
+
+//==============================================================================
+PresetLibrary::PresetLibrary(const juce::File& file)
+    : _file( file )
+    , _header( nullptr )
+    , _index( nullptr )
+    , _records( nullptr )
+{
+    if ( !file.existsAsFile() )
+        return;
+
+    _mapped_file = std::make_unique<juce::MemoryMappedFile>( file, juce::MemoryMappedFile::readOnly, false );
+    const char* data = static_cast<const char*>( _mapped_file->getData() );
+    const uint64_t size = static_cast<uint64_t>( _mapped_file->getSize() );
+
+    // Everything that is read later on is checked here, once.
+    const auto* header = reinterpret_cast<const PresetLibraryHeader*>( data );
+    const bool valid = data != nullptr
+        && size >= sizeof( PresetLibraryHeader )
+        && header->magic == PRESET_LIBRARY_MAGIC
+        && header->version == PRESET_LIBRARY_VERSION
+        && header->num_parameters <= static_cast<uint32_t>( PRESET_LIBRARY_MAX_PARAMETERS )
+        && header->num_tags <= static_cast<uint32_t>( PRESET_LIBRARY_MAX_TAGS )
+        && header->record_size == header->num_parameters * sizeof( float )
+        && header->index_offset % PRESET_LIBRARY_ALIGNMENT == 0
+        && header->records_offset % PRESET_LIBRARY_ALIGNMENT == 0
+        && header->index_offset >= sizeof( PresetLibraryHeader )
+        && header->index_offset <= size
+        && header->records_offset <= size
+        && header->num_presets <= (size - header->index_offset) / sizeof( PresetIndexEntry )
+        && (header->record_size == 0 || header->num_presets <= (size - header->records_offset) / header->record_size);
+    if ( !valid )
+    {
+        MyLogger::log( "Not a preset library: " + file.getFullPathName() );
+        _mapped_file.reset();
+        return;
+    }
+
+    _header = header;
+    _index = reinterpret_cast<const PresetIndexEntry*>( data + header->index_offset );
+    _records = reinterpret_cast<const float*>( data + header->records_offset );
+}
+
+int PresetLibrary::getNumPresets() const
+{
+    return _header ? static_cast<int>( _header->num_presets ) : 0;
+}
+
+juce::String PresetLibrary::getName(int index) const
+{
+    jassert( index >= 0 && index < getNumPresets() );
+    const char* name = _index[index].name;
+    return juce::String::fromUTF8( name, _get_length( name, PRESET_LIBRARY_NAME_LENGTH ) );
+}
+
+juce::StringArray PresetLibrary::getTags(int index) const
+{
+    jassert( index >= 0 && index < getNumPresets() );
+    juce::StringArray tags;
+    for ( int t = 0; t < static_cast<int>( _header->num_tags ); ++t )
+        if ( (_index[index].tags >> t) & 1 )
+            tags.add( juce::String::fromUTF8( _header->tags[t], _get_length( _header->tags[t], PRESET_LIBRARY_TAG_LENGTH ) ) );
+    return tags;
+}
+
+PresetLibrary::Preset PresetLibrary::getPreset(int index) const
+{
+    Preset preset;
+    preset.name = getName( index );
+    preset.tags = getTags( index );
+    for ( int column = 0; column < getNumParameters(); ++column )
+    {
+        const float value = getValue( index, column );
+        if ( !std::isnan( value ) )
+            preset.values.set( getParameterId( column ), juce::String( value ) );
+    }
+    return preset;
+}
+
+int PresetLibrary::getNumParameters() const
+{
+    return _header ? static_cast<int>( _header->num_parameters ) : 0;
+}
+
+juce::String PresetLibrary::getParameterId(int column) const
+{
+    jassert( column >= 0 && column < getNumParameters() );
+    return juce::String::fromUTF8( _header->parameter_ids[column], _get_length( _header->parameter_ids[column], PRESET_LIBRARY_ID_LENGTH ) );
+}
+
+float PresetLibrary::getValue(int index, int column) const
+{
+    jassert( index >= 0 && index < getNumPresets() && column >= 0 && column < getNumParameters() );
+    return _records[static_cast<size_t>( index ) * _header->num_parameters + static_cast<size_t>( column )];
+}
+
+void PresetLibrary::search(const juce::String& query, juce::Array<int>& results) const
+{
+    results.clearQuick();
+    if ( !_header )
+        return;
+
+    // The query is taken apart once; the loop over the index then only compares bytes.
+    std::vector<std::string> words;
+    std::vector<uint64_t> tag_masks;
+    for ( const juce::String& word : juce::StringArray::fromTokens( query, false ) )
+    {
+        if ( !word.startsWithChar( '#' ) )
+        {
+            words.push_back( _to_lower( word ) );
+            continue;
+        }
+
+        const std::string prefix = _to_lower( word.substring( 1 ) );
+        uint64_t mask = 0;
+        for ( int t = 0; t < static_cast<int>( _header->num_tags ); ++t )
+        {
+            const char* tag = _header->tags[t];
+            const int length = _get_length( tag, PRESET_LIBRARY_TAG_LENGTH );
+            if ( length >= static_cast<int>( prefix.size() ) && _contains_ignoring_case( tag, static_cast<int>( prefix.size() ), prefix ) )
+                mask |= uint64_t( 1 ) << t;
+        }
+        if ( mask == 0 )
+            return; // no such tag
+        tag_masks.push_back( mask );
+    }
+
+    const int num_presets = getNumPresets();
+    results.ensureStorageAllocated( num_presets );
+    for ( int i = 0; i < num_presets; ++i )
+    {
+        const PresetIndexEntry& entry = _index[i];
+
+        bool match = true;
+        for ( size_t m = 0; match && m < tag_masks.size(); ++m )
+            match = (entry.tags & tag_masks[m]) != 0;
+        if ( match && !words.empty() )
+        {
+            const int length = _get_length( entry.name, PRESET_LIBRARY_NAME_LENGTH );
+            for ( size_t w = 0; match && w < words.size(); ++w )
+                match = _contains_ignoring_case( entry.name, length, words[w] );
+        }
+        if ( match )
+            results.add( i );
+    }
+}
@@ -0,0 +1,97 @@
+/*
+  ==============================================================================
+
+    PresetLibrary.h
+    Created: 20 Oct 2026 3:52:40am
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "PresetLibraryLayout.h"
+
+/**
+ * A preset library file (see PresetLibraryLayout.h), mapped into memory
+ * read-only. Opening it only checks the header and the sizes; browsing,
+ * searching and loading presets read straight from the mapping, so a
+ * library of thousands of presets costs neither parsing nor memory up front,
+ * and only the pages that are actually looked at are ever read from disk.
+ * Message thread only.
+ */
+class PresetLibrary
+{
+
+public:
+    /** A preset on its way into a library file. */
+    struct Preset
+    {
+        juce::String name;
+        juce::StringArray tags;
+        juce::StringPairArray values;   // parameter ID to plain value
+    };
+
+public:
+    /** Where the editor looks for a library unless another one is opened: Dr.Echo/Presets.drpresets in the user's application data. */
+    static juce::File getDefaultFile();
+
+    /**
+     * Writes the given presets to a library file, replacing it. Names and
+     * tags that are too long are cut; tags beyond the 64th and parameters
+     * beyond the 32nd are dropped.
+     */
+    static bool write(const juce::File& file, const juce::Array<Preset>& presets);
+
+    /**
+     * Reads every .xml preset (a saved plug-in state or just its parameters)
+     * under the given directory. The preset takes its name from the file,
+     * and its tags from the subdirectories it is in and from a comma-separated
+     * "tags" attribute of its root element.
+     */
+    static juce::Array<Preset> readXmlPresets(const juce::File& directory);
+
+    /**
+     * Adds the imported presets to the given ones. An imported preset
+     * replaces the values of the preset of the same name and adds its tags
+     * to it; the others are appended. Returns the number of replaced presets.
+     */
+    static int merge(juce::Array<Preset>& presets, const juce::Array<Preset>& imported);
+
+public:
+    explicit PresetLibrary(const juce::File& file);
+
+public:
+    /** False if the file couldn't be mapped or isn't a library of this version. */
+    bool isOpen() const { return _header != nullptr; }
+
+    const juce::File& getFile() const { return _file; }
+
+    int getNumPresets() const;
+    juce::String getName(int index) const;
+    juce::StringArray getTags(int index) const;
+
+    /** Reads a preset back completely, e.g. to write it into a library again; parameters it has no value for are left out. */
+    Preset getPreset(int index) const;
+
+    int getNumParameters() const;
+    juce::String getParameterId(int column) const;
+    float getValue(int index, int column) const;
+
+    /**
+     * Finds the presets that match all words of the query, in library order.
+     * A word is matched against the name, ignoring case (ASCII only); a
+     * word starting with # against the beginnings of the preset's tags.
+     */
+    void search(const juce::String& query, juce::Array<int>& results) const;
+
+private:
+    juce::File _file;
+    std::unique_ptr<juce::MemoryMappedFile> _mapped_file;
+    const PresetLibraryHeader* _header;
+    const PresetIndexEntry* _index;
+    const float* _records;
+
+};
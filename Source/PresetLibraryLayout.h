@@ -0,0 +1,64 @@
+/*
+  ==============================================================================
+
+    PresetLibraryLayout.h
+    Created: 20 Oct 2026 3:52:40am
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+// The layout of a preset library file. Deliberately free of JUCE, so that
+// tools can write libraries without it.
+//
+// A library is a header, an index with one fixed-size entry (name and tags)
+// per preset, and a table of fixed-size parameter records, in the same
+// order. The index is kept apart from the records, so that a search only
+// touches the index pages of the mapped file. All offsets are from the start
+// of the file; all numbers are little-endian, as on every platform we build
+// for.
+
+#include <cstdint>
+
+static const uint32_t PRESET_LIBRARY_MAGIC = 0x4c505244; // "DRPL"
+static const uint32_t PRESET_LIBRARY_VERSION = 1;
+
+static const int PRESET_LIBRARY_MAX_PARAMETERS = 32;
+static const int PRESET_LIBRARY_MAX_TAGS = 64;          // one bit each in PresetIndexEntry::tags
+static const int PRESET_LIBRARY_ID_LENGTH = 16;         // bytes, including the terminating zero
+static const int PRESET_LIBRARY_TAG_LENGTH = 24;
+static const int PRESET_LIBRARY_NAME_LENGTH = 56;
+
+static const int PRESET_LIBRARY_ALIGNMENT = 64;         // of the index and the records
+
+struct PresetLibraryHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t num_presets;
+    uint32_t num_parameters;
+    uint32_t num_tags;
+    uint32_t record_size;       // bytes, num_parameters floats
+    uint64_t index_offset;
+    uint64_t records_offset;
+
+    // The column of each parameter in the records, by parameter ID, so that a
+    // library stays readable when parameters are added or removed.
+    char parameter_ids[PRESET_LIBRARY_MAX_PARAMETERS][PRESET_LIBRARY_ID_LENGTH];
+    char tags[PRESET_LIBRARY_MAX_TAGS][PRESET_LIBRARY_TAG_LENGTH];
+};
+
+/** One cache line per preset: the UTF-8 name, zero-padded, and the tag bits. */
+struct PresetIndexEntry
+{
+    char name[PRESET_LIBRARY_NAME_LENGTH];
+    uint64_t tags;
+};
+
+// A record is num_parameters floats, the plain (not normalised) parameter
+// values; NaN where a preset leaves a parameter at its default.
+
+static_assert( sizeof( PresetIndexEntry ) == 64, "An index entry should fill exactly one cache line." );
+static_assert( sizeof( PresetLibraryHeader ) % 8 == 0, "The header must not depend on the compiler's padding at its end." );
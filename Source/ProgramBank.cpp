@@ -0,0 +1,117 @@
+/*
+  ==============================================================================
+
+    ProgramBank.cpp
+    Created: 19 Oct 2026 10:58:14pm
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#include "ProgramBank.h"
+
+using Shape = LfoWavetable::Shape;
+
+// Columns follow DrEchoEngine::Parameters: gain (dB), pan (degrees), delay (1/16ths), ping-pong,
+// feedback, dry, wet, mod rate (Hz), mod depth (ms), mod shape, mod phase (degrees), shimmer (semitones), shimmer mix;
+// the tempo sync settings keep their defaults (straight 1/16ths, synced), and so does the ducking (off).
+static const ProgramBank::Program _programs[] =
+{
+    { "Init",               {  0.0f,   0,   2.0f, 0.50f, 0.00f, 1.00f, 0.50f, 0.50f, 0.0f, Shape::Sine,       0,   0.0f, 0.50f } },
+    { "Slapback",           {  0.0f,   0,   0.5f, 0.00f, 0.10f, 1.00f, 0.45f, 0.50f, 0.0f, Shape::Sine,       0,   0.0f, 0.50f } },
+    { "Quarter Note",       {  0.0f,   0,   4.0f, 0.20f, 0.35f, 1.00f, 0.40f, 0.50f, 0.0f, Shape::Sine,       0,   0.0f, 0.50f } },
+    { "Dotted Ping-Pong",   {  0.0f,   0,   3.0f, 1.00f, 0.45f, 1.00f, 0.45f, 0.50f, 0.0f, Shape::Sine,       0,   0.0f, 0.50f } },
+    { "Tape Wobble",        { -1.0f,   0,   3.0f, 0.30f, 0.50f, 1.00f, 0.50f, 0.80f, 3.0f, Shape::Sine,      90,   0.0f, 0.50f } },
+    { "Wide Chorus Echo",   {  0.0f,   0,   2.0f, 0.60f, 0.30f, 1.00f, 0.50f, 1.50f, 6.0f, Shape::Triangle, 180,   0.0f, 0.50f } },
+    { "Dub Spiral",         { -2.0f, -15,   6.0f, 0.70f, 0.80f, 1.00f, 0.60f, 0.20f, 1.5f, Shape::Random,    45,   0.0f, 0.50f } },
+    { "Shimmer Up",         { -3.0f,   0,   4.0f, 0.50f, 0.65f, 1.00f, 0.45f, 0.30f, 2.0f, Shape::Sine,      90,  12.0f, 0.50f } },
+    { "Octave Down Wash",   { -3.0f,   0,   8.0f, 0.80f, 0.70f, 0.80f, 0.55f, 0.25f, 4.0f, Shape::Triangle,  90, -12.0f, 0.40f } },
+    { "Ambient Cloud",      { -6.0f,   0,  12.0f, 0.90f, 0.85f, 0.70f, 0.70f, 0.15f, 8.0f, Shape::Sine,     180,  24.0f, 0.30f } },
+};
+
+static const int _num_programs = static_cast<int>( sizeof( _programs ) / sizeof( _programs[0] ) );
+
+//==============================================================================
+ProgramBank::ProgramBank()
+    : _current( 0 )
+    , _pending( nullptr )
+{
+}
+
+int ProgramBank::getNumPrograms()
+{
+    return _num_programs;
+}
+
+const ProgramBank::Program& ProgramBank::getProgram(int index)
+{
+    return _programs[ dspLimit( 0, _num_programs - 1, index ) ];
+}
+
+void ProgramBank::select(int index)
+{
+    index = dspLimit( 0, _num_programs - 1, index );
+    _current.store( index, std::memory_order_relaxed );
+    _pending.store( &_programs[ index ], std::memory_order_release );
+}
+
+void ProgramBank::restore(int index)
+{
+    _current.store( dspLimit( 0, _num_programs - 1, index ), std::memory_order_relaxed );
+}
+
+//==============================================================================
+ParameterCrossfade::ParameterCrossfade()
+    : _position( 0 )
+    , _length( 0 )
+{
+}
+
+void ParameterCrossfade::start(const DrEchoEngine::Parameters& from, const DrEchoEngine::Parameters& to, int num_samples)
+{
+    _from = from;
+    _to = to;
+    _position = 0;
+    _length = std::max( 1, num_samples );
+}
+
+DrEchoEngine::Parameters ParameterCrossfade::advance(int num_samples)
+{
+    const float t = dspLimit( 0.0f, 1.0f, (static_cast<float>( _position ) + 0.5f * static_cast<float>( num_samples )) / static_cast<float>( _length ) );
+    _position = std::min( _length, _position + num_samples );
+    if ( !isActive() )
+        return _to;
+
+    auto mix = [t](float a, float b) { return a + t * (b - a); };
+
+    DrEchoEngine::Parameters parameters;
+    parameters.gain_db = mix( _from.gain_db, _to.gain_db );
+    parameters.pan = mix( _from.pan, _to.pan );
+    parameters.delay = mix( _from.delay, _to.delay );
+    parameters.pingpong = mix( _from.pingpong, _to.pingpong );
+    parameters.feedback = mix( _from.feedback, _to.feedback );
+    parameters.dry = mix( _from.dry, _to.dry );
+    parameters.wet = mix( _from.wet, _to.wet );
+    parameters.mod_rate = mix( _from.mod_rate, _to.mod_rate );
+    parameters.mod_depth = mix( _from.mod_depth, _to.mod_depth );
+    parameters.mod_phase = mix( _from.mod_phase, _to.mod_phase );
+    parameters.delay_ms = mix( _from.delay_ms, _to.delay_ms );
+    parameters.duck_amount_db = mix( _from.duck_amount_db, _to.duck_amount_db );
+    parameters.duck_threshold_db = mix( _from.duck_threshold_db, _to.duck_threshold_db );
+    parameters.duck_attack_ms = mix( _from.duck_attack_ms, _to.duck_attack_ms );
+    parameters.duck_release_ms = mix( _from.duck_release_ms, _to.duck_release_ms );
+
+    const DrEchoEngine::Parameters& nearest = t < 0.5f ? _from : _to;
+    parameters.mod_shape = nearest.mod_shape;
+    parameters.shimmer_semitones = nearest.shimmer_semitones;
+    parameters.division = nearest.division;
+    parameters.synced = nearest.synced;
+
+    // Another interval would jump in pitch, so the shimmer fades out up to
+    // the switch and the new one fades in after it.
+    if ( _from.shimmer_semitones == _to.shimmer_semitones )
+        parameters.shimmer_mix = mix( _from.shimmer_mix, _to.shimmer_mix );
+    else
+        parameters.shimmer_mix = nearest.shimmer_mix * std::abs( 2.0f * t - 1.0f );
+    return parameters;
+}
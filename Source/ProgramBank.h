@@ -0,0 +1,86 @@
+/*
+  ==============================================================================
+
+    ProgramBank.h
+    Created: 19 Oct 2026 10:58:14pm
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "DrEchoEngine.h"
+
+#include <atomic>
+
+/**
+ * The factory programs, as ready-to-use engine parameter snapshots in a
+ * static table, and the hand-over of program changes to the audio thread:
+ * selecting a program only flips an atomic pointer, which the audio thread
+ * picks up at the start of its next block. Neither side allocates, locks or
+ * parses anything.
+ */
+class ProgramBank
+{
+
+public:
+    struct Program
+    {
+        const char* name;
+        DrEchoEngine::Parameters parameters;
+    };
+
+public:
+    ProgramBank();
+
+public:
+    static int getNumPrograms();
+    static const Program& getProgram(int index);
+
+    int getCurrentProgram() const { return _current.load( std::memory_order_relaxed ); }
+
+    /** Switches to the given program; safe to call from any thread. */
+    void select(int index);
+
+    /** Marks the given program as the current one without switching to it, e.g. when restoring a state. */
+    void restore(int index);
+
+    /** For the audio thread: returns the program selected since the last call, or nullptr. */
+    const Program* takePending() { return _pending.exchange( nullptr, std::memory_order_acquire ); }
+
+private:
+    std::atomic<int> _current;
+    std::atomic<const Program*> _pending;
+
+};
+
+//==============================================================================
+/**
+ * Moves the engine parameters from one snapshot to another over a given
+ * number of samples. Continuous parameters are interpolated linearly, the
+ * discrete ones (LFO shape, shimmer interval, division, sync) switch halfway
+ * through; when the shimmer interval changes, the shimmer mix passes through
+ * zero there.
+ */
+class ParameterCrossfade
+{
+
+public:
+    ParameterCrossfade();
+
+public:
+    void start(const DrEchoEngine::Parameters& from, const DrEchoEngine::Parameters& to, int num_samples);
+
+    bool isActive() const { return _position < _length; }
+
+    /** Returns the parameters for the next num_samples samples (at their centre) and advances by as much. */
+    DrEchoEngine::Parameters advance(int num_samples);
+
+private:
+    DrEchoEngine::Parameters _from;
+    DrEchoEngine::Parameters _to;
+    int _position;
+    int _length;
+
+};
@@ -0,0 +1,87 @@
+/*
+  ==============================================================================
+
+    QualityGovernor.cpp
+    Created: 19 Oct 2026 5:18:36pm
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#include "QualityGovernor.h"
+
+QualityGovernor::QualityGovernor()
+    : _sample_rate( 44100.0 )
+    , _seconds_per_tick( 1.0 / static_cast<double>( juce::Time::getHighResolutionTicksPerSecond() ) )
+    , _step_down_load( 0.5f )
+    , _step_up_load( 0.2f )
+    , _smoothed_load( 0.0f )
+    , _seconds_since_change( 0.0 )
+    , _tier( static_cast<int>( Tier::Full ) )
+    , _load( 0.0f )
+    , _num_overruns( 0 )
+{
+}
+
+void QualityGovernor::prepare(double sample_rate)
+{
+    _sample_rate = sample_rate;
+    reset();
+}
+
+void QualityGovernor::reset()
+{
+    _smoothed_load = 0.0f;
+    _seconds_since_change = 0.0;
+    _tier.store( static_cast<int>( Tier::Full ), std::memory_order_relaxed );
+    _load.store( 0.0f, std::memory_order_relaxed );
+}
+
+void QualityGovernor::setThresholds(float step_down_load, float step_up_load)
+{
+    jassert( step_up_load < step_down_load );
+    _step_down_load = step_down_load;
+    _step_up_load = step_up_load;
+}
+
+float QualityGovernor::update(juce::int64 elapsed_ticks, int num_samples, bool realtime)
+{
+    const double SMOOTHING_SECONDS = 0.25;
+    const double MIN_SECONDS_BEFORE_STEP_DOWN = 0.25;
+    const double MIN_SECONDS_BEFORE_STEP_UP = 2.0;
+
+    if ( num_samples <= 0 )
+        return 0.0f;
+
+    const double budget = num_samples / _sample_rate;
+    const float load = static_cast<float>( static_cast<double>( elapsed_ticks ) * _seconds_per_tick / budget );
+    const float alpha = static_cast<float>( 1.0 - ::exp( -budget / SMOOTHING_SECONDS ) );
+
+    _smoothed_load += alpha * (load - _smoothed_load);
+    _seconds_since_change += budget;
+
+    _load.store( _smoothed_load, std::memory_order_relaxed );
+
+    const bool overrun = load > 1.0f;
+    if ( overrun )
+        _num_overruns.fetch_add( 1, std::memory_order_relaxed );
+
+    // Offline renders must sound the same no matter how long they take.
+    if ( !realtime )
+    {
+        _tier.store( static_cast<int>( Tier::Full ), std::memory_order_relaxed );
+        return load;
+    }
+
+    int tier = _tier.load( std::memory_order_relaxed );
+    if ( tier < NUM_TIERS - 1 && (overrun || (_smoothed_load > _step_down_load && _seconds_since_change >= MIN_SECONDS_BEFORE_STEP_DOWN)) )
+        ++tier;
+    else if ( tier > 0 && _smoothed_load < _step_up_load && _seconds_since_change >= MIN_SECONDS_BEFORE_STEP_UP )
+        --tier;
+    else
+        return load;
+
+    _tier.store( tier, std::memory_order_relaxed );
+    _seconds_since_change = 0.0;
+    return load;
+}
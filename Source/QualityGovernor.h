@@ -0,0 +1,68 @@
+/*
+  ==============================================================================
+
+    QualityGovernor.h
+    Created: 19 Oct 2026 5:18:36pm
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+ * Measures how much of each block's real-time budget processBlock takes,
+ * and steps down through the quality tiers while the (smoothed) load is too
+ * high, or back up once there is enough headroom again. Stepping down is
+ * quick, stepping up is deliberately slow, so that the tiers don't flicker.
+ */
+class QualityGovernor
+{
+
+public:
+    enum class Tier
+    {
+        Full,       // everything
+        Reduced,    // without the optional shimmer stage
+        Minimal,    // additionally with a coarse delay modulation (LFO every few samples)
+    };
+
+    static const int NUM_TIERS = 3;
+
+public:
+    QualityGovernor();
+
+public:
+    void prepare(double sample_rate);
+    void reset();
+
+    /** Sets the smoothed loads (fractions of the block budget) to step down above and back up below. */
+    void setThresholds(float step_down_load, float step_up_load);
+
+    /**
+     * Feeds in the time a block of the given size took to process, and returns
+     * that block's load. Pass realtime = false for offline renders.
+     */
+    float update(juce::int64 elapsed_ticks, int num_samples, bool realtime);
+
+    Tier getTier() const { return static_cast<Tier>( _tier.load( std::memory_order_relaxed ) ); }
+    float getLoad() const { return _load.load( std::memory_order_relaxed ); }
+    juce::uint32 getNumOverruns() const { return _num_overruns.load( std::memory_order_relaxed ); }
+
+private:
+    double _sample_rate;
+    double _seconds_per_tick;
+
+    float _step_down_load;
+    float _step_up_load;
+
+    float _smoothed_load;
+    double _seconds_since_change;
+
+    std::atomic<int> _tier;
+    std::atomic<float> _load;
+    std::atomic<juce::uint32> _num_overruns;
+
+};
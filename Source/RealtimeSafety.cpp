@@ -0,0 +1,322 @@
+/*
+  ==============================================================================
+
+    RealtimeSafety.cpp
+    Created: 19 Oct 2026 6:02:47pm
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#include "RealtimeSafety.h"
+
+#if DRECHO_REALTIME_CHECKS
+
+#if defined( _WIN32 )
+ #ifndef NOMINMAX
+  #define NOMINMAX
+ #endif
+ #include <windows.h>
+#else
+ #include <execinfo.h>
+ #include <dlfcn.h>
+ #include <pthread.h>
+#endif
+
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+// On Linux, the initial-exec model keeps the first access to a thread-local
+// from allocating, which would otherwise recurse into the malloc hook.
+#if defined( __linux__ )
+ #define DRECHO_INITIAL_EXEC __attribute__(( tls_model( "initial-exec" ) ))
+#else
+ #define DRECHO_INITIAL_EXEC
+#endif
+
+static thread_local int _audio_thread_depth DRECHO_INITIAL_EXEC = 0;
+static thread_local int _allow_depth DRECHO_INITIAL_EXEC = 0;
+static thread_local int _hook_depth DRECHO_INITIAL_EXEC = 0; // > 0 while inside a hook (or the recording of a violation)
+
+//==============================================================================
+// A bounded multi-producer/multi-consumer queue (after Dmitry Vyukov), as
+// several plugin instances may run on several audio threads. Pushing never
+// blocks; when the queue is full, the violation is only counted.
+static const int QUEUE_SIZE = 256;
+
+struct _Cell
+{
+    std::atomic<size_t> sequence;
+    RealtimeSafety::Violation violation;
+};
+
+static _Cell _cells[QUEUE_SIZE];
+static std::atomic<size_t> _enqueue_position( 0 );
+static std::atomic<size_t> _dequeue_position( 0 );
+static std::atomic<uint32_t> _num_violations( 0 );
+
+static bool _push(const RealtimeSafety::Violation& violation)
+{
+    size_t position = _enqueue_position.load( std::memory_order_relaxed );
+    for ( ;; )
+    {
+        _Cell& cell = _cells[ position & (QUEUE_SIZE - 1) ];
+        const size_t sequence = cell.sequence.load( std::memory_order_acquire );
+        const ptrdiff_t difference = static_cast<ptrdiff_t>( sequence - position );
+        if ( difference == 0 )
+        {
+            if ( _enqueue_position.compare_exchange_weak( position, position + 1, std::memory_order_relaxed ) )
+            {
+                cell.violation = violation;
+                cell.sequence.store( position + 1, std::memory_order_release );
+                return true;
+            }
+        }
+        else if ( difference < 0 )
+            return false;
+        else
+            position = _enqueue_position.load( std::memory_order_relaxed );
+    }
+}
+
+static bool _pop(RealtimeSafety::Violation& violation)
+{
+    size_t position = _dequeue_position.load( std::memory_order_relaxed );
+    for ( ;; )
+    {
+        _Cell& cell = _cells[ position & (QUEUE_SIZE - 1) ];
+        const size_t sequence = cell.sequence.load( std::memory_order_acquire );
+        const ptrdiff_t difference = static_cast<ptrdiff_t>( sequence - (position + 1) );
+        if ( difference == 0 )
+        {
+            if ( _dequeue_position.compare_exchange_weak( position, position + 1, std::memory_order_relaxed ) )
+            {
+                violation = cell.violation;
+                cell.sequence.store( position + QUEUE_SIZE, std::memory_order_release );
+                return true;
+            }
+        }
+        else if ( difference < 0 )
+            return false;
+        else
+            position = _dequeue_position.load( std::memory_order_relaxed );
+    }
+}
+
+static int _capture_stack(void** frames)
+{
+   #if defined( _WIN32 )
+    return static_cast<int>( ::CaptureStackBackTrace( 0, RealtimeSafety::MAX_STACK_FRAMES, frames, nullptr ) );
+   #else
+    return ::backtrace( frames, RealtimeSafety::MAX_STACK_FRAMES );
+   #endif
+}
+
+static bool _initialize()
+{
+    static_assert( (QUEUE_SIZE & (QUEUE_SIZE - 1)) == 0, "The queue size must be a power of two." );
+    for ( int i = 0; i < QUEUE_SIZE; ++i )
+        _cells[i].sequence.store( static_cast<size_t>( i ), std::memory_order_relaxed );
+
+    // The first stack capture may load (and allocate for) the unwinder.
+    void* frames[ RealtimeSafety::MAX_STACK_FRAMES ];
+    _capture_stack( frames );
+    return true;
+}
+
+// Nothing is recorded before the first ScopedAudioThread, which is long after static initialization.
+static const bool _initialized = _initialize();
+
+static void _check(RealtimeSafety::ViolationType type)
+{
+    if ( _audio_thread_depth == 0 || _allow_depth > 0 || _hook_depth > 0 )
+        return;
+
+    ++_hook_depth;
+    RealtimeSafety::Violation violation;
+    violation.type = type;
+    violation.num_frames = _capture_stack( violation.frames );
+    _num_violations.fetch_add( 1, std::memory_order_relaxed );
+    _push( violation );
+    --_hook_depth;
+}
+
+static void* _allocate(std::size_t size)
+{
+    _check( RealtimeSafety::ViolationType::Allocation );
+    ++_hook_depth; // the malloc hook mustn't report the same allocation again
+    void* p = std::malloc( size ? size : 1 );
+    --_hook_depth;
+    return p;
+}
+
+static void _deallocate(void* p)
+{
+    if ( !p )
+        return;
+    _check( RealtimeSafety::ViolationType::Deallocation );
+    ++_hook_depth;
+    std::free( p );
+    --_hook_depth;
+}
+
+//==============================================================================
+void* operator new(std::size_t size)
+{
+    if ( void* p = _allocate( size ) )
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    if ( void* p = _allocate( size ) )
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return _allocate( size ); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return _allocate( size ); }
+
+void operator delete(void* p) noexcept { _deallocate( p ); }
+void operator delete[](void* p) noexcept { _deallocate( p ); }
+void operator delete(void* p, std::size_t) noexcept { _deallocate( p ); }
+void operator delete[](void* p, std::size_t) noexcept { _deallocate( p ); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { _deallocate( p ); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { _deallocate( p ); }
+
+#if defined( __linux__ )
+using _MutexLockFunction = int (*)(pthread_mutex_t*);
+static _MutexLockFunction _next_pthread_mutex_lock = nullptr;
+
+extern "C"
+{
+    void* __libc_malloc(size_t size);
+    void* __libc_calloc(size_t count, size_t size);
+    void* __libc_realloc(void* p, size_t size);
+    void __libc_free(void* p);
+
+    void* malloc(size_t size) noexcept
+    {
+        _check( RealtimeSafety::ViolationType::Allocation );
+        return __libc_malloc( size );
+    }
+
+    void* calloc(size_t count, size_t size) noexcept
+    {
+        _check( RealtimeSafety::ViolationType::Allocation );
+        return __libc_calloc( count, size );
+    }
+
+    void* realloc(void* p, size_t size) noexcept
+    {
+        _check( RealtimeSafety::ViolationType::Allocation );
+        return __libc_realloc( p, size );
+    }
+
+    void free(void* p) noexcept
+    {
+        if ( p )
+            _check( RealtimeSafety::ViolationType::Deallocation );
+        __libc_free( p );
+    }
+
+    int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept
+    {
+        if ( !_next_pthread_mutex_lock )
+            _next_pthread_mutex_lock = reinterpret_cast<_MutexLockFunction>( ::dlsym( RTLD_NEXT, "pthread_mutex_lock" ) );
+        _check( RealtimeSafety::ViolationType::Lock );
+        return _next_pthread_mutex_lock( mutex );
+    }
+}
+#endif
+
+//==============================================================================
+RealtimeSafety::ScopedAudioThread::ScopedAudioThread()
+{
+    ++_audio_thread_depth;
+}
+
+RealtimeSafety::ScopedAudioThread::~ScopedAudioThread()
+{
+    --_audio_thread_depth;
+}
+
+RealtimeSafety::ScopedAllow::ScopedAllow()
+{
+    ++_allow_depth;
+}
+
+RealtimeSafety::ScopedAllow::~ScopedAllow()
+{
+    --_allow_depth;
+}
+
+uint32_t RealtimeSafety::getNumViolations()
+{
+    return _num_violations.load( std::memory_order_relaxed );
+}
+
+int RealtimeSafety::drainViolations(const std::function<void (const Violation&)>& callback)
+{
+    int num_violations = 0;
+    Violation violation;
+    while ( _pop( violation ) )
+    {
+        callback( violation );
+        ++num_violations;
+    }
+    return num_violations;
+}
+
+std::string RealtimeSafety::describe(const Violation& violation)
+{
+    static const char* const type_names[] = { "allocation", "deallocation", "lock" };
+
+    std::string text = std::string( "Real-time safety violation: " ) + type_names[ static_cast<int>( violation.type ) ] + " in the audio thread\n";
+
+   #if defined( _WIN32 )
+    char** symbols = nullptr;
+   #else
+    char** symbols = ::backtrace_symbols( violation.frames, violation.num_frames );
+   #endif
+    for ( int i = 0; i < violation.num_frames; ++i )
+    {
+        char frame[32];
+        std::snprintf( frame, sizeof( frame ), "  %d: ", i );
+        text += frame;
+        if ( symbols )
+            text += symbols[i];
+        else
+        {
+            std::snprintf( frame, sizeof( frame ), "%p", violation.frames[i] );
+            text += frame;
+        }
+        text += "\n";
+    }
+    ::free( symbols );
+
+    return text;
+}
+
+#else
+
+uint32_t RealtimeSafety::getNumViolations()
+{
+    return 0;
+}
+
+int RealtimeSafety::drainViolations(const std::function<void (const Violation&)>&)
+{
+    return 0;
+}
+
+std::string RealtimeSafety::describe(const Violation&)
+{
+    return {};
+}
+
+#endif
@@ -0,0 +1,99 @@
+/*
+  ==============================================================================
+
+    RealtimeSafety.h
+    Created: 19 Oct 2026 6:02:47pm
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+// Define DRECHO_REALTIME_CHECKS=1 (e.g. in the preprocessor definitions of a
+// debug or profiling configuration) to catch allocations and locks in the
+// audio thread. With 0, everything below compiles to nothing.
+#ifndef DRECHO_REALTIME_CHECKS
+ #define DRECHO_REALTIME_CHECKS 0
+#endif
+
+/**
+ * Real-time safety auditing. While a thread is marked as the audio thread,
+ * every call of the global operator new/delete, of malloc & co. (Linux) and
+ * of pthread_mutex_lock (Linux) is recorded as a violation, along with the
+ * stack it came from. The violations are passed on through a lock-free queue,
+ * so that recording them neither allocates nor blocks, and are logged by a
+ * RealtimeSafetyReporter on the message thread, or drained by a harness that
+ * fails on them (EngineBenchmark, the host simulator). Doesn't depend on
+ * JUCE, so that the JUCE-free tools can link it.
+ *
+ * On Linux, the malloc and mutex hooks only take effect in executables (the
+ * Standalone, a benchmark harness), or in a plugin linked with
+ * -Wl,-Bsymbolic-functions; a host's own libraries otherwise take precedence.
+ */
+class RealtimeSafety
+{
+
+public:
+    enum class ViolationType
+    {
+        Allocation,
+        Deallocation,
+        Lock,
+    };
+
+    static const int MAX_STACK_FRAMES = 32;
+
+    struct Violation
+    {
+        ViolationType type;
+        int num_frames;
+        void* frames[MAX_STACK_FRAMES];
+    };
+
+    /** Marks the current thread as the audio thread for the lifetime of the object. */
+    class ScopedAudioThread
+    {
+    public:
+       #if DRECHO_REALTIME_CHECKS
+        ScopedAudioThread();
+        ~ScopedAudioThread();
+       #else
+        ScopedAudioThread() {}
+       #endif
+        ScopedAudioThread(const ScopedAudioThread&) = delete;
+        ScopedAudioThread& operator=(const ScopedAudioThread&) = delete;
+    };
+
+    /** Tolerates violations for the lifetime of the object, e.g. in a host callback that isn't ours to fix. */
+    class ScopedAllow
+    {
+    public:
+       #if DRECHO_REALTIME_CHECKS
+        ScopedAllow();
+        ~ScopedAllow();
+       #else
+        ScopedAllow() {}
+       #endif
+        ScopedAllow(const ScopedAllow&) = delete;
+        ScopedAllow& operator=(const ScopedAllow&) = delete;
+    };
+
+public:
+    /** Whether the checks are compiled in at all. */
+    static constexpr bool isEnabled() { return DRECHO_REALTIME_CHECKS != 0; }
+
+    /** Total number of violations so far, including those that didn't fit into the queue. */
+    static uint32_t getNumViolations();
+
+    /** Hands the queued violations to the callback and returns how many there were. Not real-time safe. */
+    static int drainViolations(const std::function<void (const Violation&)>& callback);
+
+    /** Formats a violation along with its (symbolized, where possible) stack. Not real-time safe. */
+    static std::string describe(const Violation& violation);
+
+};
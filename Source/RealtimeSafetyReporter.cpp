@@ -0,0 +1,34 @@
+/*
+  ==============================================================================
+
+    RealtimeSafetyReporter.cpp
+    Created: 20 Oct 2026 4:38:22am
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#include "RealtimeSafetyReporter.h"
+
+#include "MyLogger.h"
+#include "RealtimeSafety.h"
+
+RealtimeSafetyReporter::RealtimeSafetyReporter()
+{
+    if ( RealtimeSafety::isEnabled() )
+        startTimer( 500 );
+}
+
+RealtimeSafetyReporter::~RealtimeSafetyReporter()
+{
+    stopTimer();
+}
+
+void RealtimeSafetyReporter::timerCallback()
+{
+    RealtimeSafety::drainViolations( [](const RealtimeSafety::Violation& violation) {
+        const juce::String text( RealtimeSafety::describe( violation ) );
+        DBG( text );
+        MyLogger::log( text );
+    } );
+}
@@ -0,0 +1,29 @@
+/*
+  ==============================================================================
+
+    RealtimeSafetyReporter.h
+    Created: 20 Oct 2026 4:38:22am
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/** Logs the violations RealtimeSafety has recorded, from the message thread, a few times per second. */
+class RealtimeSafetyReporter
+    : private juce::Timer
+{
+
+public:
+    RealtimeSafetyReporter();
+    ~RealtimeSafetyReporter() override;
+
+private:
+    void timerCallback() override;
+
+private:
+    JUCE_DECLARE_NON_COPYABLE( RealtimeSafetyReporter )
+};
@@ -0,0 +1,91 @@
+/*
+  ==============================================================================
+
+    RealtimeWorkerPool.h
+    Created: 20 Oct 2026 1:52:17am
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "DspCommon.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+/**
+ * A small fork/join pool for the audio thread. run() hands out the tasks of
+ * one job to the workers and the calling thread alike and returns once all
+ * of them are done; it neither allocates nor locks. The workers run at
+ * real-time priority where the OS grants it, are pinned to one core each
+ * where the OS supports that, and wait for the next job by spinning for a
+ * short while before they park on a semaphore, so that the wake-up syscall
+ * (a post, which doesn't take a lock) is only needed after a pause (e.g. at
+ * large block sizes). The tasks run as audio-thread code for RealtimeSafety.
+ *
+ * Constructing and destroying the pool starts and joins its threads, so
+ * both belong into prepareToPlay() and friends, not into the audio thread.
+ */
+class RealtimeWorkerPool
+{
+
+public:
+    using TaskFunc = void (*)(void* context, int task_index);
+
+    static const int MAX_TASKS = 0x7fff;
+
+public:
+    /** spin_microseconds is how long an idle worker waits for the next job before it parks. */
+    explicit RealtimeWorkerPool(int num_workers, int spin_microseconds = 200);
+    ~RealtimeWorkerPool();
+
+public:
+    int getNumWorkers() const { return static_cast<int>( _threads.size() ); }
+
+    /** How many workers actually got real-time priority; informational. */
+    int getNumRealtimeWorkers() const { return _num_realtime_workers.load(); }
+
+    /**
+     * Calls func( context, i ) for every i in [0; num_tasks), spread over the
+     * workers and the calling thread, and returns when all calls have returned.
+     * Not reentrant: one job at a time, from one thread.
+     */
+    void run(int num_tasks, TaskFunc func, void* context);
+
+private:
+    void _work(int worker_index);
+    bool _run_one_task(uint32_t generation);
+
+    static uint64_t _pack(uint32_t generation, uint32_t next_task, uint32_t num_tasks);
+
+private:
+    class _Semaphore;
+
+private:
+    std::vector<std::thread> _threads;
+    const int _spin_microseconds;
+
+    // The current job. The fields are written before the claim word is
+    // published, and only read by whoever has claimed one of its tasks.
+    TaskFunc _func;
+    void* _context;
+
+    // Generation (upper 32 bits), next task and number of tasks (16 bits each),
+    // claimed by compare-exchange, so a worker that wakes up late for a job
+    // that is already done can't claim a task of the next one.
+    std::atomic<uint64_t> _claim;
+    std::atomic<int> _num_remaining;
+
+    // Parked workers count themselves before they wait; run() takes the count and posts that often.
+    std::unique_ptr<_Semaphore> _wake;
+    std::atomic<int> _num_parked;
+    std::atomic<bool> _stopping;
+
+    std::atomic<int> _num_realtime_workers;
+
+    RealtimeWorkerPool(const RealtimeWorkerPool&) = delete;
+    RealtimeWorkerPool& operator=(const RealtimeWorkerPool&) = delete;
+};
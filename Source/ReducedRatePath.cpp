@@ -0,0 +1,236 @@
+/*
+  ==============================================================================
+
+    ReducedRatePath.cpp
+    Created: 19 Oct 2026 3:05:11pm
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#include "ReducedRatePath.h"
+
+// The odd taps of a Blackman-windowed half-band low-pass, normalized to
+// unity gain at DC (the centre tap is 0.5, all other even taps are zero).
+static const float* _get_half_band_coefficients()
+{
+    static const std::vector<float> coefficients = []() {
+        const int K = HalfBandDecimator::NUM_COEFFICIENTS;
+        const double L = static_cast<double>( HalfBandDecimator::HALF_LENGTH + 1 );
+        std::vector<float> c( K );
+        double sum = 0.0;
+        for ( int j = 0; j < K; ++j )
+        {
+            const double n = static_cast<double>( 2 * j + 1 );
+            const double sinc = ::sin( DSP_HALF_PI * n ) / (DSP_PI * n);
+            const double window = 0.42 + 0.5 * ::cos( DSP_PI * n / L ) + 0.08 * ::cos( DSP_TWO_PI * n / L );
+            c[j] = static_cast<float>( sinc * window );
+            sum += sinc * window;
+        }
+        for ( int j = 0; j < K; ++j )
+            c[j] = static_cast<float>( c[j] * 0.25 / sum );
+        return c;
+    }();
+
+    return coefficients.data();
+}
+
+//==============================================================================
+HalfBandDecimator::HalfBandDecimator()
+    : _phase( 0 )
+{
+    _get_half_band_coefficients();
+}
+
+void HalfBandDecimator::prepare(int max_input_size)
+{
+    _buffer.resize( static_cast<size_t>( HISTORY_SIZE + std::max( 1, max_input_size ) ) );
+    reset();
+}
+
+void HalfBandDecimator::reset()
+{
+    std::fill( _buffer.begin(), _buffer.end(), 0.0f );
+    _phase = 0;
+}
+
+int HalfBandDecimator::process(const float* in, int num_samples, float* out)
+{
+    assert( HISTORY_SIZE + num_samples <= static_cast<int>( _buffer.size() ) );
+
+    const float* c = _get_half_band_coefficients();
+    float* b = _buffer.data();
+    std::copy( in, in + num_samples, b + HISTORY_SIZE );
+
+    int num_out = 0;
+    int i = _phase;
+    for ( ; i < num_samples; i += 2 )
+    {
+        const float* centre = b + HISTORY_SIZE + i - HALF_LENGTH;
+        float y = 0.5f * centre[0];
+        for ( int j = 0; j < NUM_COEFFICIENTS; ++j )
+            y += c[j] * (centre[ -(2 * j + 1) ] + centre[ 2 * j + 1 ]);
+        out[ num_out++ ] = y;
+    }
+    _phase = i - num_samples;
+
+    std::copy( b + num_samples, b + num_samples + HISTORY_SIZE, b );
+
+    return num_out;
+}
+
+//==============================================================================
+HalfBandInterpolator::HalfBandInterpolator()
+{
+    _get_half_band_coefficients();
+}
+
+void HalfBandInterpolator::prepare(int max_input_size)
+{
+    _buffer.resize( static_cast<size_t>( HISTORY_SIZE + std::max( 1, max_input_size ) ) );
+    reset();
+}
+
+void HalfBandInterpolator::reset()
+{
+    std::fill( _buffer.begin(), _buffer.end(), 0.0f );
+}
+
+void HalfBandInterpolator::process(const float* in, int num_samples, float* out)
+{
+    assert( HISTORY_SIZE + num_samples <= static_cast<int>( _buffer.size() ) );
+
+    const int K = HalfBandDecimator::NUM_COEFFICIENTS;
+    const float* c = _get_half_band_coefficients();
+    float* b = _buffer.data();
+    std::copy( in, in + num_samples, b + HISTORY_SIZE );
+
+    // The even outputs pass the (delayed) input through, the odd ones are
+    // the zero-stuffed signal filtered by the odd taps (times 2).
+    for ( int i = 0; i < num_samples; ++i )
+    {
+        const float* centre = b + HISTORY_SIZE + i - K;
+        float y = 0.0f;
+        for ( int j = 0; j < K; ++j )
+            y += c[j] * (centre[ -j ] + centre[ j + 1 ]);
+        out[ 2 * i + 0 ] = centre[0];
+        out[ 2 * i + 1 ] = 2.0f * y;
+    }
+
+    std::copy( b + num_samples, b + num_samples + HISTORY_SIZE, b );
+}
+
+//==============================================================================
+ReducedRatePath::ReducedRatePath()
+    : _factor( 1 )
+    , _latency( 0 )
+{
+}
+
+int ReducedRatePath::getFactorFor(double sample_rate)
+{
+    const double MIN_RATE = 44100.0;
+
+    int factor = 1;
+    while ( sample_rate / (factor * 2) >= MIN_RATE )
+        factor *= 2;
+    return factor;
+}
+
+void ReducedRatePath::prepare(int factor, int max_block_size)
+{
+    assert( factor > 0 && (factor & (factor - 1)) == 0 );
+
+    int num_stages = 0;
+    while ( (1 << num_stages) < factor )
+        ++num_stages;
+
+    _factor = factor;
+
+    // Per stage, the decimator delays by HALF_LENGTH and the interpolator by
+    // 2 * NUM_COEFFICIENTS samples at that stage's higher rate.
+    _latency = (HalfBandDecimator::HALF_LENGTH + 2 * HalfBandDecimator::NUM_COEFFICIENTS) * (factor - 1);
+
+    const int max_size = std::max( 1, max_block_size ) + factor;
+
+    for ( Channel& ch : _channels )
+    {
+        ch.decimators.resize( static_cast<size_t>( num_stages ) );
+        ch.interpolators.resize( static_cast<size_t>( num_stages ) );
+        for ( int s = 0; s < num_stages; ++s )
+        {
+            ch.decimators[s].prepare( (max_size >> s) + 1 );
+            ch.interpolators[s].prepare( (max_size >> (s + 1)) + 1 );
+        }
+        for ( auto& scratch : ch.scratch )
+            scratch.resize( static_cast<size_t>( max_size ) );
+        ch.fifo.resize( static_cast<size_t>( 2 * max_size ) );
+    }
+
+    reset();
+}
+
+void ReducedRatePath::reset()
+{
+    for ( Channel& ch : _channels )
+    {
+        for ( auto& decimator : ch.decimators )
+            decimator.reset();
+        for ( auto& interpolator : ch.interpolators )
+            interpolator.reset();
+        ch.fifo_size = 0;
+    }
+}
+
+int ReducedRatePath::decimate(int channel, const float* in, int num_samples, float* out)
+{
+    Channel& ch = _channels[ channel ];
+
+    if ( ch.decimators.empty() )
+    {
+        std::copy( in, in + num_samples, out );
+        return num_samples;
+    }
+
+    // Ping-pong between the scratch buffers, with the last stage writing to out.
+    const float* src = in;
+    int n = num_samples;
+    for ( size_t s = 0; s < ch.decimators.size(); ++s )
+    {
+        float* dst = s + 1 == ch.decimators.size() ? out : ch.scratch[ s % 2 ].data();
+        n = ch.decimators[s].process( src, n, dst );
+        src = dst;
+    }
+    return n;
+}
+
+void ReducedRatePath::interpolate(int channel, const float* in, int num_in, float* out, int num_out)
+{
+    Channel& ch = _channels[ channel ];
+
+    if ( ch.interpolators.empty() )
+    {
+        assert( num_in == num_out );
+        std::copy( in, in + num_out, out );
+        return;
+    }
+
+    // From the lowest rate upwards, with the last stage appending to the FIFO
+    // (which makes up for the decimators' uneven output counts).
+    const float* src = in;
+    int n = num_in;
+    for ( size_t s = ch.interpolators.size(); s-- > 0; )
+    {
+        float* dst = s == 0 ? ch.fifo.data() + ch.fifo_size : ch.scratch[ s % 2 ].data();
+        ch.interpolators[s].process( src, n, dst );
+        n *= 2;
+        src = dst;
+    }
+    ch.fifo_size += n;
+
+    assert( ch.fifo_size >= num_out && ch.fifo_size <= static_cast<int>( ch.fifo.size() ) );
+    num_out = std::min( num_out, ch.fifo_size );
+    std::copy( ch.fifo.data(), ch.fifo.data() + num_out, out );
+    std::copy( ch.fifo.data() + num_out, ch.fifo.data() + ch.fifo_size, ch.fifo.data() );
+    ch.fifo_size -= num_out;
+}
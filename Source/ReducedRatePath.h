@@ -0,0 +1,112 @@
+/*
+  ==============================================================================
+
+    ReducedRatePath.h
+    Created: 19 Oct 2026 3:05:11pm
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "DspCommon.h"
+
+/**
+ * Polyphase half-band FIR decimator by 2. Only the non-zero taps are
+ * evaluated, and only for every other input sample.
+ */
+class HalfBandDecimator
+{
+
+public:
+    static const int NUM_COEFFICIENTS = 8; // non-zero taps on either side of the centre
+    static const int HALF_LENGTH = 2 * NUM_COEFFICIENTS - 1;
+    static const int HISTORY_SIZE = 2 * HALF_LENGTH;
+
+public:
+    HalfBandDecimator();
+
+public:
+    void prepare(int max_input_size);
+    void reset();
+
+    /** Returns the number of samples written to out (about half of num_samples). */
+    int process(const float* in, int num_samples, float* out);
+
+private:
+    std::vector<float> _buffer; // history followed by the current input
+    int _phase;
+
+};
+
+/**
+ * Polyphase half-band FIR interpolator by 2, the counterpart of
+ * HalfBandDecimator. Every input sample yields exactly two output samples.
+ */
+class HalfBandInterpolator
+{
+
+public:
+    static const int HISTORY_SIZE = 2 * HalfBandDecimator::NUM_COEFFICIENTS - 1;
+
+public:
+    HalfBandInterpolator();
+
+public:
+    void prepare(int max_input_size);
+    void reset();
+
+    /** Writes 2 * num_samples samples to out. */
+    void process(const float* in, int num_samples, float* out);
+
+private:
+    std::vector<float> _buffer; // history followed by the current input
+
+};
+
+/**
+ * Takes (up to two) channels down to the lowest rate of at least 44.1 kHz
+ * by a cascade of half-band decimators, and back up again by the matching
+ * interpolators. The round trip delays the signal by getLatency() samples.
+ */
+class ReducedRatePath
+{
+
+public:
+    static const int MAX_CHANNELS = 2;
+
+public:
+    ReducedRatePath();
+
+public:
+    /** Returns the power-of-two factor the given sample rate can be reduced by. */
+    static int getFactorFor(double sample_rate);
+
+    void prepare(int factor, int max_block_size);
+    void reset();
+
+    int getFactor() const { return _factor; }
+    int getLatency() const { return _latency; }
+
+    /** Decimates one channel and returns the number of reduced-rate samples written to out. */
+    int decimate(int channel, const float* in, int num_samples, float* out);
+
+    /** Interpolates one channel and writes exactly num_out full-rate samples to out. */
+    void interpolate(int channel, const float* in, int num_in, float* out, int num_out);
+
+private:
+    struct Channel
+    {
+        std::vector<HalfBandDecimator> decimators;
+        std::vector<HalfBandInterpolator> interpolators;
+        std::vector<float> scratch[2];
+        std::vector<float> fifo;
+        int fifo_size;
+    };
+
+    int _factor;
+    int _latency;
+    Channel _channels[MAX_CHANNELS];
+
+};
@@ -0,0 +1,232 @@
+/*
+  ==============================================================================
+
+    StandaloneSupport.cpp
+    Created: 20 Oct 2026 3:37:05am
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#include "StandaloneSupport.h"
+
+#include "MyLogger.h"
+
+#include <cstring>
+
+#if JUCE_LINUX
+ #include <cerrno>
+ #include <pthread.h>
+ #include <sched.h>
+ #include <sys/mman.h>
+#endif
+
+static const float _CLICK_LEVEL = 0.5f;
+static const float _CLICK_THRESHOLD = 0.1f;
+
+// A callback this much later than the last block's duration has missed its slot.
+static const double _LATE_FACTOR = 1.5;
+
+static juce::String _get_environment(const char* name)
+{
+    const char* value = std::getenv( name );
+    return value ? juce::String( value ) : juce::String();
+}
+
+//==============================================================================
+StandaloneSupport::Settings StandaloneSupport::Settings::fromEnvironment()
+{
+    const juce::String diagnostics = _get_environment( "DRECHO_DIAGNOSTICS" );
+
+    Settings settings;
+    settings.realtime_priority = juce::jlimit( 0, 99, _get_environment( "DRECHO_REALTIME_PRIORITY" ).getIntValue() );
+    settings.lock_memory = _get_environment( "DRECHO_LOCK_MEMORY" ).getIntValue() != 0;
+    settings.measure_latency = diagnostics == "latency";
+    settings.diagnostics = settings.measure_latency || diagnostics.getIntValue() != 0;
+    return settings;
+}
+
+//==============================================================================
+void StandaloneSupport::Histogram::add(double microseconds)
+{
+    ++_counts[ juce::jlimit( 0, NUM_BINS - 1, static_cast<int>( microseconds * 0.1 ) ) ];
+    ++_num_values;
+    _max = juce::jmax( _max, microseconds );
+    _sum += microseconds;
+}
+
+double StandaloneSupport::Histogram::getPercentile(double percentile) const
+{
+    const juce::int64 rank = static_cast<juce::int64>( percentile / 100.0 * static_cast<double>( _num_values ) );
+    juce::int64 count = 0;
+    for ( int i = 0; i < NUM_BINS - 1; ++i )
+    {
+        count += _counts[i];
+        if ( count > rank )
+            return (i + 1) * 10.0;
+    }
+    return _max;
+}
+
+juce::String StandaloneSupport::Histogram::describe() const
+{
+    if ( _num_values == 0 )
+        return "no blocks";
+    return juce::String::formatted( "mean %.0f us, median %.0f us, 99%% %.0f us, 99.9%% %.0f us, max %.0f us",
+                                    _sum / static_cast<double>( _num_values ), getPercentile( 50.0 ), getPercentile( 99.0 ), getPercentile( 99.9 ), _max );
+}
+
+//==============================================================================
+StandaloneSupport::StandaloneSupport(const Settings& settings)
+    : _settings( settings )
+    , _sample_rate( 44100.0 )
+    , _seconds_per_tick( 1.0 / static_cast<double>( juce::Time::getHighResolutionTicksPerSecond() ) )
+    , _memory_lock_attempted( false )
+    , _audio_thread_configured( false )
+    , _audio_thread_priority_error( 0 )
+    , _last_start_ticks( 0 )
+    , _last_num_samples( 0 )
+    , _num_late_callbacks( 0 )
+    , _sample_clock( 0 )
+    , _click_time( 0 )
+    , _click_pending( false )
+    , _num_round_trips( 0 )
+    , _num_lost_clicks( 0 )
+    , _min_round_trip( 0 )
+    , _max_round_trip( 0 )
+    , _sum_round_trip( 0 )
+{
+}
+
+void StandaloneSupport::prepare(double sample_rate)
+{
+    _sample_rate = sample_rate;
+
+    // A new device may come with a new audio thread; and the gap since the last callback isn't jitter.
+    _audio_thread_configured = false;
+    _last_start_ticks = 0;
+    _click_pending = false;
+
+    if ( _settings.lock_memory && !_memory_lock_attempted )
+    {
+        _memory_lock_attempted = true;
+       #if JUCE_LINUX
+        // Future allocations are locked too; RLIMIT_MEMLOCK (ulimit -l) has to allow for them.
+        if ( ::mlockall( MCL_CURRENT | MCL_FUTURE ) == 0 )
+            _memory_lock_result = "memory locked";
+        else
+            _memory_lock_result = juce::String( "mlockall() failed: " ) + std::strerror( errno );
+       #else
+        _memory_lock_result = "memory locking is only supported on Linux";
+       #endif
+        MyLogger::log( "Standalone: " + _memory_lock_result );
+    }
+}
+
+void StandaloneSupport::beginBlock(juce::int64 start_ticks, int num_samples)
+{
+    // Done from the audio thread itself, since the device owns the thread.
+    if ( !_audio_thread_configured.exchange( true, std::memory_order_relaxed ) && _settings.realtime_priority > 0 )
+    {
+       #if JUCE_LINUX
+        sched_param parameters = {};
+        parameters.sched_priority = _settings.realtime_priority;
+        _audio_thread_priority_error = pthread_setschedparam( pthread_self(), SCHED_FIFO, &parameters );
+       #else
+        _audio_thread_priority_error = -1;
+       #endif
+    }
+
+    if ( _settings.diagnostics && _last_start_ticks != 0 && _last_num_samples > 0 )
+    {
+        const double interval = static_cast<double>( start_ticks - _last_start_ticks ) * _seconds_per_tick;
+        const double expected = _last_num_samples / _sample_rate;
+        _jitter.add( std::abs( interval - expected ) * 1.0e6 );
+        if ( interval > _LATE_FACTOR * expected )
+            ++_num_late_callbacks;
+    }
+    _last_start_ticks = start_ticks;
+    _last_num_samples = num_samples;
+}
+
+void StandaloneSupport::endBlock(juce::int64 start_ticks)
+{
+    if ( _settings.diagnostics )
+        _duration.add( static_cast<double>( juce::Time::getHighResolutionTicks() - start_ticks ) * _seconds_per_tick * 1.0e6 );
+}
+
+void StandaloneSupport::measureLatency(juce::AudioBuffer<float>& buffer, int num_input_channels)
+{
+    const int num_samples = buffer.getNumSamples();
+
+    if ( _click_pending && num_input_channels > 0 )
+    {
+        const float* input = buffer.getReadPointer( 0 );
+        for ( int i = 0; i < num_samples; ++i )
+        {
+            if ( std::abs( input[i] ) >= _CLICK_THRESHOLD )
+            {
+                const juce::int64 round_trip = _sample_clock + i - _click_time;
+                _min_round_trip = _num_round_trips == 0 ? round_trip : juce::jmin( _min_round_trip, round_trip );
+                _max_round_trip = juce::jmax( _max_round_trip, round_trip );
+                _sum_round_trip += round_trip;
+                ++_num_round_trips;
+                _click_pending = false;
+                break;
+            }
+        }
+
+        // Not back within a second: nothing is connected, or the click got lost.
+        if ( _click_pending && _sample_clock + num_samples - _click_time >= static_cast<juce::int64>( _sample_rate ) )
+        {
+            ++_num_lost_clicks;
+            _click_pending = false;
+        }
+    }
+
+    buffer.clear();
+    if ( !_click_pending && _sample_clock - _click_time >= static_cast<juce::int64>( _sample_rate ) && num_samples > 0 )
+    {
+        for ( int c = 0; c < buffer.getNumChannels(); ++c )
+            buffer.setSample( c, 0, _CLICK_LEVEL );
+        _click_time = _sample_clock;
+        _click_pending = true;
+    }
+    _sample_clock += num_samples;
+}
+
+void StandaloneSupport::printReport() const
+{
+    if ( !_settings.diagnostics )
+        return;
+
+    juce::String report;
+    report << "Dr.Echo standalone diagnostics\n";
+    if ( _settings.realtime_priority > 0 )
+    {
+        const int error = _audio_thread_priority_error.load();
+        report << "  audio thread priority " << _settings.realtime_priority << ": "
+               << (error == 0 ? juce::String( "set" ) : error < 0 ? juce::String( "only supported on Linux" ) : juce::String( "failed: " ) + std::strerror( error )) << "\n";
+    }
+    if ( _settings.lock_memory )
+        report << "  " << _memory_lock_result << "\n";
+    report << "  callback interval jitter: " << _jitter.describe() << "\n"
+           << "  late callbacks (more than " << _LATE_FACTOR << " blocks apart): " << _num_late_callbacks << "\n"
+           << "  processBlock duration: " << _duration.describe() << "\n";
+    if ( _settings.measure_latency )
+    {
+        if ( _num_round_trips > 0 )
+            report << juce::String::formatted( "  round trip: %lld clicks, min %lld, mean %.1f, max %lld samples (%.2f ms mean at %.0f Hz), %lld lost\n",
+                                               static_cast<long long>( _num_round_trips ), static_cast<long long>( _min_round_trip ),
+                                               static_cast<double>( _sum_round_trip ) / static_cast<double>( _num_round_trips ),
+                                               static_cast<long long>( _max_round_trip ),
+                                               1000.0 * static_cast<double>( _sum_round_trip ) / static_cast<double>( _num_round_trips ) / _sample_rate, _sample_rate,
+                                               static_cast<long long>( _num_lost_clicks ) );
+        else
+            report << "  round trip: no click came back (" << _num_lost_clicks << " lost); is the first output connected to the first input?\n";
+    }
+
+    std::fputs( report.toRawUTF8(), stdout );
+    std::fflush( stdout );
+    MyLogger::log( report );
+}
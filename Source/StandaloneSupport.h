@@ -0,0 +1,113 @@
+/*
+  ==============================================================================
+
+    StandaloneSupport.h
+    Created: 20 Oct 2026 3:37:05am
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+ * What the standalone build needs to run as a live effects box: the
+ * real-time priority of the audio callback thread and locked memory
+ * (Linux), and a diagnostics mode that records the jitter of the callback
+ * intervals and the processBlock() durations and prints them on exit. A
+ * latency mode replaces the echo with a click per second on the outputs and
+ * measures how long the click takes to come back on the first input, i.e.
+ * the round trip through a loopback cable or a JACK connection.
+ *
+ * The settings come from the environment, see Settings::fromEnvironment().
+ * The audio thread only writes into preallocated histograms.
+ */
+class StandaloneSupport
+{
+
+public:
+    struct Settings
+    {
+        int realtime_priority;      // SCHED_FIFO priority of the audio thread, 1 to 99; 0 leaves it as the audio driver set it
+        bool lock_memory;           // mlockall(), so that no page of the process is swapped out
+        bool diagnostics;
+        bool measure_latency;
+
+        /**
+         * DRECHO_REALTIME_PRIORITY=<1..99>, DRECHO_LOCK_MEMORY=1 and
+         * DRECHO_DIAGNOSTICS=1 (or =latency for the round-trip measurement).
+         */
+        static Settings fromEnvironment();
+
+        bool isActive() const { return realtime_priority > 0 || lock_memory || diagnostics || measure_latency; }
+    };
+
+public:
+    explicit StandaloneSupport(const Settings& settings);
+
+public:
+    /** Locks the memory (once) and restarts the interval measurement; from prepareToPlay(). */
+    void prepare(double sample_rate);
+
+    /** At the start of each processBlock(), on the audio thread. */
+    void beginBlock(juce::int64 start_ticks, int num_samples);
+
+    /** At the end of each processBlock(), on the audio thread. */
+    void endBlock(juce::int64 start_ticks);
+
+    bool isMeasuringLatency() const { return _settings.measure_latency; }
+
+    /** Looks for the last click on the first input and replaces the outputs with silence and the next click. */
+    void measureLatency(juce::AudioBuffer<float>& buffer, int num_input_channels);
+
+    /** Prints the report to stdout and the log, if diagnostics are on. */
+    void printReport() const;
+
+private:
+    /** Microseconds in bins of 10, up to 20 ms; longer ones in the last bin. */
+    class Histogram
+    {
+    public:
+        static const int NUM_BINS = 2000;
+
+        void add(double microseconds);
+        double getPercentile(double percentile) const;
+        juce::String describe() const;
+
+    private:
+        juce::int64 _counts[NUM_BINS] = {};
+        juce::int64 _num_values = 0;
+        double _max = 0.0;
+        double _sum = 0.0;
+    };
+
+private:
+    const Settings _settings;
+
+    double _sample_rate;
+    double _seconds_per_tick;
+    bool _memory_lock_attempted;
+    juce::String _memory_lock_result;
+
+    std::atomic<bool> _audio_thread_configured;
+    std::atomic<int> _audio_thread_priority_error;     // 0 if the priority was set, else errno
+
+    // Written by the audio thread only, read when it has stopped.
+    juce::int64 _last_start_ticks;
+    int _last_num_samples;
+    Histogram _jitter;
+    Histogram _duration;
+    juce::int64 _num_late_callbacks;
+
+    juce::int64 _sample_clock;
+    juce::int64 _click_time;
+    bool _click_pending;
+    juce::int64 _num_round_trips;
+    juce::int64 _num_lost_clicks;
+    juce::int64 _min_round_trip;
+    juce::int64 _max_round_trip;
+    juce::int64 _sum_round_trip;
+
+};
@@ -0,0 +1,149 @@
+/*
+  ==============================================================================
+
+    Telemetry.cpp
+    Created: 19 Oct 2026 7:20:33pm
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#include "Telemetry.h"
+
+#include "MyLogger.h"
+
+#if JUCE_WINDOWS
+ #include <process.h>
+#else
+ #include <unistd.h>
+#endif
+
+static juce::uint32 _get_process_id()
+{
+   #if JUCE_WINDOWS
+    return static_cast<juce::uint32>( ::_getpid() );
+   #else
+    return static_cast<juce::uint32>( ::getpid() );
+   #endif
+}
+
+static juce::File _get_telemetry_directory()
+{
+   #if JUCE_WINDOWS
+    return juce::File::getSpecialLocation( juce::File::tempDirectory ).getChildFile( "DrEcho-telemetry" );
+   #else
+    return juce::File( DRECHO_TELEMETRY_DIRECTORY );
+   #endif
+}
+
+//==============================================================================
+TelemetryMapping::TelemetryMapping()
+    : _page( nullptr )
+{
+    const juce::uint32 process_id = _get_process_id();
+    _file = _get_telemetry_directory().getChildFile( juce::String( process_id ) + ".page" );
+
+    // The file is written out in full first, so that the audio thread never
+    // touches a page that isn't backed yet.
+    if ( !_file.getParentDirectory().createDirectory() )
+        return;
+    {
+        juce::HeapBlock<char> zeros( sizeof( TelemetryPage ), true );
+        if ( !_file.replaceWithData( zeros.get(), sizeof( TelemetryPage ) ) )
+            return;
+    }
+
+    _mapped_file = std::make_unique<juce::MemoryMappedFile>( _file, juce::MemoryMappedFile::readWrite, false );
+    if ( _mapped_file->getData() == nullptr || _mapped_file->getSize() < sizeof( TelemetryPage ) )
+    {
+        MyLogger::log( "Could not map the telemetry page " + _file.getFullPathName() );
+        _mapped_file.reset();
+        _file.deleteFile();
+        return;
+    }
+
+    _page = static_cast<TelemetryPage*>( _mapped_file->getData() );
+    _page->version = TELEMETRY_VERSION;
+    _page->process_id = process_id;
+    _page->num_slots = TELEMETRY_MAX_SLOTS;
+    _page->magic.store( TELEMETRY_MAGIC, std::memory_order_release );
+}
+
+TelemetryMapping::~TelemetryMapping()
+{
+    _page = nullptr;
+    _mapped_file.reset();
+    _file.deleteFile();
+}
+
+//==============================================================================
+Telemetry::Telemetry()
+    : _slot( nullptr )
+{
+    static std::atomic<juce::uint32> next_instance_id( 1 );
+
+    TelemetryPage* page = _mapping->getPage();
+    if ( !page )
+        return;
+
+    for ( TelemetrySlot& slot : page->slots )
+    {
+        juce::uint32 expected = 0;
+        if ( slot.in_use.compare_exchange_strong( expected, 1 ) )
+        {
+            _slot = &slot;
+            break;
+        }
+    }
+    if ( !_slot )
+        return;
+
+    _slot->instance_id.store( next_instance_id++, std::memory_order_relaxed );
+    _slot->sample_rate.store( 0, std::memory_order_relaxed );
+    _slot->delay_samples.store( 0, std::memory_order_relaxed );
+    _slot->num_blocks.store( 0, std::memory_order_relaxed );
+    _slot->num_overruns.store( 0, std::memory_order_relaxed );
+    _slot->tail_active.store( 0, std::memory_order_relaxed );
+    _slot->load.store( 0.0f, std::memory_order_relaxed );
+    _slot->peak_wet.store( 0.0f, std::memory_order_relaxed );
+    _slot->buffer_bytes.store( 0, std::memory_order_relaxed );
+    for ( auto& count : _slot->load_histogram )
+        count.store( 0, std::memory_order_relaxed );
+}
+
+Telemetry::~Telemetry()
+{
+    if ( _slot )
+        _slot->in_use.store( 0 );
+}
+
+void Telemetry::publishConfiguration(double sample_rate, juce::uint64 buffer_bytes)
+{
+    if ( !_slot )
+        return;
+
+    _slot->sample_rate.store( static_cast<juce::uint32>( sample_rate ), std::memory_order_relaxed );
+    _slot->buffer_bytes.store( buffer_bytes, std::memory_order_relaxed );
+}
+
+void Telemetry::publishBlock(float load, juce::uint32 num_overruns, juce::uint32 delay_samples, float peak_wet)
+{
+    // About -90 dB; anything below that is considered silence.
+    const float TAIL_THRESHOLD = 3.0e-5f;
+
+    if ( !_slot )
+        return;
+
+    // Only the audio thread of this instance writes to the slot, so plain
+    // load/store pairs will do instead of read-modify-write operations.
+    const int bucket = juce::jlimit( 0, TELEMETRY_NUM_LOAD_BUCKETS - 1, static_cast<int>( load * (TELEMETRY_NUM_LOAD_BUCKETS - 1) ) );
+    std::atomic<juce::uint32>& count = _slot->load_histogram[ bucket ];
+    count.store( count.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+    _slot->num_blocks.store( _slot->num_blocks.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+
+    _slot->num_overruns.store( num_overruns, std::memory_order_relaxed );
+    _slot->delay_samples.store( delay_samples, std::memory_order_relaxed );
+    _slot->load.store( load, std::memory_order_relaxed );
+    _slot->peak_wet.store( peak_wet, std::memory_order_relaxed );
+    _slot->tail_active.store( peak_wet > TAIL_THRESHOLD ? 1 : 0, std::memory_order_relaxed );
+}
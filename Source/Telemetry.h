@@ -0,0 +1,64 @@
+/*
+  ==============================================================================
+
+    Telemetry.h
+    Created: 19 Oct 2026 7:20:33pm
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "TelemetryLayout.h"
+
+/**
+ * The per-process telemetry page: a small memory-mapped file in
+ * DRECHO_TELEMETRY_DIRECTORY (or the temp directory on Windows), which is
+ * shared by all instances of the process and removed with the last of them.
+ */
+class TelemetryMapping
+{
+
+public:
+    TelemetryMapping();
+    ~TelemetryMapping();
+
+public:
+    /** Returns nullptr if the page couldn't be set up. */
+    TelemetryPage* getPage() const { return _page; }
+
+private:
+    juce::File _file;
+    std::unique_ptr<juce::MemoryMappedFile> _mapped_file;
+    TelemetryPage* _page;
+
+};
+
+/**
+ * Publishes the counters of one processor instance to a slot of the
+ * telemetry page, where a monitor process can pick them up without
+ * opening any editor. Publishing only does relaxed atomic stores into the
+ * mapped memory, no system calls, so it is safe in the audio thread.
+ */
+class Telemetry
+{
+
+public:
+    Telemetry();
+    ~Telemetry();
+
+public:
+    /** Called whenever the processor is (re-)prepared. */
+    void publishConfiguration(double sample_rate, juce::uint64 buffer_bytes);
+
+    /** Called at the end of each block, with the load of that block as a fraction of its real-time budget. */
+    void publishBlock(float load, juce::uint32 num_overruns, juce::uint32 delay_samples, float peak_wet);
+
+private:
+    juce::SharedResourcePointer<TelemetryMapping> _mapping;
+    TelemetrySlot* _slot;
+
+};
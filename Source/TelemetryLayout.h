@@ -0,0 +1,59 @@
+/*
+  ==============================================================================
+
+    TelemetryLayout.h
+    Created: 19 Oct 2026 7:20:33pm
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+// The layout of the per-process telemetry page, shared between the plug-in
+// and the telemetry monitor. Deliberately free of JUCE, so that the monitor
+// builds on its own.
+
+#include <atomic>
+#include <cstdint>
+
+static const uint32_t TELEMETRY_MAGIC = 0x43455244; // "DREC"
+static const uint32_t TELEMETRY_VERSION = 1;
+
+static const int TELEMETRY_MAX_SLOTS = 64;          // instances per process
+static const int TELEMETRY_NUM_LOAD_BUCKETS = 21;   // 5 % steps, the last one for overruns
+
+// Where the pages live, one file per process (named after the process id).
+#if defined( __linux__ )
+ #define DRECHO_TELEMETRY_DIRECTORY "/dev/shm/DrEcho-telemetry"
+#else
+ #define DRECHO_TELEMETRY_DIRECTORY "/tmp/DrEcho-telemetry"
+#endif
+
+/** The counters of one processor instance. Written by its audio thread with relaxed stores only. */
+struct TelemetrySlot
+{
+    std::atomic<uint32_t> in_use;
+    std::atomic<uint32_t> instance_id;
+    std::atomic<uint32_t> sample_rate;
+    std::atomic<uint32_t> delay_samples;
+    std::atomic<uint64_t> num_blocks;
+    std::atomic<uint32_t> num_overruns;
+    std::atomic<uint32_t> tail_active;
+    std::atomic<float> load;
+    std::atomic<float> peak_wet;
+    std::atomic<uint64_t> buffer_bytes;
+    std::atomic<uint32_t> load_histogram[TELEMETRY_NUM_LOAD_BUCKETS];
+};
+
+struct TelemetryPage
+{
+    std::atomic<uint32_t> magic; // written last, once the page is set up
+    uint32_t version;
+    uint32_t process_id;
+    uint32_t num_slots;
+    TelemetrySlot slots[TELEMETRY_MAX_SLOTS];
+};
+
+static_assert( ATOMIC_INT_LOCK_FREE == 2 && ATOMIC_LLONG_LOCK_FREE == 2,
+               "The telemetry page is shared between processes, so its atomics must not need locks." );
@@ -0,0 +1,50 @@
+/*
+  ==============================================================================
+
+    TempoSync.cpp
+    Created: 19 Oct 2026 11:31:42pm
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#include "TempoSync.h"
+
+TempoSync::TempoSync()
+    : _sample_rate( 44100.0 )
+    , _samples_per_millisecond( 44.1f )
+    , _bpm( 0.0 )
+    , _samples_per_sixteenth( 0.0f )
+{
+}
+
+void TempoSync::prepare(double sample_rate)
+{
+    _sample_rate = sample_rate;
+    _samples_per_millisecond = static_cast<float>( sample_rate * 0.001 );
+    _bpm = 0.0; // recompute on the next call
+}
+
+float TempoSync::getDelayInSamples(float sixteenths, Division division, float milliseconds, double bpm)
+{
+    if ( bpm <= 0.0 )
+        return milliseconds * _samples_per_millisecond;
+
+    if ( bpm != _bpm )
+    {
+        _bpm = bpm;
+        _samples_per_sixteenth = static_cast<float>( _sample_rate * 15.0 / bpm ); // 60 seconds per minute / 4 sixteenths per beat
+    }
+    return sixteenths * getDivisionFactor( division ) * _samples_per_sixteenth;
+}
+
+float TempoSync::getDivisionFactor(Division division)
+{
+    switch ( division )
+    {
+    case Division::Straight:    return 1.0f;
+    case Division::Dotted:      return 1.5f;
+    case Division::Triplet:     return 2.0f / 3.0f;
+    }
+    return 1.0f;
+}
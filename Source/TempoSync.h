@@ -0,0 +1,55 @@
+/*
+  ==============================================================================
+
+    TempoSync.h
+    Created: 19 Oct 2026 11:31:42pm
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "DspCommon.h"
+
+/**
+ * Converts the delay setting into samples: note divisions (straight, dotted
+ * or triplet 1/16ths) at the host's tempo, or milliseconds when the delay is
+ * not synced or there is no tempo to sync to. The samples per 1/16th are
+ * cached and only recomputed when the tempo or the sample rate changes.
+ */
+class TempoSync
+{
+
+public:
+    enum class Division
+    {
+        Straight,
+        Dotted,     // 3/2 as long
+        Triplet,    // 2/3 as long
+    };
+
+    static const int NUM_DIVISIONS = 3;
+
+public:
+    TempoSync();
+
+public:
+    void prepare(double sample_rate);
+
+    /**
+     * Returns the delay in samples for the given setting. A tempo of zero (or
+     * less) means that there is none, and the delay runs free in milliseconds.
+     */
+    float getDelayInSamples(float sixteenths, Division division, float milliseconds, double bpm);
+
+    static float getDivisionFactor(Division division);
+
+private:
+    double _sample_rate;
+    float _samples_per_millisecond;
+
+    double _bpm;
+    float _samples_per_sixteenth;
+
+};
@@ -0,0 +1,199 @@
+/*
+  ==============================================================================
+
+    TraceEvents.cpp
+    Created: 19 Oct 2026 6:41:09pm
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#include "TraceEvents.h"
+
+#include "RealtimeSafety.h"
+
+#if DRECHO_TRACING
+
+static const int MAX_THREADS = 16;
+static const int EVENTS_PER_THREAD = 16384;
+
+struct _Event
+{
+    const char* name;
+    juce::int64 start_ticks;
+    juce::int64 end_ticks;
+};
+
+enum _BufferState
+{
+    _FREE,
+    _OWNED,
+    _RELEASED,  // by a thread that has exited; its events are kept until another thread takes it over
+};
+
+struct _ThreadBuffer
+{
+    std::atomic<int> state;
+    std::atomic<juce::int64> thread_id;
+    std::atomic<bool> is_message_thread;
+    std::atomic<juce::uint32> num_written; // only ever written by the owning thread
+    _Event events[EVENTS_PER_THREAD];
+};
+
+static _ThreadBuffer _thread_buffers[MAX_THREADS];
+
+static thread_local _ThreadBuffer* _thread_buffer = nullptr;
+
+// Gives the thread's buffer back when the thread exits, so that hosts that
+// recreate their audio threads, and the worker pool on every prepare, don't
+// use the pool up.
+struct _ThreadBufferRelease
+{
+    _ThreadBuffer* buffer = nullptr;
+
+    ~_ThreadBufferRelease()
+    {
+        if ( buffer )
+            buffer->state.store( _RELEASED, std::memory_order_release );
+    }
+};
+
+static thread_local _ThreadBufferRelease _thread_buffer_release;
+
+static bool _claim(_ThreadBuffer& buffer, int from_state)
+{
+    int expected = from_state;
+    return buffer.state.compare_exchange_strong( expected, _OWNED, std::memory_order_acquire );
+}
+
+// Claims a buffer from the pool on the first event of a thread: one that has
+// never been used, or else the one of a thread that has exited. While all of
+// them belong to running threads, further threads don't record anything.
+static _ThreadBuffer* _get_thread_buffer()
+{
+    if ( _thread_buffer )
+        return _thread_buffer;
+
+    _ThreadBuffer* buffer = nullptr;
+    for ( int from_state : { _FREE, _RELEASED } )
+    {
+        for ( int i = 0; i < MAX_THREADS && !buffer; ++i )
+            if ( _claim( _thread_buffers[i], from_state ) )
+                buffer = &_thread_buffers[i];
+        if ( buffer )
+            break;
+    }
+    if ( !buffer )
+        return nullptr;
+
+    buffer->num_written.store( 0, std::memory_order_relaxed );
+    buffer->thread_id.store( static_cast<juce::int64>( reinterpret_cast<juce::pointer_sized_int>( juce::Thread::getCurrentThreadId() ) ), std::memory_order_relaxed );
+    buffer->is_message_thread.store( juce::MessageManager::existsAndIsCurrentThread(), std::memory_order_relaxed );
+    _thread_buffer = buffer;
+    {
+        // Registering the thread-exit destructor may allocate once, depending on the C++ runtime.
+        const RealtimeSafety::ScopedAllow allow;
+        _thread_buffer_release.buffer = buffer;
+    }
+    return buffer;
+}
+
+void TraceEvents::record(const char* name, juce::int64 start_ticks, juce::int64 end_ticks)
+{
+    _ThreadBuffer* buffer = _get_thread_buffer();
+    if ( !buffer )
+        return;
+
+    const juce::uint32 n = buffer->num_written.load( std::memory_order_relaxed );
+    _Event& event = buffer->events[ n % EVENTS_PER_THREAD ];
+    event.name = name;
+    event.start_ticks = start_ticks;
+    event.end_ticks = end_ticks;
+    buffer->num_written.store( n + 1, std::memory_order_release );
+}
+
+juce::String TraceEvents::toJson()
+{
+    struct ThreadEvents
+    {
+        int tid;
+        const _ThreadBuffer* buffer;
+        std::vector<_Event> events;
+    };
+
+    // The threads keep on recording while their buffers are copied, so
+    // whatever may have been overwritten in the meantime is dropped again.
+    std::vector<ThreadEvents> threads;
+    juce::int64 origin_ticks = std::numeric_limits<juce::int64>::max();
+    for ( int i = 0; i < MAX_THREADS; ++i )
+    {
+        const _ThreadBuffer& buffer = _thread_buffers[i];
+        if ( buffer.state.load( std::memory_order_acquire ) == _FREE )
+            continue;
+        const juce::uint32 end = buffer.num_written.load( std::memory_order_acquire );
+        if ( end == 0 )
+            continue;
+        const juce::uint32 begin = end > EVENTS_PER_THREAD ? end - EVENTS_PER_THREAD : 0;
+
+        ThreadEvents thread { i + 1, &buffer, {} };
+        thread.events.reserve( end - begin );
+        for ( juce::uint32 n = begin; n < end; ++n )
+            thread.events.push_back( buffer.events[ n % EVENTS_PER_THREAD ] );
+
+        const juce::uint32 end_after_copy = buffer.num_written.load( std::memory_order_acquire );
+        const juce::uint32 num_overwritten = end_after_copy - begin > EVENTS_PER_THREAD ? end_after_copy - begin - EVENTS_PER_THREAD : 0;
+        thread.events.erase( thread.events.begin(), thread.events.begin() + juce::jmin<size_t>( num_overwritten, thread.events.size() ) );
+
+        for ( const _Event& event : thread.events )
+            origin_ticks = juce::jmin( origin_ticks, event.start_ticks );
+        threads.push_back( std::move( thread ) );
+    }
+
+    const double microseconds_per_tick = 1.0e6 / static_cast<double>( juce::Time::getHighResolutionTicksPerSecond() );
+
+    juce::MemoryOutputStream json;
+    json << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for ( const ThreadEvents& thread : threads )
+    {
+        const juce::String thread_name = thread.buffer->is_message_thread.load( std::memory_order_relaxed ) ? juce::String( "Message thread" )
+                                                                                                              : "Thread " + juce::String( thread.buffer->thread_id.load( std::memory_order_relaxed ) );
+        json << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread.tid
+             << ",\"args\":{\"name\":\"" << thread_name << "\"}}";
+        first = false;
+
+        for ( const _Event& event : thread.events )
+        {
+            const double ts = static_cast<double>( event.start_ticks - origin_ticks ) * microseconds_per_tick;
+            const double dur = static_cast<double>( event.end_ticks - event.start_ticks ) * microseconds_per_tick;
+            json << ",\n{\"name\":\"" << event.name << "\",\"cat\":\"DrEcho\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread.tid
+                 << ",\"ts\":" << juce::String( ts, 3 ) << ",\"dur\":" << juce::String( dur, 3 ) << "}";
+        }
+    }
+    json << "\n]}\n";
+
+    return json.toString();
+}
+
+bool TraceEvents::exportTo(const juce::File& file)
+{
+    return file.replaceWithText( toJson() );
+}
+
+#else
+
+void TraceEvents::record(const char*, juce::int64, juce::int64)
+{
+}
+
+juce::String TraceEvents::toJson()
+{
+    return {};
+}
+
+bool TraceEvents::exportTo(const juce::File&)
+{
+    return false;
+}
+
+#endif
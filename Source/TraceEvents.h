@@ -0,0 +1,75 @@
+/*
+  ==============================================================================
+
+    TraceEvents.h
+    Created: 19 Oct 2026 6:41:09pm
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Define DRECHO_TRACING=1 to record trace events. With 0, the
+// DRECHO_TRACE_SCOPE markers compile to nothing.
+#ifndef DRECHO_TRACING
+ #define DRECHO_TRACING 0
+#endif
+
+/**
+ * Lightweight trace events for correlating audio-thread spikes with GUI
+ * repaints and state loads on one timeline. Each thread writes into a buffer
+ * of its own (from a fixed pool, so recording never locks, and only the first
+ * event of a thread may allocate, once, to register the exit hook that gives
+ * the buffer back), which keeps the most recent events. toJson()
+ * exports them in the Chrome trace event format, which both chrome://tracing
+ * and ui.perfetto.dev open.
+ */
+class TraceEvents
+{
+
+public:
+    /** Records the time from its construction to its destruction as one event. The name must be a string literal. */
+    class Scope
+    {
+    public:
+        explicit Scope(const char* name)
+            : _name( name )
+            , _start_ticks( juce::Time::getHighResolutionTicks() )
+        {
+        }
+
+        ~Scope()
+        {
+            TraceEvents::record( _name, _start_ticks, juce::Time::getHighResolutionTicks() );
+        }
+
+    private:
+        const char* _name;
+        juce::int64 _start_ticks;
+
+        JUCE_DECLARE_NON_COPYABLE( Scope )
+    };
+
+public:
+    /** Whether the events are compiled in at all. */
+    static constexpr bool isEnabled() { return DRECHO_TRACING != 0; }
+
+    /** Records one complete event of the current thread. Real-time safe. */
+    static void record(const char* name, juce::int64 start_ticks, juce::int64 end_ticks);
+
+    /** Returns the recorded events of all threads as a Chrome trace event JSON document. Not real-time safe. */
+    static juce::String toJson();
+
+    /** Writes toJson() to the given file. */
+    static bool exportTo(const juce::File& file);
+
+};
+
+#if DRECHO_TRACING
+ #define DRECHO_TRACE_SCOPE(name) const TraceEvents::Scope JUCE_JOIN_MACRO( _trace_scope_, __LINE__ )( name )
+#else
+ #define DRECHO_TRACE_SCOPE(name)
+#endif
@@ -0,0 +1,153 @@
+/*
+  ==============================================================================
+
+    BaselineEcho.h
+    Created: 20 Oct 2026 4:31:07am
+    Author:  Stefan
+
+    The echo as the first release computed it: the per-sample loop of
+    DrEchoAudioProcessor::prepareToPlay/processBlock before the DSP moved
+    into kernels and DrEchoEngine, copied verbatim, with the few JUCE
+    helpers it used replaced by their definitions. It only knows the
+    parameters of that release: gain, pan, delay, ping-pong, feedback, dry
+    and wet.
+
+    This is the frozen reference of GoldenRender.cpp. Never change it along
+    with the engine; a difference between the two is what the golden check
+    is there to find.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+class BaselineEcho
+{
+
+public:
+    struct Parameters
+    {
+        float gain = 0.0f;      // dB
+        int pan = 0;            // [-45; +45]
+        float delay = 2.0f;     // 1/16th notes
+        int pingpong = 50;      // percent
+        int feedback = 0;       // percent
+        int dry = 100;          // percent
+        int wet = 50;           // percent
+    };
+
+public:
+    void prepareToPlay(double sampleRate, int samplesPerBlock)
+    {
+        _sample_rate = static_cast<float>( sampleRate );
+        _samples_per_block = samplesPerBlock;
+
+        const double MAX_SECONDS = 1.0;
+
+        _buffer_index = 0;
+        _buffer_size = static_cast<size_t>( ::ceil( _sample_rate * MAX_SECONDS ) );
+        for ( int i = 0; i < 2; ++i )
+            _sample_buffers[i].resize( _buffer_size );
+    }
+
+    /** One host block of one or two channels, in place. */
+    void processBlock(float* const* channels, int totalNumInputChannels, int numSamples, const Parameters& parameters, double host_bpm)
+    {
+        const float bpm = static_cast<float>( host_bpm );
+        const float bps = bpm * (1.0f/60.0f);
+
+        const float gain = _decibels_to_gain( static_cast<float>( parameters.gain ) ); // float dB to float gain
+        const float pan = parameters.pan / 45.0f; // integer [-45; +45] to float [-1; +1]
+
+        const float delay = parameters.delay * (1.0f/16.0f) * 4.0f / bps; // float 1/64th to float seconds
+
+        const float pingpong = parameters.pingpong * 0.01f; // integer percentage to float
+        const float feedback = parameters.feedback * 0.01f; // integer percentage to float
+
+        const float dry = parameters.dry * 0.01f; // integer percentage to float
+        const float wet = parameters.wet * 0.01f; // integer percentage to float
+
+        const size_t num_delayed_samples = static_cast<size_t>( _sample_rate * delay );
+
+        const float cs0 = ::cosf( 0.25f * _float_Pi * (1.0f + pan) );
+        const float cs1 = ::cosf( 0.25f * _float_Pi * (1.0f - pan) );
+
+        struct SampleInfo
+        {
+            float dry_sample;
+            float input_sample;
+            float wet_sample;
+        } channel_sample_info[2];
+
+        for ( int block_index = 0; block_index < numSamples; ++block_index )
+        {
+            const auto current_index = _buffer_index;
+            const auto delayed_index = (_buffer_index + _buffer_size - num_delayed_samples) % _buffer_size;
+
+            for ( int channel = 0; channel < totalNumInputChannels; ++channel )
+            {
+                SampleInfo& si = channel_sample_info[ channel ];
+                si.dry_sample = channels[ channel ][ block_index ];
+            } // for channel
+
+            SampleInfo& si0 = channel_sample_info[ 0 ];
+            SampleInfo& si1 = channel_sample_info[ 1 ];
+            if ( totalNumInputChannels == 2 )
+            {
+                const float M = 0.5f * (si0.dry_sample + si1.dry_sample);
+                const float S = si0.dry_sample - si1.dry_sample;
+                si0.input_sample = cs0 * M + S;
+                si1.input_sample = cs1 * M - S;
+            }
+            else
+            {
+                si0.input_sample = si0.dry_sample;
+            }
+
+            for ( int channel = 0; channel < totalNumInputChannels; ++channel )
+            {
+                SampleInfo& si = channel_sample_info[ channel ];
+                si.input_sample *= gain;
+                si.wet_sample = _sample_buffers[ channel ][ delayed_index ];
+                channels[ channel ][ block_index ] = dry * si.dry_sample + wet * si.wet_sample;
+            } // for channel
+
+            for ( int channel = 0; channel < totalNumInputChannels; ++channel )
+            {
+                const int other_channel = totalNumInputChannels - 1 - channel;
+                SampleInfo& si = channel_sample_info[ channel ];
+                SampleInfo& si2 = channel_sample_info[ other_channel ];
+                _sample_buffers[ channel ][ current_index ] = si.input_sample + feedback * _jmap( pingpong, si.wet_sample, si2.wet_sample );
+            } // for channel
+
+            _buffer_index = (_buffer_index + 1) % _buffer_size;
+        } // for sample
+    }
+
+private:
+    float _sample_rate = 44100.0f;
+    int _samples_per_block = 0;
+
+    size_t _buffer_index = 0;
+    size_t _buffer_size = 0;
+    std::vector<float> _sample_buffers[2];
+
+private:
+    // juce::float_Pi, juce::Decibels::decibelsToGain() and juce::jmap() of JUCE 6.
+    static constexpr float _float_Pi = 3.14159265358979323846f;
+
+    static float _decibels_to_gain(float decibels)
+    {
+        return decibels > -100.0f ? std::pow( 10.0f, decibels * 0.05f ) : 0.0f;
+    }
+
+    static float _jmap(float value0To1, float targetRangeMin, float targetRangeMax)
+    {
+        return targetRangeMin + value0To1 * (targetRangeMax - targetRangeMin);
+    }
+
+};
@@ -0,0 +1,97 @@
+/*
+  ==============================================================================
+
+    EditorBenchmark.cpp
+    Created: 20 Oct 2026 12:06:37am
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#include "EditorBenchmark.h"
+
+#include "../../Source/EditorResources.h"
+#include "../../Source/PluginProcessor.h"
+
+static double _milliseconds_since(juce::int64 start_ticks)
+{
+    return juce::Time::highResolutionTicksToSeconds( juce::Time::getHighResolutionTicks() - start_ticks ) * 1000.0;
+}
+
+static void _find_sliders(juce::Component& component, juce::Array<juce::Slider*>& sliders)
+{
+    for ( juce::Component* child : component.getChildren() )
+    {
+        if ( auto* slider = dynamic_cast<juce::Slider*>( child ) )
+            sliders.add( slider );
+        else
+            _find_sliders( *child, sliders );
+    }
+}
+
+EditorBenchmark::Result EditorBenchmark::run(DrEchoAudioProcessor& processor, int num_repetitions)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    const int NUM_STEPS_PER_SLIDER = 32;
+
+    num_repetitions = juce::jmax( 1, num_repetitions );
+    Result result = {};
+
+    juce::int64 start_ticks = juce::Time::getHighResolutionTicks();
+    for ( int i = 0; i < num_repetitions; ++i )
+        EditorResources resources;
+    result.resources_ms = _milliseconds_since( start_ticks ) / num_repetitions;
+
+    // Holding the shared resources, as an editor that is already open does,
+    // measures what opening a further editor costs.
+    juce::SharedResourcePointer<EditorResources> resources;
+
+    start_ticks = juce::Time::getHighResolutionTicks();
+    for ( int i = 0; i < num_repetitions; ++i )
+        std::unique_ptr<juce::AudioProcessorEditor> editor( processor.createEditor() );
+    result.construction_ms = _milliseconds_since( start_ticks ) / num_repetitions;
+
+    // The editor is never put on the desktop; painting it into an image of
+    // the software renderer's type is exactly what a window repaint does.
+    std::unique_ptr<juce::AudioProcessorEditor> editor( processor.createEditor() );
+    juce::Image image( juce::Image::ARGB, editor->getWidth(), editor->getHeight(), true, juce::SoftwareImageType() );
+
+    start_ticks = juce::Time::getHighResolutionTicks();
+    for ( int i = 0; i < num_repetitions; ++i )
+    {
+        juce::Graphics g( image );
+        editor->paintEntireComponent( g, true );
+    }
+    result.paint_ms = _milliseconds_since( start_ticks ) / num_repetitions;
+
+    juce::Array<juce::Slider*> sliders;
+    _find_sliders( *editor, sliders );
+    result.num_sliders = sliders.size();
+
+    int num_updates = 0;
+    start_ticks = juce::Time::getHighResolutionTicks();
+    for ( juce::Slider* slider : sliders )
+    {
+        const juce::Rectangle<int> bounds = editor->getLocalArea( slider->getParentComponent(), slider->getBounds() );
+        for ( int step = 0; step <= NUM_STEPS_PER_SLIDER; ++step )
+        {
+            const double proportion = static_cast<double>( step ) / NUM_STEPS_PER_SLIDER;
+            slider->setValue( slider->proportionOfLengthToValue( proportion ), juce::NotificationType::dontSendNotification );
+
+            juce::Graphics g( image );
+            g.reduceClipRegion( bounds );
+            editor->paintEntireComponent( g, true );
+            ++num_updates;
+        }
+    }
+    result.knob_update_ms = num_updates > 0 ? _milliseconds_since( start_ticks ) / num_updates : 0.0;
+
+    return result;
+}
+
+juce::String EditorBenchmark::describe(const Result& result)
+{
+    return juce::String::formatted( "Editor benchmark: shared resources %.3f ms, construction %.3f ms, full paint %.3f ms, knob update %.3f ms (%d sliders)",
+                                    result.resources_ms, result.construction_ms, result.paint_ms, result.knob_update_ms, result.num_sliders );
+}
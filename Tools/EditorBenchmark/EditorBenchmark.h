@@ -0,0 +1,47 @@
+/*
+  ==============================================================================
+
+    EditorBenchmark.h
+    Created: 20 Oct 2026 12:06:37am
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+class DrEchoAudioProcessor;
+
+/**
+ * Measures what the editor costs on the message thread, without a window:
+ * constructing the shared resources (look-and-feels and fonts) and then an
+ * editor (sliders, labels and attachments), painting it completely into an
+ * offscreen image with the software renderer, and updating each slider
+ * through its whole range with the repaint of just that slider.
+ */
+class EditorBenchmark
+{
+
+public:
+    struct Result
+    {
+        double resources_ms;        // constructing the shared look-and-feels and fonts
+        double construction_ms;     // constructing a complete editor
+        double paint_ms;            // one full paint
+        double knob_update_ms;      // one slider value change and its repaint
+        int num_sliders;
+    };
+
+public:
+    /**
+     * Runs the benchmark on editors of the given processor; message thread only.
+     * The slider values are changed without notifying the attachments, so the
+     * processor's parameters stay untouched.
+     */
+    static Result run(DrEchoAudioProcessor& processor, int num_repetitions = 50);
+
+    static juce::String describe(const Result& result);
+
+};
@@ -0,0 +1,33 @@
+/*
+  ==============================================================================
+
+    This file contains the basic startup code for a JUCE application.
+
+    Runs the editor benchmark (see EditorBenchmark.h) on a processor of its
+    own and prints the results. The optional argument is the number of
+    repetitions.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+#include "EditorBenchmark.h"
+#include "../../Source/PluginProcessor.h"
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    const juce::ScopedJuceInitialiser_GUI juce_initialiser;
+
+    const int num_repetitions = argc > 1 ? juce::String( argv[1] ).getIntValue() : 50;
+    if ( num_repetitions < 1 )
+    {
+        std::cerr << "usage: " << argv[0] << " [repetitions]" << std::endl;
+        return 1;
+    }
+
+    DrEchoAudioProcessor processor;
+    std::cout << EditorBenchmark::describe( EditorBenchmark::run( processor, num_repetitions ) ) << std::endl;
+    return 0;
+}
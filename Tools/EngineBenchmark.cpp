@@ -0,0 +1,152 @@
+/*
+  ==============================================================================
+
+    EngineBenchmark.cpp
+    Created: 20 Oct 2026 2:18:40am
+    Author:  Stefan
+
+    Measures how the multichannel engine scales with the number of worker
+    threads: renders a bed of noise through ChannelGroupEngine at several
+    block sizes, serially and with 1 .. N workers, the way processBlock
+    does, and prints the time per block, the real-time factor and the
+    speedup over the serial run. Blocks below
+    ChannelGroupEngine::MIN_PARALLEL_BLOCK_SIZE always run serially.
+
+    Build (no further dependencies):
+        c++ -std=c++14 -O2 -pthread -I Source Tools/EngineBenchmark.cpp Source/RealtimeWorkerPool.cpp
+            Source/DspKernels.cpp Source/LfoWavetable.cpp Source/GrainPitchShifter.cpp Source/ReducedRatePath.cpp
+            Source/TempoSync.cpp Source/Ducker.cpp Source/RealtimeSafety.cpp -o drecho-benchmark
+
+    With -DDRECHO_REALTIME_CHECKS=1 (and -ldl on older glibc), the blocks
+    run as audio-thread code under RealtimeSafety, every allocation or lock
+    in them fails the run it happened in, with the stack, and the benchmark
+    exits with 1.
+
+    Usage:
+        drecho-benchmark [channels [max_workers]]
+
+    The defaults are 16 channels (8 stereo groups) and as many workers as
+    there are further groups or cores, whichever is less. Without the
+    privileges for real-time priority the workers run at normal priority,
+    which the output says.
+
+  ==============================================================================
+*/
+
+#include "ChannelGroupEngine.h"
+#include "RealtimeSafety.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+//==============================================================================
+static const int SAMPLE_RATE = 48000;
+static const double BPM = 120.0;
+static const double SECONDS_PER_RUN = 2.0;
+
+/** Deterministic white noise in [-1; 1), independent of the C library. */
+class _Noise
+{
+public:
+    explicit _Noise(uint32_t seed) : _state( seed ) {}
+
+    float next()
+    {
+        _state = _state * 1664525u + 1013904223u;
+        return static_cast<float>( _state >> 8 ) * (2.0f / 16777216.0f) - 1.0f;
+    }
+
+private:
+    uint32_t _state;
+};
+
+/** Renders SECONDS_PER_RUN of audio and returns the average time per block in microseconds. */
+static double _time_per_block(ChannelGroupEngine& engine, std::vector<std::vector<float>>& channels, int block_size, RealtimeWorkerPool* pool)
+{
+    const DrEchoEngine::Parameters parameters = [] {
+        DrEchoEngine::Parameters p;
+        p.feedback = 0.6f;
+        p.mod_depth = 2.0f; // the fractional reads are the expensive path
+        return p;
+    }();
+
+    const int num_channels = static_cast<int>( channels.size() );
+    std::vector<float*> pointers( channels.size() );
+    const int num_blocks = static_cast<int>( SECONDS_PER_RUN * SAMPLE_RATE ) / block_size;
+
+    engine.prepare( SAMPLE_RATE, block_size, false, num_channels );
+
+    const auto start = std::chrono::steady_clock::now();
+    {
+        const RealtimeSafety::ScopedAudioThread audio_thread;
+        for ( int b = 0; b < num_blocks; ++b )
+        {
+            // The same input over and over; the echo is different every time anyway.
+            for ( size_t c = 0; c < channels.size(); ++c )
+                pointers[c] = channels[c].data();
+            engine.process( pointers.data(), num_channels, block_size, parameters, BPM, nullptr, nullptr, 0, pool );
+        }
+    }
+    const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / num_blocks;
+}
+
+/** Prints the violations of the run that has just ended, if there were any, and returns whether there were. */
+static bool _report_violations(uint32_t& num_seen)
+{
+    const uint32_t num_violations = RealtimeSafety::getNumViolations();
+    if ( num_violations == num_seen )
+        return false;
+
+    std::printf( "FAILED: %u real-time safety violations in the run above\n", num_violations - num_seen );
+    RealtimeSafety::drainViolations( [](const RealtimeSafety::Violation& violation) {
+        std::printf( "%s", RealtimeSafety::describe( violation ).c_str() );
+    } );
+    num_seen = num_violations;
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    const int num_channels = dspLimit( 1, ChannelGroupEngine::MAX_CHANNELS, argc > 1 ? std::atoi( argv[1] ) : ChannelGroupEngine::MAX_CHANNELS );
+    const int num_groups = ChannelGroupEngine::getNumGroupsFor( num_channels );
+    const int num_cores = std::max( 1, static_cast<int>( std::thread::hardware_concurrency() ) );
+    const int max_workers = argc > 2 ? std::max( 0, std::atoi( argv[2] ) ) : std::min( num_groups - 1, num_cores - 1 );
+
+    std::printf( "%d channels in %d groups, %d cores, kernels %s\n", num_channels, num_groups, num_cores, DspKernels::select().name );
+
+    // Noise at -12 dBFS; the engine overwrites it in place, and that's fine.
+    _Noise noise( 1 );
+    const int block_sizes[] = { 32, 64, 128, 256, 512, 1024 };
+    std::vector<std::vector<float>> channels( static_cast<size_t>( num_channels ), std::vector<float>( 1024 ) );
+    for ( auto& channel : channels )
+        for ( float& x : channel )
+            x = 0.25f * noise.next();
+
+    ChannelGroupEngine engine;
+    uint32_t num_violations_seen = 0;
+    bool failed = false;
+
+    std::printf( "\n%-8s %-8s %12s %10s %8s\n", "block", "workers", "us/block", "realtime", "speedup" );
+    for ( int block_size : block_sizes )
+    {
+        const double budget_us = 1.0e6 * block_size / SAMPLE_RATE;
+        const double serial_us = _time_per_block( engine, channels, block_size, nullptr );
+        std::printf( "%-8d %-8s %12.2f %9.1fx %8s\n", block_size, "serial", serial_us, budget_us / serial_us, "1.00" );
+        failed |= _report_violations( num_violations_seen );
+
+        for ( int num_workers = 1; num_workers <= max_workers; ++num_workers )
+        {
+            RealtimeWorkerPool pool( num_workers );
+            const double parallel_us = _time_per_block( engine, channels, block_size, &pool );
+            std::printf( "%-8d %-8d %12.2f %9.1fx %8.2f%s\n", block_size, num_workers, parallel_us, budget_us / parallel_us, serial_us / parallel_us,
+                         pool.getNumRealtimeWorkers() < num_workers ? "  (not real-time)" : "" );
+            failed |= _report_violations( num_violations_seen );
+        }
+    }
+
+    if ( RealtimeSafety::isEnabled() )
+        std::printf( "\n%s\n", failed ? "real-time safety violations, see above" : "no real-time safety violations" );
+    return failed ? 1 : 0;
+}
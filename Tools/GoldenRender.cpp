@@ -0,0 +1,547 @@
+/*
+  ==============================================================================
+
+    GoldenRender.cpp
+    Created: 19 Oct 2026 10:24:51pm
+    Author:  Stefan
+
+    Guards the sound against DSP optimizations: renders a fixed set of test
+    signals (impulses, a sweep, noise, silence then a burst) through the
+    engine in several configurations, once per compiled-in kernel set, and
+    compares every render against the golden files in Tools/golden.
+
+    The configurations that only use the first release's parameters are
+    recorded from, and on every check also compared against, a frozen copy
+    of that release's per-sample loop (BaselineEcho.h), so that not even a
+    re-recording can make a change of the engine itself golden. The others
+    (modulation, shimmer, reduced rate, ducking) are recorded from the
+    scalar kernels of a known-good build; record them before changing the
+    DSP and check against them afterwards. Also compares each SIMD kernel
+    directly against its scalar reference, and a long chunked render (see
+    RenderDaemon/ChunkedRender.h) against a serial one.
+
+    Build (no further dependencies):
+        c++ -std=c++14 -O2 -I Source Tools/GoldenRender.cpp Source/DspKernels.cpp
+            Source/LfoWavetable.cpp Source/GrainPitchShifter.cpp Source/ReducedRatePath.cpp Source/TempoSync.cpp
+            Source/Ducker.cpp -o drecho-golden
+
+    Usage:
+        drecho-golden --record <directory>     (created if missing)
+        drecho-golden --check <directory>      (e.g. Tools/golden)
+
+    --check prints the error and the render time of every path and exits
+    with 1 if any of them exceeds its tolerance.
+
+  ==============================================================================
+*/
+
+#include "BaselineEcho.h"
+#include "DrEchoEngine.h"
+#include "RenderDaemon/ChunkedRender.h"
+#include "RenderDaemon/WavFile.h"
+
+#include <sys/stat.h>
+#if defined( _WIN32 )
+ #include <direct.h>
+#endif
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+//==============================================================================
+static const int SAMPLE_RATE = 48000;
+static const int NUM_FRAMES = SAMPLE_RATE;
+static const int BLOCK_SIZE = 512;
+static const double BPM = 120.0;
+
+/** Deterministic white noise in [-1; 1), independent of the C library. */
+class _Noise
+{
+public:
+    explicit _Noise(uint32_t seed) : _state( seed ) {}
+
+    float next()
+    {
+        _state = _state * 1664525u + 1013904223u;
+        return static_cast<float>( _state >> 8 ) * (2.0f / 16777216.0f) - 1.0f;
+    }
+
+private:
+    uint32_t _state;
+};
+
+//==============================================================================
+struct _Signal
+{
+    const char* name;
+    void (*generate)(std::vector<std::vector<float>>& channels);
+};
+
+static void _impulses(std::vector<std::vector<float>>& channels)
+{
+    channels[0][0] = 1.0f;
+    channels[1][101] = 1.0f;
+    channels[0][NUM_FRAMES / 2] = -0.5f;
+}
+
+static void _sweep(std::vector<std::vector<float>>& channels)
+{
+    // Exponential 20 Hz to 20 kHz, the right channel a quarter period behind.
+    const double ratio = std::log( 20000.0 / 20.0 );
+    for ( int i = 0; i < NUM_FRAMES; ++i )
+    {
+        const double t = static_cast<double>( i ) / SAMPLE_RATE;
+        const double phase = DSP_TWO_PI * 20.0 * (NUM_FRAMES / static_cast<double>( SAMPLE_RATE )) / ratio
+            * (std::exp( ratio * t * SAMPLE_RATE / NUM_FRAMES ) - 1.0);
+        channels[0][ static_cast<size_t>( i ) ] = 0.5f * static_cast<float>( std::sin( phase ) );
+        channels[1][ static_cast<size_t>( i ) ] = 0.5f * static_cast<float>( std::sin( phase - DSP_HALF_PI ) );
+    }
+}
+
+static void _noise(std::vector<std::vector<float>>& channels)
+{
+    _Noise noise( 1 );
+    for ( auto& channel : channels )
+        for ( float& sample : channel )
+            sample = 0.25f * noise.next();
+}
+
+static void _silence_then_burst(std::vector<std::vector<float>>& channels)
+{
+    _Noise noise( 2 );
+    for ( int i = NUM_FRAMES / 2; i < NUM_FRAMES / 2 + SAMPLE_RATE / 10; ++i )
+        for ( auto& channel : channels )
+            channel[ static_cast<size_t>( i ) ] = 0.8f * noise.next();
+}
+
+static const _Signal _signals[] =
+{
+    { "impulses", _impulses },
+    { "sweep", _sweep },
+    { "noise", _noise },
+    { "burst", _silence_then_burst },
+};
+
+//==============================================================================
+struct _Configuration
+{
+    const char* name;
+    int num_channels;
+    bool reduced_rate;
+    DrEchoEngine::Parameters parameters;
+    bool baseline;  // only what BaselineEcho knows, so that it is the reference
+};
+
+static std::vector<_Configuration> _get_configurations()
+{
+    DrEchoEngine::Parameters plain;
+    plain.gain_db = -3.0f;
+    plain.pan = 10.0f;
+    plain.delay = 3.0f;
+    plain.feedback = 0.6f;
+    plain.pingpong = 0.7f;
+
+    // A delay shorter than a block, so that each block reads what the same block wrote.
+    DrEchoEngine::Parameters short_delay = plain;
+    short_delay.pan = -30.0f;
+    short_delay.delay = 0.25f;
+    short_delay.feedback = 0.9f;
+    short_delay.pingpong = 0.0f;
+    short_delay.dry = 0.5f;
+    short_delay.wet = 1.0f;
+
+    DrEchoEngine::Parameters modulated = plain;
+    modulated.mod_rate = 2.0f;
+    modulated.mod_depth = 4.0f;
+    modulated.mod_shape = LfoWavetable::Shape::Triangle;
+    modulated.mod_phase = 90.0f;
+
+    DrEchoEngine::Parameters shimmer = plain;
+    shimmer.shimmer_semitones = 12.0f;
+    shimmer.shimmer_mix = 0.4f;
+
+    DrEchoEngine::Parameters everything = modulated;
+    everything.shimmer_semitones = -12.0f;
+
+    // Keyed by the dry input, since the engine alone has no sidechain.
+    DrEchoEngine::Parameters ducked = plain;
+    ducked.duck_amount_db = 12.0f;
+    ducked.duck_threshold_db = -24.0f;
+
+    return {
+        { "plain", 2, false, plain, true },
+        { "mono", 1, false, plain, true },
+        { "short", 2, false, short_delay, true },
+        { "modulated", 2, false, modulated, false },
+        { "shimmer", 2, false, shimmer, false },
+        { "reduced", 2, true, everything, false },
+        { "ducked", 2, false, ducked, false },
+    };
+}
+
+//==============================================================================
+static WavFile _generate(const _Signal& signal, const _Configuration& configuration)
+{
+    WavFile wav;
+    wav.sample_rate = SAMPLE_RATE;
+    wav.channels.assign( static_cast<size_t>( configuration.num_channels ), std::vector<float>( NUM_FRAMES, 0.0f ) );
+    if ( configuration.num_channels == 2 )
+        signal.generate( wav.channels );
+    else
+    {
+        std::vector<std::vector<float>> stereo( 2, std::vector<float>( NUM_FRAMES, 0.0f ) );
+        signal.generate( stereo );
+        wav.channels[0] = stereo[0];
+    }
+    return wav;
+}
+
+/** The first release's rendering of a baseline configuration, see BaselineEcho.h. */
+static WavFile _render_baseline(const _Signal& signal, const _Configuration& configuration)
+{
+    assert( configuration.baseline );
+    const DrEchoEngine::Parameters& parameters = configuration.parameters;
+    BaselineEcho::Parameters baseline_parameters;
+    baseline_parameters.gain = parameters.gain_db;
+    baseline_parameters.pan = static_cast<int>( ::lroundf( parameters.pan ) );
+    baseline_parameters.delay = parameters.delay;
+    baseline_parameters.pingpong = static_cast<int>( ::lroundf( parameters.pingpong * 100.0f ) );
+    baseline_parameters.feedback = static_cast<int>( ::lroundf( parameters.feedback * 100.0f ) );
+    baseline_parameters.dry = static_cast<int>( ::lroundf( parameters.dry * 100.0f ) );
+    baseline_parameters.wet = static_cast<int>( ::lroundf( parameters.wet * 100.0f ) );
+
+    WavFile wav = _generate( signal, configuration );
+    BaselineEcho echo;
+    echo.prepareToPlay( SAMPLE_RATE, BLOCK_SIZE );
+
+    float* channels[2];
+    for ( int offset = 0; offset < NUM_FRAMES; offset += BLOCK_SIZE )
+    {
+        for ( int c = 0; c < configuration.num_channels; ++c )
+            channels[c] = wav.channels[ static_cast<size_t>( c ) ].data() + offset;
+        echo.processBlock( channels, configuration.num_channels, std::min( BLOCK_SIZE, NUM_FRAMES - offset ), baseline_parameters, BPM );
+    }
+    return wav;
+}
+
+static WavFile _render(const DspKernels& kernels, const _Signal& signal, const _Configuration& configuration, double& seconds)
+{
+    WavFile wav = _generate( signal, configuration );
+
+    DrEchoEngine engine( kernels );
+    engine.prepare( SAMPLE_RATE, BLOCK_SIZE, configuration.reduced_rate );
+
+    float* channels[DrEchoEngine::MAX_CHANNELS];
+    const auto start = std::chrono::steady_clock::now();
+    for ( int offset = 0; offset < NUM_FRAMES; offset += BLOCK_SIZE )
+    {
+        for ( int c = 0; c < configuration.num_channels; ++c )
+            channels[c] = wav.channels[ static_cast<size_t>( c ) ].data() + offset;
+        engine.process( channels, configuration.num_channels, std::min( BLOCK_SIZE, NUM_FRAMES - offset ), configuration.parameters, BPM );
+    }
+    seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+    return wav;
+}
+
+static float _to_db(float value)
+{
+    return value > 0.0f ? 20.0f * std::log10( value ) : -999.0f;
+}
+
+/** Maximum and RMS difference, in dB relative to full scale. */
+static bool _compare(const WavFile& golden, const WavFile& output, float& max_error_db, float& rms_error_db)
+{
+    if ( golden.channels.size() != output.channels.size() || golden.getNumFrames() != output.getNumFrames() )
+        return false;
+
+    float max_error = 0.0f;
+    double sum = 0.0;
+    size_t count = 0;
+    for ( size_t c = 0; c < golden.channels.size(); ++c )
+    {
+        for ( size_t i = 0; i < golden.getNumFrames(); ++i )
+        {
+            const float error = std::fabs( golden.channels[c][i] - output.channels[c][i] );
+            max_error = std::max( max_error, error );
+            sum += static_cast<double>( error ) * error;
+            ++count;
+        }
+    }
+    max_error_db = _to_db( max_error );
+    rms_error_db = _to_db( static_cast<float>( std::sqrt( sum / static_cast<double>( count ) ) ) );
+    return true;
+}
+
+/**
+ * The largest acceptable peak error, the same for every path: the kernels
+ * are compiled without contraction into fused multiply-adds (see
+ * DspKernels.cpp), so all of them compute the scalar results, and only the
+ * last bits of the C library's math may differ between builds.
+ */
+static const float TOLERANCE_DB = -120.0f;
+
+//==============================================================================
+/** Runs every SIMD kernel next to the scalar one on the same noise; returns false on a mismatch. */
+static bool _check_kernels(const DspKernels& kernels)
+{
+    const DspKernels& scalar = DspKernels::scalar();
+    const int n = 1000; // not a multiple of any vector width, to cover the tails
+    const int ring_size = 4096;
+    const float tolerance = 1.0e-5f;
+
+    _Noise noise( 3 );
+    std::vector<float> a( n ), b( n ), c( n ), d( n ), ring( ring_size ), lfo( n );
+    for ( auto* v : { &a, &b, &c, &d, &ring, &lfo } )
+        for ( float& x : *v )
+            x = noise.next();
+
+    std::vector<float> expected0( n ), expected1( n ), actual0( n ), actual1( n );
+    bool ok = true;
+    auto verify = [&](const char* name, bool stereo, float max_error)
+    {
+        float error = 0.0f;
+        for ( int i = 0; i < n; ++i )
+        {
+            error = std::max( error, std::fabs( expected0[i] - actual0[i] ) );
+            if ( stereo )
+                error = std::max( error, std::fabs( expected1[i] - actual1[i] ) );
+        }
+        if ( error > max_error )
+        {
+            std::printf( "  kernel %-16s %-8s max error %g\n", name, kernels.name, error );
+            ok = false;
+        }
+    };
+
+    scalar.mid_side_pan( a.data(), b.data(), expected0.data(), expected1.data(), n, 0.8f, 0.6f, 0.7f );
+    kernels.mid_side_pan( a.data(), b.data(), actual0.data(), actual1.data(), n, 0.8f, 0.6f, 0.7f );
+    verify( "mid_side_pan", true, tolerance );
+
+    scalar.gain( a.data(), expected0.data(), n, 0.3f );
+    kernels.gain( a.data(), actual0.data(), n, 0.3f );
+    verify( "gain", false, tolerance );
+
+    scalar.gain_ramp( a.data(), expected0.data(), n, 1.0f, -0.9f / n );
+    kernels.gain_ramp( a.data(), actual0.data(), n, 1.0f, -0.9f / n );
+    verify( "gain_ramp", false, tolerance );
+
+    scalar.mix( a.data(), b.data(), expected0.data(), n, 0.9f, 0.4f );
+    kernels.mix( a.data(), b.data(), actual0.data(), n, 0.9f, 0.4f );
+    verify( "mix", false, tolerance );
+
+    scalar.feedback( a.data(), b.data(), c.data(), d.data(), expected0.data(), expected1.data(), n, 0.6f, 0.3f );
+    kernels.feedback( a.data(), b.data(), c.data(), d.data(), actual0.data(), actual1.data(), n, 0.6f, 0.3f );
+    verify( "feedback", true, tolerance );
+
+    // Write index near the end, so that the reads wrap around.
+    scalar.modulated_read( ring.data(), ring_size, ring_size - 600, lfo.data(), expected0.data(), n, 300.5f, 120.0f );
+    kernels.modulated_read( ring.data(), ring_size, ring_size - 600, lfo.data(), actual0.data(), n, 300.5f, 120.0f );
+    verify( "modulated_read", false, tolerance );
+
+    // The peak has to match exactly; the sum of squares is summed in another order.
+    float expected_peak = 0.0f, expected_sum = 0.0f, actual_peak = 0.0f, actual_sum = 0.0f;
+    scalar.level( a.data(), n, expected_peak, expected_sum );
+    kernels.level( a.data(), n, actual_peak, actual_sum );
+    if ( actual_peak != expected_peak || std::fabs( actual_sum - expected_sum ) > tolerance * expected_sum )
+    {
+        std::printf( "  kernel %-16s %-8s peak %g (expected %g), sum of squares %g (expected %g)\n", "level", kernels.name, actual_peak, expected_peak, actual_sum, expected_sum );
+        ok = false;
+    }
+
+    return ok;
+}
+
+//==============================================================================
+/**
+ * Renders 40 seconds of noise in 10-second chunks and serially, and returns
+ * false if they differ by more than CHUNK_TOLERANCE_DB. The chunks
+ * after the second start with a warm-up in the middle of the signal, with
+ * the LFO and the grains seeked there.
+ */
+static bool _check_chunked(const _Configuration& configuration)
+{
+    const size_t num_frames = 40 * SAMPLE_RATE;
+    const size_t chunk_frames = (10 * SAMPLE_RATE + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE;
+
+    _Noise noise( 4 );
+    std::vector<std::vector<float>> serial( static_cast<size_t>( configuration.num_channels ), std::vector<float>( num_frames ) );
+    for ( auto& channel : serial )
+        for ( float& sample : channel )
+            sample = 0.25f * noise.next();
+    std::vector<std::vector<float>> chunked = serial;
+
+    float* serial_channels[DrEchoEngine::MAX_CHANNELS];
+    float* chunked_channels[DrEchoEngine::MAX_CHANNELS];
+    for ( int c = 0; c < configuration.num_channels; ++c )
+    {
+        serial_channels[c] = serial[ static_cast<size_t>( c ) ].data();
+        chunked_channels[c] = chunked[ static_cast<size_t>( c ) ].data();
+    }
+
+    DrEchoEngine engine;
+    engine.prepare( SAMPLE_RATE, BLOCK_SIZE, configuration.reduced_rate );
+    const size_t warm_up_frames = engine.getTailLength( configuration.parameters, BPM, CHUNK_WARM_UP_LEVEL );
+    engine.process( serial_channels, configuration.num_channels, static_cast<int>( num_frames ), configuration.parameters, BPM );
+
+    const size_t alignment = static_cast<size_t>( BLOCK_SIZE * (configuration.reduced_rate ? ReducedRatePath::getFactorFor( SAMPLE_RATE ) : 1) );
+    ChunkedRender render( num_frames, chunk_frames, warm_up_frames, alignment, configuration.num_channels );
+    render.saveWarmUpInput( chunked_channels );
+    for ( int chunk = 0; chunk < render.getNumChunks(); ++chunk )
+    {
+        engine.reset();
+        render.renderChunk( engine, chunk, chunked_channels, 0, configuration.num_channels, configuration.parameters, BPM );
+    }
+
+    float max_error = 0.0f;
+    for ( size_t c = 0; c < serial.size(); ++c )
+        for ( size_t i = 0; i < num_frames; ++i )
+            max_error = std::max( max_error, std::fabs( serial[c][i] - chunked[c][i] ) );
+    const bool passed = _to_db( max_error ) <= CHUNK_TOLERANCE_DB;
+    std::printf( "%-10s %-10s %-8s %12.1f   warm-up %.1f s%s\n", "chunked", configuration.name, engine.getKernels().name, _to_db( max_error ),
+                 static_cast<double>( warm_up_frames ) / SAMPLE_RATE, passed ? "" : "  FAILED" );
+    return passed;
+}
+
+//==============================================================================
+static std::string _golden_path(const std::string& directory, const _Signal& signal, const _Configuration& configuration)
+{
+    return directory + "/" + signal.name + "-" + configuration.name + ".wav";
+}
+
+/** Creates the directory and its parents, as far as they don't exist. */
+static bool _create_directory(const std::string& directory)
+{
+    for ( size_t end = directory.find_first_of( "/\\", 1 ); ; end = directory.find_first_of( "/\\", end + 1 ) )
+    {
+        const std::string path = directory.substr( 0, end );
+       #if defined( _WIN32 )
+        const int result = ::_mkdir( path.c_str() );
+       #else
+        const int result = ::mkdir( path.c_str(), 0777 );
+       #endif
+        if ( result != 0 && errno != EEXIST )
+        {
+            std::fprintf( stderr, "cannot create %s: %s\n", path.c_str(), std::strerror( errno ) );
+            return false;
+        }
+        if ( end == std::string::npos )
+            return true;
+    }
+}
+
+static int _record(const std::string& directory)
+{
+    if ( !_create_directory( directory ) )
+        return 1;
+
+    for ( const _Signal& signal : _signals )
+    {
+        for ( const _Configuration& configuration : _get_configurations() )
+        {
+            double seconds;
+            const WavFile output = configuration.baseline ? _render_baseline( signal, configuration )
+                                                          : _render( DspKernels::scalar(), signal, configuration, seconds );
+            const std::string path = _golden_path( directory, signal, configuration );
+            std::string error;
+            if ( !output.write( path, error ) )
+            {
+                std::fprintf( stderr, "%s\n", error.c_str() );
+                return 1;
+            }
+            std::printf( "%s\n", path.c_str() );
+        }
+    }
+    return 0;
+}
+
+static int _check(const std::string& directory)
+{
+    const DspKernels::InstructionSet instruction_sets[] =
+    {
+        DspKernels::InstructionSet::Scalar,
+        DspKernels::InstructionSet::SSE2,
+        DspKernels::InstructionSet::AVX2,
+        DspKernels::InstructionSet::AVX512,
+    };
+    const double audio_seconds = static_cast<double>( NUM_FRAMES ) / SAMPLE_RATE;
+
+    int num_failed = 0;
+    std::printf( "%-10s %-10s %-8s %12s %12s %10s %10s\n", "signal", "config", "kernels", "max err dB", "rms err dB", "ms", "x realtime" );
+    for ( const _Signal& signal : _signals )
+    {
+        for ( const _Configuration& configuration : _get_configurations() )
+        {
+            WavFile golden;
+            std::string error;
+            if ( !golden.read( _golden_path( directory, signal, configuration ), error ) )
+            {
+                std::printf( "%-10s %-10s missing golden file: %s\n", signal.name, configuration.name, error.c_str() );
+                ++num_failed;
+                continue;
+            }
+
+            // A golden file of the baseline has to be the baseline, whoever recorded it.
+            if ( configuration.baseline )
+            {
+                float max_error_db, rms_error_db;
+                const bool comparable = _compare( golden, _render_baseline( signal, configuration ), max_error_db, rms_error_db );
+                const bool passed = comparable && max_error_db <= TOLERANCE_DB;
+                if ( !passed )
+                    ++num_failed;
+                std::printf( "%-10s %-10s %-8s %12.1f %12.1f%s\n", signal.name, configuration.name, "baseline",
+                             comparable ? max_error_db : 0.0f, comparable ? rms_error_db : 0.0f, passed ? "" : "  FAILED" );
+            }
+
+            for ( DspKernels::InstructionSet instruction_set : instruction_sets )
+            {
+                const DspKernels* kernels = DspKernels::find( instruction_set );
+                if ( !kernels )
+                    continue;
+
+                double seconds;
+                const WavFile output = _render( *kernels, signal, configuration, seconds );
+                float max_error_db, rms_error_db;
+                const bool comparable = _compare( golden, output, max_error_db, rms_error_db );
+                const bool passed = comparable && max_error_db <= TOLERANCE_DB;
+                if ( !passed )
+                    ++num_failed;
+
+                if ( comparable )
+                {
+                    std::printf( "%-10s %-10s %-8s %12.1f %12.1f %10.2f %10.0f%s\n", signal.name, configuration.name, kernels->name,
+                                 max_error_db, rms_error_db, seconds * 1000.0, audio_seconds / seconds, passed ? "" : "  FAILED" );
+                }
+                else
+                    std::printf( "%-10s %-10s %-8s golden file has a different format  FAILED\n", signal.name, configuration.name, kernels->name );
+            }
+        }
+    }
+
+    for ( const _Configuration& configuration : _get_configurations() )
+        if ( !_check_chunked( configuration ) )
+            ++num_failed;
+
+    for ( DspKernels::InstructionSet instruction_set : instruction_sets )
+    {
+        const DspKernels* kernels = DspKernels::find( instruction_set );
+        if ( kernels && !_check_kernels( *kernels ) )
+            ++num_failed;
+    }
+
+    std::printf( num_failed == 0 ? "all paths match\n" : "%d paths FAILED\n", num_failed );
+    return num_failed == 0 ? 0 : 1;
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    if ( argc == 3 && std::strcmp( argv[1], "--record" ) == 0 )
+        return _record( argv[2] );
+    if ( argc == 3 && std::strcmp( argv[1], "--check" ) == 0 )
+        return _check( argv[2] );
+
+    std::fprintf( stderr, "usage: %s --record <directory> | --check <directory>\n", argv[0] );
+    return 2;
+}
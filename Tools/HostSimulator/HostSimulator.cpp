@@ -0,0 +1,630 @@
+/*
+  ==============================================================================
+
+    HostSimulator.cpp
+    Created: 20 Oct 2026 3:14:52am
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#include "HostSimulator.h"
+
+#include "../../Source/MyLogger.h"
+#include "../../Source/PluginProcessor.h"
+#include "../../Source/RealtimeSafety.h"
+
+// Written around the samples of every block; anything else there afterwards was written out of bounds.
+static const float _GUARD_VALUE = 1.2345e30f;
+static const int _NUM_GUARD_SAMPLES = 64;
+
+// Beyond +80 dBFS, the feedback loop has run away.
+static const float _MAX_LEVEL = 1.0e4f;
+
+// Hosts announce a block size and then exceed it; up to this many times.
+static const int _MAX_OVERSIZE_FACTOR = 4;
+
+static const int _MAX_REPORTED_FAILURES = 50;
+static const int _NUM_WORST_BLOCKS = 10;
+
+static const double _sample_rates[] = { 22050.0, 44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0 };
+static const int _block_sizes[] = { 16, 32, 64, 100, 128, 256, 441, 512, 1024, 2048, 4096 };
+
+template <typename T, size_t N>
+static T _pick(juce::Random& random, const T (&values)[N])
+{
+    return values[ random.nextInt( static_cast<int>( N ) ) ];
+}
+
+static juce::String _get_environment(const char* name)
+{
+    const char* value = std::getenv( name );
+    return value ? juce::String( value ) : juce::String();
+}
+
+//==============================================================================
+/** A play head with a tempo that changes now and then, one without a tempo, or one without a position at all. */
+class _PlayHead
+    : public juce::AudioPlayHead
+{
+public:
+    enum class Mode
+    {
+        Tempo,
+        NoTempo,
+        NoPosition,
+    };
+
+public:
+    bool getCurrentPosition(CurrentPositionInfo& info) override
+    {
+        if ( mode == Mode::NoPosition )
+            return false;
+
+        info.resetToDefault();
+        info.bpm = mode == Mode::Tempo ? bpm : 0.0;
+        info.timeInSamples = time_in_samples;
+        info.timeInSeconds = static_cast<double>( time_in_samples ) / sample_rate;
+        info.isPlaying = true;
+        return true;
+    }
+
+public:
+    Mode mode = Mode::Tempo;
+    double bpm = 120.0;
+    double sample_rate = 44100.0;
+    juce::int64 time_in_samples = 0;
+};
+
+/** The test signal of a session. */
+enum class _Signal
+{
+    Noise,
+    Silence,
+    Impulses,
+    Hot,            // noise at +12 dBFS
+    Denormals,
+    FullScaleDc,
+    Sine,
+    NUM_SIGNALS
+};
+
+static const char* _get_signal_name(_Signal signal)
+{
+    switch ( signal )
+    {
+    case _Signal::Noise:        return "noise";
+    case _Signal::Silence:      return "silence";
+    case _Signal::Impulses:     return "impulses";
+    case _Signal::Hot:          return "hot noise";
+    case _Signal::Denormals:    return "denormals";
+    case _Signal::FullScaleDc:  return "full-scale DC";
+    case _Signal::Sine:         return "sine";
+    default:                    return "?";
+    }
+}
+
+//==============================================================================
+/** The time of every block relative to its duration, as a histogram, and the worst blocks. */
+class _Timing
+{
+public:
+    static const int NUM_BINS = 1000;
+    static constexpr double BIN_WIDTH = 0.01; // of the load, so up to 10 times the budget; beyond, the last bin
+
+    struct Block
+    {
+        double load;
+        double microseconds;
+        juce::String context;
+    };
+
+public:
+    bool isWorst(double load) const
+    {
+        return static_cast<int>( _worst.size() ) < _NUM_WORST_BLOCKS || load > _worst.back().load;
+    }
+
+    void add(double load, double microseconds)
+    {
+        ++_counts[ juce::jlimit( 0, NUM_BINS - 1, static_cast<int>( load / BIN_WIDTH ) ) ];
+        ++num_blocks;
+        if ( load > 1.0 )
+            ++num_overruns;
+        max_load = juce::jmax( max_load, load );
+    }
+
+    void addWorst(const Block& block)
+    {
+        _worst.push_back( block );
+        std::sort( _worst.begin(), _worst.end(), [](const Block& a, const Block& b) { return a.load > b.load; } );
+        if ( static_cast<int>( _worst.size() ) > _NUM_WORST_BLOCKS )
+            _worst.pop_back();
+    }
+
+    double getPercentile(double percentile) const
+    {
+        const juce::int64 rank = static_cast<juce::int64>( percentile / 100.0 * static_cast<double>( num_blocks ) );
+        juce::int64 count = 0;
+        for ( int i = 0; i < NUM_BINS; ++i )
+        {
+            count += _counts[i];
+            if ( count > rank )
+                return (i + 1) * BIN_WIDTH;
+        }
+        return max_load;
+    }
+
+    const std::vector<Block>& getWorst() const { return _worst; }
+
+public:
+    juce::int64 num_blocks = 0;
+    juce::int64 num_overruns = 0;
+    double max_load = 0.0;
+
+private:
+    juce::int64 _counts[NUM_BINS] = {};
+    std::vector<Block> _worst;
+};
+
+//==============================================================================
+/** One run: the processor, the states it is given, and what has been found so far. */
+class _Simulation
+{
+public:
+    _Simulation(const HostSimulator::Options& options, juce::Thread& thread)
+        : _options( options )
+        , _thread( thread )
+        , _start_ms( juce::Time::getMillisecondCounterHiRes() )
+        , _num_pending_changes( 0 )
+        , _num_sessions( 0 )
+        , _audio_seconds( 0.0 )
+        , _num_refused_layouts( 0 )
+        , _num_failures( 0 )
+        , _num_violations_seen( RealtimeSafety::getNumViolations() )
+        , _sine_phase( 0.0 )
+    {
+        _create_states();
+    }
+
+    void run()
+    {
+        for ( int session = _options.first_session; !_thread.threadShouldExit() && !_is_over(); ++session )
+            _run_session( session );
+        _wait_for_pending_changes();
+
+        _current_session = "finished";
+        _write_report();
+        MyLogger::log( juce::String::formatted( "Host simulator: finished after %d sessions, %d failures; report in ", _num_sessions, _num_failures )
+                       + _options.report_file.getFullPathName() );
+    }
+
+    int getNumFailures() const { return _num_failures; }
+
+private:
+    bool _is_over() const
+    {
+        return _options.duration_seconds > 0.0 && juce::Time::getMillisecondCounterHiRes() - _start_ms >= 1000.0 * _options.duration_seconds;
+    }
+
+    /** Saved states to restore during playback: the defaults, random settings, and a truncated and a garbage one, which must be refused. */
+    void _create_states()
+    {
+        juce::Random random( _options.seed );
+        juce::MemoryBlock state;
+        _processor.getStateInformation( state );
+        _states.push_back( state );
+
+        for ( int i = 0; i < 4; ++i )
+        {
+            for ( juce::AudioProcessorParameter* parameter : _processor.getParameters() )
+                parameter->setValueNotifyingHost( random.nextFloat() );
+            _processor.getStateInformation( state );
+            _states.push_back( state );
+        }
+
+        juce::MemoryBlock truncated( state.getData(), state.getSize() / 2 );
+        _states.push_back( truncated );
+
+        juce::MemoryBlock garbage( 256 );
+        random.fillBitsRandomly( garbage.getData(), garbage.getSize() );
+        _states.push_back( garbage );
+    }
+
+    juce::AudioProcessor::BusesLayout _choose_layout(juce::Random& random) const
+    {
+        const juce::AudioChannelSet main_sets[] =
+        {
+            juce::AudioChannelSet::mono(),
+            juce::AudioChannelSet::stereo(),
+            juce::AudioChannelSet::stereo(),
+            juce::AudioChannelSet::quadraphonic(),
+            juce::AudioChannelSet::create5point1(),
+            juce::AudioChannelSet::create7point1(),
+            juce::AudioChannelSet::discreteChannels( 16 ),
+            juce::AudioChannelSet::discreteChannels( 18 ), // too many, must be refused
+        };
+        const juce::AudioChannelSet main_set = _pick( random, main_sets );
+
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add( main_set );
+        layout.inputBuses.add( random.nextBool() ? juce::AudioChannelSet::disabled()
+                                                 : random.nextBool() ? juce::AudioChannelSet::stereo() : juce::AudioChannelSet::mono() );
+        layout.outputBuses.add( main_set );
+        layout.outputBuses.add( random.nextBool() ? juce::AudioChannelSet::disabled() : main_set );
+        return layout;
+    }
+
+    /** Mostly the announced size; otherwise shorter, longer, or nothing at all. */
+    static int _choose_block_size(juce::Random& random, int samples_per_block)
+    {
+        const int p = random.nextInt( 100 );
+        if ( p < 60 )
+            return samples_per_block;
+        if ( p < 80 )
+            return 1 + random.nextInt( samples_per_block );
+        if ( p < 95 )
+            return samples_per_block + 1 + random.nextInt( (_MAX_OVERSIZE_FACTOR - 1) * samples_per_block );
+        if ( p < 98 )
+            return 0;
+        return 1;
+    }
+
+    void _fill_input(juce::Random& random, _Signal signal, float* samples, int n, double sample_rate, juce::int64 time_in_samples)
+    {
+        for ( int i = 0; i < n; ++i )
+        {
+            float x = 0.0f;
+            switch ( signal )
+            {
+            case _Signal::Noise:        x = 0.25f * (2.0f * random.nextFloat() - 1.0f); break;
+            case _Signal::Silence:      break;
+            case _Signal::Impulses:     x = (time_in_samples + i) % static_cast<juce::int64>( sample_rate / 2 ) == 0 ? 1.0f : 0.0f; break;
+            case _Signal::Hot:          x = 4.0f * (2.0f * random.nextFloat() - 1.0f); break;
+            case _Signal::Denormals:    x = (i & 1) ? 1.0e-40f : -1.0e-40f; break;
+            case _Signal::FullScaleDc:  x = 1.0f; break;
+            case _Signal::Sine:         x = 0.5f * static_cast<float>( std::sin( _sine_phase + juce::MathConstants<double>::twoPi * 440.0 * i / sample_rate ) ); break;
+            default:                    break;
+            }
+            samples[i] = x;
+        }
+    }
+
+    /** Hands a change to the message thread, which makes it while the blocks go on. */
+    void _post_to_message_thread(std::function<void ()> change)
+    {
+        ++_num_pending_changes;
+        juce::MessageManager::callAsync( [this, change] {
+            change();
+            --_num_pending_changes;
+        } );
+    }
+
+    void _wait_for_pending_changes() const
+    {
+        while ( _num_pending_changes.load() > 0 )
+            juce::Thread::sleep( 1 );
+    }
+
+    void _set_state(size_t index)
+    {
+        const juce::MemoryBlock& state = _states[ index ];
+        _processor.setStateInformation( state.getData(), static_cast<int>( state.getSize() ) );
+    }
+
+    /**
+     * Automation, program changes, states and settings, as hosts and users change them during playback:
+     * automation from the audio thread, program changes from either thread, and states from the message thread.
+     */
+    void _maybe_change_something(juce::Random& random)
+    {
+        const int p = random.nextInt( 1000 );
+        if ( p < 20 )
+        {
+            const juce::Array<juce::AudioProcessorParameter*>& parameters = _processor.getParameters();
+            const float value = random.nextInt( 4 ) == 0 ? static_cast<float>( random.nextInt( 2 ) ) : random.nextFloat();
+            parameters[ random.nextInt( parameters.size() ) ]->setValueNotifyingHost( value );
+        }
+        else if ( p < 21 )
+        {
+            const int program = random.nextInt( _processor.getNumPrograms() );
+            _post_to_message_thread( [this, program] { _processor.setCurrentProgram( program ); } );
+        }
+        else if ( p < 22 )
+            _processor.setCurrentProgram( random.nextInt( _processor.getNumPrograms() ) );
+        else if ( p < 24 )
+        {
+            const size_t index = static_cast<size_t>( random.nextInt( static_cast<int>( _states.size() ) ) );
+            _post_to_message_thread( [this, index] { _set_state( index ); } );
+        }
+        else if ( p < 25 )
+            _processor.setReducedRateEnabled( !_processor.isReducedRateEnabled() );
+        else if ( p < 26 )
+            _processor.setParallelProcessingEnabled( !_processor.isParallelProcessingEnabled() );
+    }
+
+    void _run_session(int session)
+    {
+        // Each session has its own sequence, so that it can be rerun on its own.
+        juce::Random random( _options.seed ^ static_cast<juce::int64>( static_cast<juce::uint64>( session ) * 0x9E3779B97F4A7C15ull ) );
+
+        // The host reconfigures the processor while it isn't playing, from the
+        // default state and program 0, whatever the previous session left.
+        _wait_for_pending_changes();
+        _processor.releaseResources();
+        _post_to_message_thread( [this] {
+            _processor.setCurrentProgram( 0 );
+            _set_state( 0 );
+        } );
+        _wait_for_pending_changes();
+
+        const double sample_rate = _pick( random, _sample_rates );
+        const int samples_per_block = _pick( random, _block_sizes );
+        const juce::AudioProcessor::BusesLayout layout = _choose_layout( random );
+        if ( !_processor.setBusesLayout( layout ) )
+            ++_num_refused_layouts; // and the previous layout stays
+
+        _processor.setNonRealtime( random.nextInt( 8 ) == 0 );
+        _processor.setReducedRateEnabled( random.nextBool() );
+        _processor.setParallelProcessingEnabled( random.nextBool() );
+
+        _play_head.mode = static_cast<_PlayHead::Mode>( random.nextInt( 3 ) );
+        _play_head.bpm = 40.0 + 260.0 * random.nextDouble();
+        _play_head.sample_rate = sample_rate;
+        _play_head.time_in_samples = 0;
+        const bool has_play_head = random.nextInt( 4 ) != 0;
+        _processor.setPlayHead( has_play_head ? &_play_head : nullptr );
+
+        _processor.setRateAndBufferSizeDetails( sample_rate, samples_per_block );
+        _processor.prepareToPlay( sample_rate, samples_per_block );
+
+        // Every channel gets guard samples before and after the largest block.
+        const int num_input_channels = _processor.getTotalNumInputChannels();
+        const int num_output_channels = _processor.getTotalNumOutputChannels();
+        const int num_channels = juce::jmax( num_input_channels, num_output_channels );
+        const int stride = _MAX_OVERSIZE_FACTOR * samples_per_block + 2 * _NUM_GUARD_SAMPLES;
+        _storage.assign( static_cast<size_t>( num_channels * stride ), 0.0f );
+        _channels.resize( static_cast<size_t>( num_channels ) );
+        for ( int c = 0; c < num_channels; ++c )
+            _channels[ static_cast<size_t>( c ) ] = _storage.data() + c * stride + _NUM_GUARD_SAMPLES;
+
+        const _Signal signal = static_cast<_Signal>( random.nextInt( static_cast<int>( _Signal::NUM_SIGNALS ) ) );
+        const int num_blocks = static_cast<int>( (1.0 + 19.0 * random.nextDouble()) * sample_rate / samples_per_block );
+
+        _current_session = juce::String::formatted( "session %d: %.0f Hz, %d samples announced, %d in / %d out channels (main %d), %s, %s, %s%s%s, %d blocks",
+            session, sample_rate, samples_per_block, num_input_channels, num_output_channels, _processor.getMainBusNumInputChannels(),
+            _get_signal_name( signal ),
+            !has_play_head ? "no play head" : _play_head.mode == _PlayHead::Mode::Tempo ? "play head with tempo"
+                : _play_head.mode == _PlayHead::Mode::NoTempo ? "play head without tempo" : "play head without position",
+            _processor.isNonRealtime() ? "offline" : "real-time",
+            _processor.isReducedRateEnabled() ? ", reduced rate" : "",
+            _processor.isParallelProcessingEnabled() ? ", parallel" : "",
+            num_blocks );
+        _write_report();
+        ++_num_sessions;
+
+        juce::MidiBuffer midi;
+        for ( int b = 0; b < num_blocks && !_thread.threadShouldExit() && !_is_over(); ++b )
+        {
+            const int n = _choose_block_size( random, samples_per_block );
+
+            // Inputs get the signal, outputs whatever happens to be there.
+            std::fill( _storage.begin(), _storage.end(), _GUARD_VALUE );
+            for ( int c = 0; c < num_channels; ++c )
+            {
+                float* samples = _channels[ static_cast<size_t>( c ) ];
+                if ( c < num_input_channels )
+                    _fill_input( random, signal, samples, n, sample_rate, _play_head.time_in_samples );
+                else
+                    for ( int i = 0; i < n; ++i )
+                        samples[i] = random.nextFloat() * 1.0e3f;
+            }
+            _sine_phase = std::fmod( _sine_phase + juce::MathConstants<double>::twoPi * 440.0 * n / sample_rate, juce::MathConstants<double>::twoPi );
+
+            _maybe_change_something( random );
+
+            // What a plug-in wrapper does around processBlock().
+            juce::AudioBuffer<float> buffer( _channels.data(), num_channels, n );
+            const juce::int64 start_ticks = juce::Time::getHighResolutionTicks();
+            {
+                const juce::ScopedLock lock( _processor.getCallbackLock() );
+                if ( _processor.isSuspended() )
+                    buffer.clear();
+                else
+                    _processor.processBlock( buffer, midi );
+            }
+            const double seconds = juce::Time::highResolutionTicksToSeconds( juce::Time::getHighResolutionTicks() - start_ticks );
+
+            _play_head.time_in_samples += n;
+            if ( random.nextInt( 500 ) == 0 )
+                _play_head.bpm = 40.0 + 260.0 * random.nextDouble();
+            _audio_seconds += n / sample_rate;
+
+            if ( n > 0 )
+            {
+                const double load = seconds * sample_rate / n;
+                _timing.add( load, seconds * 1.0e6 );
+                if ( _timing.isWorst( load ) )
+                    _timing.addWorst( { load, seconds * 1.0e6, juce::String::formatted( "session %d, block %d of %d samples", session, b, n ) } );
+            }
+
+            // An allocation or a lock in the audio thread doesn't poison anything; the session goes on.
+            const juce::String violations = _check_violations();
+            if ( violations.isNotEmpty() )
+                _fail( juce::String::formatted( "session %d, block %d of %d samples: ", session, b, n ) + violations );
+
+            // A failure poisons the delay lines; the next session starts afresh.
+            const juce::String problem = _check( num_channels, num_output_channels, n );
+            if ( problem.isNotEmpty() )
+            {
+                _fail( juce::String::formatted( "session %d, block %d of %d samples: ", session, b, n ) + problem );
+                break;
+            }
+        }
+    }
+
+    /** Returns what is wrong with the block, if anything. */
+    juce::String _check(int num_channels, int num_output_channels, int n) const
+    {
+        for ( int c = 0; c < num_channels; ++c )
+        {
+            const float* samples = _channels[ static_cast<size_t>( c ) ];
+            for ( int i = -_NUM_GUARD_SAMPLES; i < 0; ++i )
+                if ( samples[i] != _GUARD_VALUE )
+                    return juce::String::formatted( "written before the start of channel %d, at sample %d", c, i );
+            for ( int i = n; i < n + _NUM_GUARD_SAMPLES; ++i )
+                if ( samples[i] != _GUARD_VALUE )
+                    return juce::String::formatted( "written beyond the end of channel %d, at sample %d", c, i );
+
+            if ( c >= num_output_channels )
+                continue;
+            for ( int i = 0; i < n; ++i )
+            {
+                if ( !std::isfinite( samples[i] ) )
+                    return juce::String::formatted( "%s in channel %d at sample %d", std::isnan( samples[i] ) ? "NaN" : "infinity", c, i );
+                if ( std::abs( samples[i] ) > _MAX_LEVEL )
+                    return juce::String::formatted( "runaway level %g in channel %d at sample %d", samples[i], c, i );
+            }
+        }
+        return {};
+    }
+
+    /** With DRECHO_REALTIME_CHECKS, what RealtimeSafety has recorded during the block, if anything. */
+    juce::String _check_violations()
+    {
+        const juce::uint32 num_violations = RealtimeSafety::getNumViolations();
+        if ( num_violations == _num_violations_seen )
+            return {};
+
+        // The processor's reporter may have drained some of them on the message thread already; the count is what fails.
+        juce::String text = juce::String( static_cast<int>( num_violations - _num_violations_seen ) ) + " real-time safety violations";
+        _num_violations_seen = num_violations;
+        bool first = true;
+        RealtimeSafety::drainViolations( [&](const RealtimeSafety::Violation& violation) {
+            if ( first )
+                text << ", the first:\n" << juce::String( RealtimeSafety::describe( violation ) ).trimEnd().replace( "\n", "\n    " );
+            first = false;
+        } );
+        return text;
+    }
+
+    void _fail(const juce::String& problem)
+    {
+        ++_num_failures;
+        if ( _failures.size() < _MAX_REPORTED_FAILURES )
+            _failures.add( problem + "\n    in " + _current_session );
+        MyLogger::log( "Host simulator: " + problem );
+    }
+
+    void _write_report() const
+    {
+        const double wall_seconds = (juce::Time::getMillisecondCounterHiRes() - _start_ms) * 0.001;
+        const int first_failing_session = _failures.isEmpty() ? -1 : _failures[0].fromFirstOccurrenceOf( "session ", false, false ).getIntValue();
+
+        juce::String report;
+        report << "Dr.Echo host simulator\n\n"
+               << "seed " << _options.seed << ", from session " << _options.first_session << "\n"
+               << "to rerun: DRECHO_HOST_SIMULATOR_SEED=" << _options.seed
+               << " DRECHO_HOST_SIMULATOR_SESSION=" << (first_failing_session >= 0 ? first_failing_session : _options.first_session) << "\n\n"
+               << "now: " << _current_session << "\n"
+               << juce::String::formatted( "%d sessions, %.1f s of audio in %.1f s, %d layouts refused\n\n", _num_sessions, _audio_seconds, wall_seconds, _num_refused_layouts );
+
+        report << _num_failures << " failures\n";
+        for ( const juce::String& failure : _failures )
+            report << "  " << failure << "\n";
+
+        report << "\ntiming (load = processing time / block duration, " << _timing.num_blocks << " blocks)\n"
+               << juce::String::formatted( "  median %.2f, 99%% %.2f, 99.9%% %.2f, max %.2f; %lld overruns (%.3f%%)\n",
+                                           _timing.getPercentile( 50.0 ), _timing.getPercentile( 99.0 ), _timing.getPercentile( 99.9 ), _timing.max_load,
+                                           static_cast<long long>( _timing.num_overruns ),
+                                           _timing.num_blocks > 0 ? 100.0 * static_cast<double>( _timing.num_overruns ) / static_cast<double>( _timing.num_blocks ) : 0.0 )
+               << "  worst blocks:\n";
+        for ( const _Timing::Block& block : _timing.getWorst() )
+            report << juce::String::formatted( "    load %.2f, %.1f us, ", block.load, block.microseconds ) << block.context << "\n";
+
+        _options.report_file.replaceWithText( report );
+    }
+
+private:
+    const HostSimulator::Options& _options;
+    juce::Thread& _thread;
+    const double _start_ms;
+
+    DrEchoAudioProcessor _processor;
+    _PlayHead _play_head;
+    std::vector<juce::MemoryBlock> _states;
+    std::atomic<int> _num_pending_changes;
+
+    std::vector<float> _storage;
+    std::vector<float*> _channels;
+
+    juce::String _current_session;
+    int _num_sessions;
+    double _audio_seconds;
+    int _num_refused_layouts;
+    int _num_failures;
+    juce::uint32 _num_violations_seen;
+    juce::StringArray _failures;
+    _Timing _timing;
+
+    double _sine_phase;
+};
+
+//==============================================================================
+/** The host's audio thread, which runs the simulation and ends the message loop afterwards. */
+class _AudioThread
+    : public juce::Thread
+{
+public:
+    explicit _AudioThread(const HostSimulator::Options& options)
+        : juce::Thread( "DrEcho host simulator" )
+        , simulation( options, *this )
+    {
+    }
+
+    ~_AudioThread() override
+    {
+        // A session of large blocks at a high rate takes a while to get through one block, never more.
+        stopThread( 10000 );
+    }
+
+    void run() override
+    {
+        simulation.run();
+        juce::MessageManager::getInstance()->stopDispatchLoop();
+    }
+
+public:
+    _Simulation simulation;
+};
+
+//==============================================================================
+HostSimulator::Options HostSimulator::getDefaultOptions()
+{
+    Options options;
+    const juce::String seed = _get_environment( "DRECHO_HOST_SIMULATOR_SEED" );
+    options.seed = seed.isNotEmpty() ? seed.getLargeIntValue() : juce::Random::getSystemRandom().nextInt64() & 0x7fffffffffffffffLL;
+    options.first_session = juce::jmax( 0, _get_environment( "DRECHO_HOST_SIMULATOR_SESSION" ).getIntValue() );
+    options.duration_seconds = 3600.0 * _get_environment( "DRECHO_HOST_SIMULATOR_HOURS" ).getDoubleValue();
+    options.report_file = juce::File::getCurrentWorkingDirectory()
+        .getChildFile( JucePlugin_Name + juce::String( "-host-simulator-" ) + juce::String( options.seed ) + ".txt" );
+    return options;
+}
+
+HostSimulator::HostSimulator(const Options& options)
+    : _options( options )
+{
+}
+
+int HostSimulator::run()
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    MyLogger::log( "Host simulator: seed " + juce::String( _options.seed ) + " from session " + juce::String( _options.first_session )
+                   + ", report in " + _options.report_file.getFullPathName() );
+
+    _AudioThread audio_thread( _options );
+    audio_thread.startThread();
+    juce::MessageManager::getInstance()->runDispatchLoop();
+    return audio_thread.simulation.getNumFailures();
+}
@@ -0,0 +1,74 @@
+/*
+  ==============================================================================
+
+    HostSimulator.h
+    Created: 20 Oct 2026 3:14:52am
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+ * Drives a processor of its own the way real hosts do: sessions with random
+ * sample rates, announced block sizes and bus layouts, and within them blocks
+ * shorter and longer than announced (and empty ones), play heads with and
+ * without a tempo or none at all, offline renders, automation, and program
+ * changes and setStateInformation() calls (including broken states) during
+ * playback. The blocks run on an audio thread of their own; the program
+ * changes and states mostly arrive from the message thread meanwhile, as in
+ * hosts, and some program changes from the audio thread itself.
+ *
+ * Every block is checked for NaNs, infinities and runaway levels, for writes
+ * beyond the samples and channels it was given (guard samples around the
+ * buffer), and, with DRECHO_REALTIME_CHECKS, for allocations and locks. The
+ * time of every block is measured against its real-time budget.
+ *
+ * Every session starts from the default state and program 0, and everything
+ * random comes from the seed and the session index, so a failure is
+ * reproduced by running the same seed from the same session (see
+ * getDefaultOptions()); only the exact interleaving with the message thread
+ * differs from run to run. The report, with the seed, the session that is
+ * running, the failures and the timing, is rewritten at the start of each
+ * session, so that it survives a crash.
+ */
+class HostSimulator
+{
+
+public:
+    struct Options
+    {
+        juce::int64 seed;
+        int first_session;
+        double duration_seconds;    // 0 runs until the process is killed
+        juce::File report_file;
+    };
+
+public:
+    /**
+     * A random seed, or the one in the environment variable
+     * DRECHO_HOST_SIMULATOR_SEED, starting from the session in
+     * DRECHO_HOST_SIMULATOR_SESSION (or the first), for the hours in
+     * DRECHO_HOST_SIMULATOR_HOURS (or until killed), reporting to a file in
+     * the current directory.
+     */
+    static Options getDefaultOptions();
+
+public:
+    explicit HostSimulator(const Options& options);
+
+public:
+    /**
+     * Runs the simulation to its end and returns the number of failures.
+     * Must be called on the message thread, which dispatches messages
+     * meanwhile (and delivers the program changes and states).
+     */
+    int run();
+
+private:
+    const Options _options;
+
+};
@@ -0,0 +1,31 @@
+/*
+  ==============================================================================
+
+    This file contains the basic startup code for a JUCE application.
+
+    Runs the host simulator (see HostSimulator.h) with the options from the
+    environment and exits with 1 if anything failed, so that a CI job can
+    run it for a while on every change.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+#include "HostSimulator.h"
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    const juce::ScopedJuceInitialiser_GUI juce_initialiser;
+
+    const HostSimulator::Options options = HostSimulator::getDefaultOptions();
+    std::cout << "Seed " << options.seed << " from session " << options.first_session
+              << ", report in " << options.report_file.getFullPathName() << std::endl;
+
+    HostSimulator simulator( options );
+    const int num_failures = simulator.run();
+
+    std::cout << num_failures << " failures" << std::endl;
+    return num_failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,288 @@
+/*
+  ==============================================================================
+
+    KernelBenchmark.cpp
+    Created: 20 Oct 2026 2:58:21am
+    Author:  Stefan
+
+    Times each stage of the echo's delay network in isolation, the way
+    DrEchoEngine calls it on a stereo block, and prints cycles and bytes per
+    stereo frame for several block sizes. The stages that touch the ring
+    buffer also run for several ring sizes, walking through the ring block by
+    block like the engine does; "vs L1" is the slowdown against the smallest
+    ring. A stage whose time grows with the ring is memory-bound there, one
+    whose time doesn't is compute-bound.
+
+    The stages:
+        pan            mid_side_pan, the M/S pan matrix and input gain
+        feedback       feedback, the ping-pong cross-feed into a cached block
+        ring_write     the same into the ring at the write position, as in the engine
+        tap_read       the unmodulated tap, a copy out of the ring, split at the wrap
+        mod_read       modulated_read, the interpolated tap with its own wrap handling
+        mix            mix, dry/wet
+        smoothing      gain_ramp, the per-sample ramp of a smoothed parameter
+
+    Bytes are the nominal traffic of a frame (every float read and written
+    once); the effective bandwidth follows from it.
+
+    Build (no further dependencies):
+        c++ -std=c++14 -O2 -I Source Tools/KernelBenchmark.cpp Source/DspKernels.cpp
+            -o drecho-kernel-benchmark
+
+    Usage:
+        drecho-kernel-benchmark [scalar | sse2 | avx2 | avx512 | all]
+
+    The default is the kernel set DspKernels::select() picks. Cycles are
+    time stamp counter ticks (reference cycles, not adjusted for turbo);
+    without a time stamp counter, only nanoseconds are shown.
+
+  ==============================================================================
+*/
+
+#include "DspKernels.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+
+#if DRECHO_INTEL
+ #if defined( _MSC_VER )
+  #include <intrin.h>
+ #else
+  #include <x86intrin.h>
+ #endif
+#endif
+
+//==============================================================================
+static const int SAMPLE_RATE = 48000;
+static const double SECONDS_PER_RUN = 0.02;
+static const int NUM_RUNS = 5;
+
+static const int _block_sizes[] = { 32, 128, 512 };
+static const int _ring_sizes[] = { 1 << 10, 1 << 14, 1 << 18, 1 << 21 }; // per channel: 4 KB, 64 KB, 1 MB, 8 MB
+
+/** Deterministic white noise in [-1; 1), independent of the C library. */
+class _Noise
+{
+public:
+    explicit _Noise(uint32_t seed) : _state( seed ) {}
+
+    float next()
+    {
+        _state = _state * 1664525u + 1013904223u;
+        return static_cast<float>( _state >> 8 ) * (2.0f / 16777216.0f) - 1.0f;
+    }
+
+private:
+    uint32_t _state;
+};
+
+#if DRECHO_INTEL
+static uint64_t _ticks()
+{
+    return __rdtsc();
+}
+
+/** Time stamp counter ticks per nanosecond, measured against the steady clock. */
+static double _ticks_per_nanosecond()
+{
+    const auto start = std::chrono::steady_clock::now();
+    const uint64_t start_ticks = _ticks();
+    while ( std::chrono::steady_clock::now() - start < std::chrono::milliseconds( 50 ) )
+    {
+    }
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return static_cast<double>( _ticks() - start_ticks ) / elapsed.count();
+}
+#endif
+
+//==============================================================================
+/** The buffers of a stereo block and a stereo ring, filled with noise, and the write position in the ring. */
+struct _Buffers
+{
+    _Buffers(int block_size, int ring_size)
+        : ring_size( ring_size )
+        , write_index( 0 )
+    {
+        _Noise noise( 1 );
+        for ( auto* v : { &in0, &in1, &wet0, &wet1, &out0, &out1, &lfo } )
+        {
+            v->resize( static_cast<size_t>( block_size ) );
+            for ( float& x : *v )
+                x = 0.5f * noise.next();
+        }
+        for ( auto* v : { &ring0, &ring1 } )
+        {
+            v->resize( static_cast<size_t>( ring_size ) );
+            for ( float& x : *v )
+                x = 0.5f * noise.next();
+        }
+    }
+
+    /** Moves the write position on by a block, as the engine does. */
+    void advance(int block_size) { write_index = (write_index + block_size) % ring_size; }
+
+    std::vector<float> in0, in1, wet0, wet1, out0, out1, lfo;
+    std::vector<float> ring0, ring1;
+    int ring_size;
+    int write_index;
+};
+
+struct _Stage
+{
+    const char* name;
+    int bytes_per_frame;
+    bool uses_ring;
+    std::function<void(const DspKernels&, _Buffers&, int)> run;
+};
+
+/** The unmodulated tap: a copy out of the ring, in two parts where the read wraps around. */
+static void _read_tap(const std::vector<float>& ring, int read_index, float* out, int n)
+{
+    const int first = std::min( n, static_cast<int>( ring.size() ) - read_index );
+    std::memcpy( out, ring.data() + read_index, sizeof( float ) * static_cast<size_t>( first ) );
+    std::memcpy( out + first, ring.data(), sizeof( float ) * static_cast<size_t>( n - first ) );
+}
+
+static std::vector<_Stage> _get_stages()
+{
+    const int F = static_cast<int>( sizeof( float ) );
+
+    // The longest delay the ring allows, and off the block grid, so that the reads wrap within a block now and then.
+    auto get_delay = [](const _Buffers& b, int n) { return b.ring_size - n - 37; };
+
+    return {
+        { "pan", 4 * F, false, [](const DspKernels& k, _Buffers& b, int n) {
+            k.mid_side_pan( b.in0.data(), b.in1.data(), b.out0.data(), b.out1.data(), n, 0.8f, 0.6f, 0.7f );
+        } },
+        { "feedback", 6 * F, false, [](const DspKernels& k, _Buffers& b, int n) {
+            k.feedback( b.in0.data(), b.in1.data(), b.wet0.data(), b.wet1.data(), b.out0.data(), b.out1.data(), n, 0.6f, 0.3f );
+        } },
+        { "ring_write", 6 * F, true, [](const DspKernels& k, _Buffers& b, int n) {
+            k.feedback( b.in0.data(), b.in1.data(), b.wet0.data(), b.wet1.data(),
+                        b.ring0.data() + b.write_index, b.ring1.data() + b.write_index, n, 0.6f, 0.3f );
+            b.advance( n );
+        } },
+        { "tap_read", 4 * F, true, [get_delay](const DspKernels&, _Buffers& b, int n) {
+            const int read_index = (b.write_index + b.ring_size - get_delay( b, n )) % b.ring_size;
+            _read_tap( b.ring0, read_index, b.out0.data(), n );
+            _read_tap( b.ring1, read_index, b.out1.data(), n );
+            b.advance( n );
+        } },
+        { "mod_read", 6 * F, true, [get_delay](const DspKernels& k, _Buffers& b, int n) {
+            // Depth and base delay keep the reads within the ring; the LFO buffer stays untouched.
+            const float base_delay = static_cast<float>( get_delay( b, n ) ) - 4.0f;
+            k.modulated_read( b.ring0.data(), b.ring_size, b.write_index, b.lfo.data(), b.out0.data(), n, base_delay, 2.0f );
+            k.modulated_read( b.ring1.data(), b.ring_size, b.write_index, b.lfo.data(), b.out1.data(), n, base_delay, 2.0f );
+            b.advance( n );
+        } },
+        { "mix", 6 * F, false, [](const DspKernels& k, _Buffers& b, int n) {
+            k.mix( b.in0.data(), b.wet0.data(), b.out0.data(), n, 0.9f, 0.4f );
+            k.mix( b.in1.data(), b.wet1.data(), b.out1.data(), n, 0.9f, 0.4f );
+        } },
+        { "smoothing", 4 * F, false, [](const DspKernels& k, _Buffers& b, int n) {
+            const float increment = 0.1f / static_cast<float>( n );
+            k.gain_ramp( b.in0.data(), b.out0.data(), n, 0.9f, increment );
+            k.gain_ramp( b.in1.data(), b.out1.data(), n, 0.9f, increment );
+        } },
+    };
+}
+
+//==============================================================================
+/** Runs a stage for SECONDS_PER_RUN, NUM_RUNS times, and returns the best time per frame in nanoseconds. */
+static double _time_per_frame(const _Stage& stage, const DspKernels& kernels, _Buffers& buffers, int block_size)
+{
+    // Long enough for the ring stages to go through the whole ring at least once.
+    const int num_blocks = std::max( static_cast<int>( SECONDS_PER_RUN * SAMPLE_RATE ) / block_size, 2 * buffers.ring_size / block_size );
+
+    for ( int b = 0; b < num_blocks; ++b ) // warm-up
+        stage.run( kernels, buffers, block_size );
+
+    double best = 0.0;
+    for ( int r = 0; r < NUM_RUNS; ++r )
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for ( int b = 0; b < num_blocks; ++b )
+            stage.run( kernels, buffers, block_size );
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        const double per_frame = elapsed.count() / (static_cast<double>( num_blocks ) * block_size);
+        best = r == 0 ? per_frame : std::min( best, per_frame );
+    }
+    return best;
+}
+
+static void _run(const DspKernels& kernels, double ticks_per_nanosecond)
+{
+    std::printf( "\nkernels %s\n", kernels.name );
+    std::printf( "%-11s %6s %9s %10s %10s %10s %8s\n", "stage", "block", "ring KB", "ns/frame", "cyc/frame", "B/frame", "GB/s" );
+
+    for ( const _Stage& stage : _get_stages() )
+    {
+        for ( int block_size : _block_sizes )
+        {
+            double cached_ns = 0.0;
+            const int num_rings = stage.uses_ring ? static_cast<int>( sizeof( _ring_sizes ) / sizeof( _ring_sizes[0] ) ) : 1;
+            for ( int r = 0; r < num_rings; ++r )
+            {
+                const int ring_size = stage.uses_ring ? _ring_sizes[r] : block_size;
+                _Buffers buffers( block_size, ring_size );
+                const double ns = _time_per_frame( stage, kernels, buffers, block_size );
+                if ( r == 0 )
+                    cached_ns = ns;
+
+                char ring_kb[16] = "-";
+                if ( stage.uses_ring )
+                    std::snprintf( ring_kb, sizeof( ring_kb ), "%d", 2 * ring_size * static_cast<int>( sizeof( float ) ) / 1024 );
+                char cycles[16] = "n/a";
+                if ( ticks_per_nanosecond > 0.0 )
+                    std::snprintf( cycles, sizeof( cycles ), "%.2f", ns * ticks_per_nanosecond );
+
+                std::printf( "%-11s %6d %9s %10.3f %10s %10d %8.1f", stage.name, block_size, ring_kb, ns, cycles, stage.bytes_per_frame,
+                             stage.bytes_per_frame / ns );
+                if ( stage.uses_ring && r > 0 )
+                    std::printf( "   vs L1 %.2fx", ns / cached_ns );
+                std::printf( "\n" );
+            }
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const DspKernels::InstructionSet instruction_sets[] =
+    {
+        DspKernels::InstructionSet::Scalar,
+        DspKernels::InstructionSet::SSE2,
+        DspKernels::InstructionSet::AVX2,
+        DspKernels::InstructionSet::AVX512,
+    };
+
+    std::vector<const DspKernels*> kernel_sets;
+    const char* wanted = argc > 1 ? argv[1] : nullptr;
+    if ( !wanted )
+        kernel_sets.push_back( &DspKernels::select() );
+    for ( DspKernels::InstructionSet instruction_set : instruction_sets )
+    {
+        const DspKernels* kernels = DspKernels::find( instruction_set );
+        if ( wanted && kernels && (std::strcmp( wanted, "all" ) == 0 || std::strcmp( wanted, kernels->name ) == 0) )
+            kernel_sets.push_back( kernels );
+    }
+    if ( kernel_sets.empty() )
+    {
+        std::fprintf( stderr, "usage: %s [scalar | sse2 | avx2 | avx512 | all] (the kernel set must be supported by this CPU)\n", argv[0] );
+        return 1;
+    }
+
+   #if DRECHO_INTEL
+    const double ticks_per_nanosecond = _ticks_per_nanosecond();
+    std::printf( "time stamp counter %.2f GHz\n", ticks_per_nanosecond );
+   #else
+    const double ticks_per_nanosecond = 0.0;
+   #endif
+
+    for ( const DspKernels* kernels : kernel_sets )
+        _run( *kernels, ticks_per_nanosecond );
+
+    return 0;
+}
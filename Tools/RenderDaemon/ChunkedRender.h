@@ -0,0 +1,131 @@
+/*
+  ==============================================================================
+
+    ChunkedRender.h
+    Created: 20 Oct 2026 4:08:26am
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "DrEchoEngine.h"
+
+#include <vector>
+
+// How far the echo of what came before a chunk has to have decayed (relative
+// to the input's peak) by the time the chunk starts, see DrEchoEngine::getTailLength().
+static const float CHUNK_WARM_UP_LEVEL = 1.0e-6f;   // -120 dB
+
+// The largest peak difference to a serial render that verification accepts,
+// with room for the different rounding of the seeked LFO and grain phases.
+static const float CHUNK_TOLERANCE_DB = -100.0f;
+
+/**
+ * Splits one long render into chunks that run on engines of their own, at
+ * the same time. Below 100 % feedback, the engine's state at any point only
+ * depends on a bounded stretch of earlier input, the tail length. So each
+ * chunk first runs its engine over that stretch (the warm-up, whose output
+ * is thrown away), after seeking the LFO and the grains to where the warm-up
+ * starts, and then renders the chunk itself; the chunks fit together within
+ * CHUNK_WARM_UP_LEVEL of a serial render.
+ *
+ * Chunks and warm-ups start on multiples of the alignment, the block size
+ * times the reduced-rate factor, so that the engines split their input into
+ * the same blocks as a serial render would.
+ *
+ * The chunks are rendered in place, so the input of the warm-ups, which
+ * belongs to the chunk before, is copied beforehand (saveWarmUpInput()).
+ * Then renderChunk() may run for different chunks and channels on different
+ * threads.
+ */
+class ChunkedRender
+{
+
+public:
+    static const int CHUNKS_PER_WORKER = 2;     // so that the workers finish at about the same time
+    static const int MIN_CHUNK_PER_WARM_UP = 4; // so that the warm-ups cost at most a quarter on top
+
+public:
+    /**
+     * The chunk length for the given number of workers, or num_frames (a
+     * single chunk, i.e. a serial render) if the echo never decays or the
+     * warm-ups would cost more than chunking gains.
+     */
+    static size_t getChunkFrames(size_t num_frames, size_t warm_up_frames, size_t alignment, int num_workers)
+    {
+        if ( warm_up_frames == 0 || num_workers < 2 )
+            return num_frames;
+        const size_t per_worker = (num_frames + CHUNKS_PER_WORKER * num_workers - 1) / (CHUNKS_PER_WORKER * num_workers);
+        const size_t chunk_frames = _align_up( std::max( per_worker, MIN_CHUNK_PER_WARM_UP * warm_up_frames ), alignment );
+        return chunk_frames * 2 > num_frames ? num_frames : chunk_frames;
+    }
+
+public:
+    ChunkedRender(size_t num_frames, size_t chunk_frames, size_t warm_up_frames, size_t alignment, int num_channels)
+        : _num_frames( num_frames )
+        , _chunk_frames( std::max<size_t>( 1, chunk_frames ) )
+        , _warm_up_frames( _align_up( warm_up_frames, alignment ) )
+        , _num_channels( num_channels )
+    {
+        assert( chunk_frames % alignment == 0 || chunk_frames >= num_frames );
+    }
+
+public:
+    int getNumChunks() const { return static_cast<int>( (_num_frames + _chunk_frames - 1) / _chunk_frames ); }
+
+    size_t getStart(int chunk) const { return static_cast<size_t>( chunk ) * _chunk_frames; }
+    size_t getEnd(int chunk) const { return std::min( _num_frames, getStart( chunk ) + _chunk_frames ); }
+    size_t getWarmUpStart(int chunk) const { return getStart( chunk ) - std::min( getStart( chunk ), _warm_up_frames ); }
+
+    /** Copies the input of every chunk's warm-up; before any chunk is rendered. */
+    void saveWarmUpInput(const float* const* channels)
+    {
+        _warm_up_input.assign( static_cast<size_t>( getNumChunks() * _num_channels ), std::vector<float>() );
+        for ( int chunk = 1; chunk < getNumChunks(); ++chunk )
+            for ( int c = 0; c < _num_channels; ++c )
+                _warm_up_input[ _get_slot( chunk, c ) ].assign( channels[c] + getWarmUpStart( chunk ), channels[c] + getStart( chunk ) );
+    }
+
+    /**
+     * Renders the given channels (one or two) of a chunk in place, with an
+     * engine that has been prepared for the alignment's block size and reset.
+     */
+    void renderChunk(DrEchoEngine& engine, int chunk, float* const* channels, int first_channel, int num_channels,
+                     const DrEchoEngine::Parameters& parameters, double bpm)
+    {
+        float* warm_up[DrEchoEngine::MAX_CHANNELS];
+        float* output[DrEchoEngine::MAX_CHANNELS];
+        for ( int c = 0; c < num_channels; ++c )
+        {
+            warm_up[c] = _warm_up_input[ _get_slot( chunk, first_channel + c ) ].data();
+            output[c] = channels[first_channel + c] + getStart( chunk );
+        }
+
+        engine.seek( static_cast<int64_t>( getWarmUpStart( chunk ) ), parameters );
+        const size_t num_warm_up_frames = getStart( chunk ) - getWarmUpStart( chunk );
+        if ( num_warm_up_frames > 0 )
+            engine.process( warm_up, num_channels, static_cast<int>( num_warm_up_frames ), parameters, bpm );
+        engine.process( output, num_channels, static_cast<int>( getEnd( chunk ) - getStart( chunk ) ), parameters, bpm );
+    }
+
+private:
+    size_t _num_frames;
+    size_t _chunk_frames;
+    size_t _warm_up_frames;
+    int _num_channels;
+    std::vector<std::vector<float>> _warm_up_input;     // by chunk and channel
+
+private:
+    static size_t _align_up(size_t frames, size_t alignment)
+    {
+        return (frames + alignment - 1) / alignment * alignment;
+    }
+
+    size_t _get_slot(int chunk, int channel) const
+    {
+        return static_cast<size_t>( chunk * _num_channels + channel );
+    }
+
+};
@@ -0,0 +1,97 @@
+/*
+  ==============================================================================
+
+    EnginePool.h
+    Created: 19 Oct 2026 9:37:05pm
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "DrEchoEngine.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+/**
+ * Keeps prepared engines around between jobs, keyed by everything prepare()
+ * depends on, so that a job only pays for a reset() (clearing the ring
+ * buffers) instead of construction and allocation.
+ */
+class EnginePool
+{
+
+public:
+    struct Key
+    {
+        int sample_rate;
+        int block_size;
+        bool reduced_rate;
+
+        bool operator<(const Key& other) const
+        {
+            return std::tie( sample_rate, block_size, reduced_rate ) < std::tie( other.sample_rate, other.block_size, other.reduced_rate );
+        }
+    };
+
+public:
+    /** Returns a prepared engine in its initial state, from the pool if possible. */
+    std::unique_ptr<DrEchoEngine> acquire(const Key& key)
+    {
+        {
+            std::lock_guard<std::mutex> lock( _mutex );
+            std::vector<std::unique_ptr<DrEchoEngine>>& engines = _engines[ key ];
+            if ( !engines.empty() )
+            {
+                std::unique_ptr<DrEchoEngine> engine = std::move( engines.back() );
+                engines.pop_back();
+                ++_num_reused;
+                return engine;
+            }
+            ++_num_created;
+        }
+
+        auto engine = std::make_unique<DrEchoEngine>();
+        engine->prepare( key.sample_rate, key.block_size, key.reduced_rate );
+        return engine;
+    }
+
+    /** Hands an engine back for reuse. */
+    void release(const Key& key, std::unique_ptr<DrEchoEngine> engine)
+    {
+        engine->reset();
+        engine->setOptionalStages( true, true );
+
+        std::lock_guard<std::mutex> lock( _mutex );
+        _engines[ key ].push_back( std::move( engine ) );
+    }
+
+    /** Prepares engines ahead of the first job, e.g. for the formats a batch is known to use. */
+    void warmUp(const Key& key, int num_engines)
+    {
+        std::vector<std::unique_ptr<DrEchoEngine>> engines;
+        for ( int i = 0; i < num_engines; ++i )
+            engines.push_back( acquire( key ) );
+        for ( auto& engine : engines )
+            release( key, std::move( engine ) );
+    }
+
+    void getStatistics(int& num_created, int& num_reused) const
+    {
+        std::lock_guard<std::mutex> lock( _mutex );
+        num_created = _num_created;
+        num_reused = _num_reused;
+    }
+
+private:
+    mutable std::mutex _mutex;
+    std::map<Key, std::vector<std::unique_ptr<DrEchoEngine>>> _engines;
+    int _num_created = 0;
+    int _num_reused = 0;
+
+};
@@ -0,0 +1,86 @@
+/*
+  ==============================================================================
+
+    PluginState.h
+    Created: 19 Oct 2026 9:37:05pm
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "DrEchoEngine.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+/**
+ * Reads the plug-in state, as written by DrEchoAudioProcessor::getStateInformation,
+ * without JUCE: juce::AudioProcessor::copyXmlToBinary stores a magic number,
+ * the text size and the XML as UTF-8, i.e.
+ *
+ *     <?xml ...?> <DrEcho reducedRate="0"><PARAMETERS><PARAM id="gain" value="0.0"/>...
+ */
+struct PluginState
+{
+    DrEchoEngine::Parameters parameters;
+    bool reduced_rate = false;
+
+    bool read(const std::vector<uint8_t>& data, std::string& error)
+    {
+        const uint32_t MAGIC_XML_NUMBER = 0x21324356;
+
+        if ( data.size() < 8 || _read32( data.data() ) != MAGIC_XML_NUMBER )
+        {
+            error = "not a Dr.Echo state";
+            return false;
+        }
+        const size_t size = std::min<size_t>( _read32( data.data() + 4 ), data.size() - 8 );
+        const std::string xml( reinterpret_cast<const char*>( data.data() + 8 ), size );
+
+        // The text starts with the <?xml ...?> declaration.
+        const size_t root = xml.find( "<DrEcho" );
+        if ( root == std::string::npos )
+        {
+            error = "not a Dr.Echo state";
+            return false;
+        }
+
+        std::string value;
+        const size_t root_end = xml.find( '>', root );
+        if ( _find_attribute( xml.substr( root, root_end - root ), "reducedRate", value ) )
+            reduced_rate = value == "1" || value == "true";
+
+        for ( size_t pos = xml.find( "<PARAM " ); pos != std::string::npos; pos = xml.find( "<PARAM ", pos + 1 ) )
+        {
+            const std::string element = xml.substr( pos, xml.find( '>', pos ) - pos );
+            std::string id;
+            if ( _find_attribute( element, "id", id ) && _find_attribute( element, "value", value ) )
+                parameters.set( id, static_cast<float>( std::atof( value.c_str() ) ) );
+        }
+        return true;
+    }
+
+private:
+    static uint32_t _read32(const uint8_t* p)
+    {
+        return static_cast<uint32_t>( p[0] ) | (static_cast<uint32_t>( p[1] ) << 8) | (static_cast<uint32_t>( p[2] ) << 16) | (static_cast<uint32_t>( p[3] ) << 24);
+    }
+
+    static bool _find_attribute(const std::string& element, const std::string& name, std::string& value)
+    {
+        const std::string key = " " + name + "=\"";
+        const size_t begin = element.find( key );
+        if ( begin == std::string::npos )
+            return false;
+        const size_t value_begin = begin + key.size();
+        const size_t value_end = element.find( '"', value_begin );
+        if ( value_end == std::string::npos )
+            return false;
+        value = element.substr( value_begin, value_end - value_begin );
+        return true;
+    }
+};
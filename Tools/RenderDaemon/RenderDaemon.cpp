@@ -0,0 +1,471 @@
+/*
+  ==============================================================================
+
+    RenderDaemon.cpp
+    Created: 19 Oct 2026 9:37:05pm
+    Author:  Stefan
+
+    Renders audio through the Dr.Echo engine on request, for batch and
+    server-side use without a host. Clients connect to a Unix socket and send
+    one line per job:
+
+        render input=<file.wav|shm:/name> state=<file> output=<file.wav|shm>
+               [frames=N channels=C rate=R] [bpm=120] [block=512] [chunked=1 [verify=1]]
+
+    A shm: input is a POSIX shared-memory object with C planar float channels
+    of N frames each (frames, channels and rate are required then). Output to
+    shm creates a new object of the same layout and answers with its name; the
+    client unlinks it when done. No audio goes through the socket. The answer
+    is one line, "ok output=<file>", "ok shm=<name> frames=N channels=C" or
+    "error <message>".
+
+    The state is a plug-in state chunk as saved by the host (see PluginState.h).
+    Each job is split into channel pairs, which run as independent tasks on a
+    work-stealing pool, each on a prepared engine from a warm pool keyed by
+    sample rate, block size and the reduced-rate flag.
+
+    With chunked=1, one long file is also split in time, into chunks that
+    each warm up on the echo's tail length of input before them (see
+    ChunkedRender.h), so that a stereo file keeps all workers busy too. The
+    answer then has chunks=N; 1 means that chunking didn't pay off (100 %
+    feedback, or a file not much longer than the tail). verify=1 renders
+    serially as well and compares: the answer gets max_error_db=X, or is an
+    error beyond CHUNK_TOLERANCE_DB. Verifying keeps a copy of the input.
+
+    Build (Linux, macOS):
+        c++ -std=c++14 -O2 -pthread -I Source Tools/RenderDaemon/RenderDaemon.cpp
+            Source/DspKernels.cpp Source/LfoWavetable.cpp Source/GrainPitchShifter.cpp
+            Source/ReducedRatePath.cpp Source/TempoSync.cpp Source/Ducker.cpp -o drecho-renderd   (plus -lrt on older glibc)
+
+    Usage:
+        drecho-renderd [socket path] [threads]
+
+  ==============================================================================
+*/
+
+#include "ChunkedRender.h"
+#include "EnginePool.h"
+#include "PluginState.h"
+#include "WavFile.h"
+#include "WorkStealingPool.h"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <sstream>
+
+//==============================================================================
+static const char* const DEFAULT_SOCKET_PATH = "/tmp/drecho-render.sock";
+
+static std::atomic<unsigned> _next_output_id( 0 );
+
+//==============================================================================
+/** Counts down to zero and wakes the waiting thread, i.e. std::latch before C++20. */
+class _Latch
+{
+public:
+    explicit _Latch(int count) : _count( count ) {}
+
+    void countDown()
+    {
+        std::lock_guard<std::mutex> lock( _mutex );
+        if ( --_count == 0 )
+            _zero.notify_all();
+    }
+
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock( _mutex );
+        _zero.wait( lock, [this] { return _count == 0; } );
+    }
+
+private:
+    std::mutex _mutex;
+    std::condition_variable _zero;
+    int _count;
+};
+
+/**
+ * A mapped POSIX shared-memory object, unmapped on destruction. One that was
+ * created here is unlinked then, too, unless keep() has handed it over to the
+ * client, so that a job failing halfway doesn't leave it behind.
+ */
+class _SharedMemory
+{
+public:
+    ~_SharedMemory()
+    {
+        if ( _data )
+            ::munmap( _data, _size );
+        if ( !_created_name.empty() )
+            ::shm_unlink( _created_name.c_str() );
+    }
+
+    bool open(const std::string& name, size_t size, bool create, std::string& error)
+    {
+        const int fd = ::shm_open( name.c_str(), create ? (O_RDWR | O_CREAT | O_EXCL) : O_RDWR, 0600 );
+        if ( fd < 0 )
+        {
+            error = "cannot open shared memory " + name;
+            return false;
+        }
+        struct stat info;
+        if ( (create && ::ftruncate( fd, static_cast<off_t>( size ) ) != 0)
+            || ::fstat( fd, &info ) != 0 || static_cast<size_t>( info.st_size ) < size )
+        {
+            ::close( fd );
+            if ( create )
+                ::shm_unlink( name.c_str() );
+            error = "shared memory " + name + " is too small";
+            return false;
+        }
+        void* data = ::mmap( nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+        ::close( fd );
+        if ( data == MAP_FAILED )
+        {
+            if ( create )
+                ::shm_unlink( name.c_str() );
+            error = "cannot map shared memory " + name;
+            return false;
+        }
+        _data = data;
+        _size = size;
+        if ( create )
+            _created_name = name;
+        return true;
+    }
+
+    /** Leaves a created object to the client, who unlinks it when done. */
+    void keep()
+    {
+        _created_name.clear();
+    }
+
+    float* getChannel(size_t channel, size_t num_frames) const
+    {
+        return static_cast<float*>( _data ) + channel * num_frames;
+    }
+
+private:
+    void* _data = nullptr;
+    size_t _size = 0;
+    std::string _created_name;
+};
+
+//==============================================================================
+struct _Job
+{
+    std::string input;
+    std::string state;
+    std::string output;
+    size_t num_frames = 0;
+    int num_channels = 0;
+    int sample_rate = 0;
+    double bpm = 120.0;
+    int block_size = 512;
+    bool chunked = false;
+    bool verify = false;
+};
+
+static bool _parse_job(const std::string& line, _Job& job, std::string& error)
+{
+    std::istringstream words( line );
+    std::string command;
+    words >> command;
+    if ( command != "render" )
+    {
+        error = "unknown command '" + command + "'";
+        return false;
+    }
+
+    std::map<std::string, std::string> fields;
+    for ( std::string word; words >> word; )
+    {
+        const size_t equals = word.find( '=' );
+        if ( equals == std::string::npos )
+        {
+            error = "expected key=value, got '" + word + "'";
+            return false;
+        }
+        fields[ word.substr( 0, equals ) ] = word.substr( equals + 1 );
+    }
+
+    job.input = fields[ "input" ];
+    job.state = fields[ "state" ];
+    job.output = fields[ "output" ];
+    job.num_frames = static_cast<size_t>( std::strtoull( fields[ "frames" ].c_str(), nullptr, 10 ) );
+    job.num_channels = std::atoi( fields[ "channels" ].c_str() );
+    job.sample_rate = std::atoi( fields[ "rate" ].c_str() );
+    if ( !fields[ "bpm" ].empty() )
+        job.bpm = std::atof( fields[ "bpm" ].c_str() );
+    if ( !fields[ "block" ].empty() )
+        job.block_size = std::atoi( fields[ "block" ].c_str() );
+    job.chunked = fields[ "chunked" ] == "1";
+    job.verify = fields[ "verify" ] == "1";
+
+    if ( job.input.empty() || job.state.empty() || job.output.empty() )
+        error = "input, state and output are required";
+    else if ( job.bpm <= 0.0 || job.block_size <= 0 || job.block_size > 65536 )
+        error = "bpm and block must be positive";
+    return error.empty();
+}
+
+static bool _read_file(const std::string& path, std::vector<uint8_t>& data)
+{
+    FILE* file = std::fopen( path.c_str(), "rb" );
+    if ( !file )
+        return false;
+    uint8_t chunk[4096];
+    size_t n;
+    while ( (n = std::fread( chunk, 1, sizeof( chunk ), file )) > 0 )
+        data.insert( data.end(), chunk, chunk + n );
+    std::fclose( file );
+    return true;
+}
+
+//==============================================================================
+/** Runs one job and returns the answer line, without the newline. */
+static std::string _render(const _Job& job, WorkStealingPool& pool, EnginePool& engines)
+{
+    std::string error;
+
+    std::vector<uint8_t> chunk;
+    PluginState state;
+    if ( !_read_file( job.state, chunk ) )
+        return "error cannot open " + job.state;
+    if ( !state.read( chunk, error ) )
+        return "error " + job.state + ": " + error;
+
+    // Either way the audio ends up in planar channels that are rendered in place:
+    // the input file's, or a copy of the shared input in the shared output.
+    WavFile wav;
+    _SharedMemory input_memory;
+    _SharedMemory output_memory;
+    std::string output_name;
+    std::vector<float*> channels;
+    size_t num_frames;
+    int num_channels;
+    int sample_rate;
+
+    const bool shared_input = job.input.compare( 0, 4, "shm:" ) == 0;
+    if ( shared_input )
+    {
+        num_frames = job.num_frames;
+        num_channels = job.num_channels;
+        sample_rate = job.sample_rate;
+        if ( num_frames == 0 || num_channels <= 0 || sample_rate <= 0 )
+            return "error shared input needs frames, channels and rate";
+        if ( !input_memory.open( job.input.substr( 4 ), num_frames * num_channels * sizeof( float ), false, error ) )
+            return "error " + error;
+    }
+    else
+    {
+        if ( !wav.read( job.input, error ) )
+            return "error " + error;
+        num_frames = wav.getNumFrames();
+        num_channels = static_cast<int>( wav.channels.size() );
+        sample_rate = wav.sample_rate;
+    }
+
+    if ( job.output == "shm" )
+    {
+        output_name = "/drecho-render-" + std::to_string( ::getpid() ) + "-" + std::to_string( _next_output_id++ );
+        if ( !output_memory.open( output_name, num_frames * num_channels * sizeof( float ), true, error ) )
+            return "error " + error;
+        for ( int c = 0; c < num_channels; ++c )
+            channels.push_back( output_memory.getChannel( static_cast<size_t>( c ), num_frames ) );
+        for ( int c = 0; c < num_channels; ++c )
+        {
+            const float* source = shared_input
+                ? input_memory.getChannel( static_cast<size_t>( c ), num_frames )
+                : wav.channels[ static_cast<size_t>( c ) ].data();
+            std::copy( source, source + num_frames, channels[ static_cast<size_t>( c ) ] );
+        }
+    }
+    else
+    {
+        if ( shared_input )
+        {
+            wav.sample_rate = sample_rate;
+            wav.channels.resize( static_cast<size_t>( num_channels ) );
+            for ( int c = 0; c < num_channels; ++c )
+            {
+                const float* source = input_memory.getChannel( static_cast<size_t>( c ), num_frames );
+                wav.channels[ static_cast<size_t>( c ) ].assign( source, source + num_frames );
+            }
+        }
+        for ( auto& channel : wav.channels )
+            channels.push_back( channel.data() );
+    }
+
+    // Channel pairs are independent (the engine is at most stereo), so they are
+    // the unit of work; a multichannel stem keeps all workers busy. Chunked,
+    // each pair is split in time as well, as far as there are workers left.
+    const EnginePool::Key key = { sample_rate, job.block_size, state.reduced_rate };
+    const int num_groups = (num_channels + DrEchoEngine::MAX_CHANNELS - 1) / DrEchoEngine::MAX_CHANNELS;
+    size_t chunk_frames = num_frames;
+    size_t warm_up_frames = 0;
+    const size_t alignment = static_cast<size_t>( job.block_size * (state.reduced_rate ? ReducedRatePath::getFactorFor( sample_rate ) : 1) );
+    if ( job.chunked )
+    {
+        std::unique_ptr<DrEchoEngine> engine = engines.acquire( key );
+        warm_up_frames = engine->getTailLength( state.parameters, job.bpm, CHUNK_WARM_UP_LEVEL );
+        engines.release( key, std::move( engine ) );
+        chunk_frames = ChunkedRender::getChunkFrames( num_frames, warm_up_frames, alignment, pool.getNumThreads() / num_groups );
+    }
+    ChunkedRender render( num_frames, chunk_frames, warm_up_frames, alignment, num_channels );
+    const int num_chunks = render.getNumChunks();
+
+    std::vector<std::vector<float>> serial;
+    if ( job.verify && num_chunks > 1 )
+    {
+        for ( float* channel : channels )
+            serial.emplace_back( channel, channel + num_frames );
+    }
+
+    render.saveWarmUpInput( channels.data() );
+    _Latch done( num_groups * num_chunks );
+    for ( int g = 0; g < num_groups; ++g )
+    {
+        for ( int chunk = 0; chunk < num_chunks; ++chunk )
+        {
+            pool.submit( [&, g, chunk]
+            {
+                const int first = g * DrEchoEngine::MAX_CHANNELS;
+                const int n = dspLimit( 0, DrEchoEngine::MAX_CHANNELS, num_channels - first );
+                std::unique_ptr<DrEchoEngine> engine = engines.acquire( key );
+                render.renderChunk( *engine, chunk, channels.data(), first, n, state.parameters, job.bpm );
+                engines.release( key, std::move( engine ) );
+                done.countDown();
+            } );
+        }
+    }
+    done.wait();
+
+    std::string details;
+    if ( job.chunked )
+        details += " chunks=" + std::to_string( num_chunks );
+    if ( !serial.empty() )
+    {
+        _Latch serial_done( num_groups );
+        for ( int g = 0; g < num_groups; ++g )
+        {
+            pool.submit( [&, g]
+            {
+                const int first = g * DrEchoEngine::MAX_CHANNELS;
+                const int n = dspLimit( 0, DrEchoEngine::MAX_CHANNELS, num_channels - first );
+                float* group[DrEchoEngine::MAX_CHANNELS];
+                for ( int c = 0; c < n; ++c )
+                    group[c] = serial[ static_cast<size_t>( first + c ) ].data();
+                std::unique_ptr<DrEchoEngine> engine = engines.acquire( key );
+                engine->process( group, n, static_cast<int>( num_frames ), state.parameters, job.bpm );
+                engines.release( key, std::move( engine ) );
+                serial_done.countDown();
+            } );
+        }
+        serial_done.wait();
+
+        float max_error = 0.0f;
+        for ( int c = 0; c < num_channels; ++c )
+            for ( size_t i = 0; i < num_frames; ++i )
+                max_error = std::max( max_error, std::fabs( channels[ static_cast<size_t>( c ) ][i] - serial[ static_cast<size_t>( c ) ][i] ) );
+        char max_error_db[32];
+        std::snprintf( max_error_db, sizeof( max_error_db ), "%.1f", max_error > 0.0f ? 20.0f * std::log10( max_error ) : -999.0f );
+        if ( max_error > std::pow( 10.0f, CHUNK_TOLERANCE_DB * 0.05f ) )
+            return std::string( "error chunked render differs from the serial one by " ) + max_error_db + " dB";
+        details += std::string( " max_error_db=" ) + max_error_db;
+    }
+
+    if ( !output_name.empty() )
+    {
+        output_memory.keep();
+        return "ok shm=" + output_name + " frames=" + std::to_string( num_frames )
+            + " channels=" + std::to_string( num_channels ) + details;
+    }
+    if ( !wav.write( job.output, error ) )
+        return "error " + error;
+    return "ok output=" + job.output + details;
+}
+
+static void _serve(int connection, WorkStealingPool& pool, EnginePool& engines)
+{
+    std::string pending;
+    char buffer[1024];
+    for ( ;; )
+    {
+        const ssize_t n = ::read( connection, buffer, sizeof( buffer ) );
+        if ( n <= 0 )
+            break;
+        pending.append( buffer, static_cast<size_t>( n ) );
+
+        for ( size_t end; (end = pending.find( '\n' )) != std::string::npos; )
+        {
+            const std::string line = pending.substr( 0, end );
+            pending.erase( 0, end + 1 );
+            if ( line.empty() )
+                continue;
+
+            _Job job;
+            std::string error;
+            const auto start = std::chrono::steady_clock::now();
+            std::string answer = _parse_job( line, job, error ) ? _render( job, pool, engines ) : "error " + error;
+            const auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::steady_clock::now() - start ).count();
+
+            std::printf( "%s -> %s (%lld ms)\n", job.input.c_str(), answer.c_str(), static_cast<long long>( milliseconds ) );
+            std::fflush( stdout );
+            answer += '\n';
+            if ( ::write( connection, answer.data(), answer.size() ) != static_cast<ssize_t>( answer.size() ) )
+                break;
+        }
+    }
+    ::close( connection );
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    const std::string socket_path = argc > 1 ? argv[1] : DEFAULT_SOCKET_PATH;
+    const int num_threads = argc > 2 ? std::atoi( argv[2] ) : static_cast<int>( std::thread::hardware_concurrency() );
+
+    ::signal( SIGPIPE, SIG_IGN );
+
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if ( socket_path.size() >= sizeof( address.sun_path ) )
+    {
+        std::fprintf( stderr, "socket path too long: %s\n", socket_path.c_str() );
+        return 1;
+    }
+    std::copy( socket_path.begin(), socket_path.end(), address.sun_path );
+
+    const int listener = ::socket( AF_UNIX, SOCK_STREAM, 0 );
+    ::unlink( socket_path.c_str() );
+    if ( listener < 0
+        || ::bind( listener, reinterpret_cast<const sockaddr*>( &address ), sizeof( address ) ) != 0
+        || ::listen( listener, 16 ) != 0 )
+    {
+        std::perror( socket_path.c_str() );
+        return 1;
+    }
+
+    WorkStealingPool pool( num_threads );
+    EnginePool engines;
+    std::printf( "drecho-renderd: %d threads, listening on %s\n", pool.getNumThreads(), socket_path.c_str() );
+
+    for ( ;; )
+    {
+        const int connection = ::accept( listener, nullptr, nullptr );
+        if ( connection < 0 )
+            continue;
+        std::thread( _serve, connection, std::ref( pool ), std::ref( engines ) ).detach();
+    }
+}
@@ -0,0 +1,190 @@
+/*
+  ==============================================================================
+
+    WavFile.h
+    Created: 19 Oct 2026 9:37:05pm
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/**
+ * Just enough RIFF/WAVE (and RF64, for files beyond 4 GiB) to read
+ * 16/24/32-bit PCM and 32-bit float files and to write 32-bit float files,
+ * with the audio held in planar channels.
+ */
+struct WavFile
+{
+    int sample_rate = 0;
+    std::vector<std::vector<float>> channels;
+
+    size_t getNumFrames() const { return channels.empty() ? 0 : channels[0].size(); }
+
+    bool read(const std::string& path, std::string& error)
+    {
+        FILE* file = std::fopen( path.c_str(), "rb" );
+        if ( !file )
+        {
+            error = "cannot open " + path;
+            return false;
+        }
+        std::vector<uint8_t> data;
+        uint8_t chunk[65536];
+        size_t n;
+        while ( (n = std::fread( chunk, 1, sizeof( chunk ), file )) > 0 )
+            data.insert( data.end(), chunk, chunk + n );
+        std::fclose( file );
+
+        const bool rf64 = data.size() >= 12 && std::memcmp( data.data(), "RF64", 4 ) == 0;
+        if ( data.size() < 12 || (!rf64 && std::memcmp( data.data(), "RIFF", 4 ) != 0) || std::memcmp( data.data() + 8, "WAVE", 4 ) != 0 )
+        {
+            error = path + " is not a WAVE file";
+            return false;
+        }
+
+        int format = 0;
+        int num_channels = 0;
+        int bits = 0;
+        const uint8_t* samples = nullptr;
+        size_t num_bytes = 0;
+        uint64_t rf64_data_size = 0;
+        for ( size_t pos = 12; pos + 8 <= data.size(); )
+        {
+            uint64_t size = _read32( data.data() + pos + 4 );
+            const uint8_t* body = data.data() + pos + 8;
+            if ( rf64 && size == 0xffffffff && std::memcmp( data.data() + pos, "data", 4 ) == 0 )
+                size = rf64_data_size;
+            const size_t available = static_cast<size_t>( std::min<uint64_t>( size, data.size() - pos - 8 ) );
+            if ( std::memcmp( data.data() + pos, "ds64", 4 ) == 0 && available >= 16 )
+            {
+                rf64_data_size = _read32( body + 8 ) | (static_cast<uint64_t>( _read32( body + 12 ) ) << 32);
+            }
+            else if ( std::memcmp( data.data() + pos, "fmt ", 4 ) == 0 && available >= 16 )
+            {
+                format = _read16( body );
+                num_channels = _read16( body + 2 );
+                sample_rate = static_cast<int>( _read32( body + 4 ) );
+                bits = _read16( body + 14 );
+                if ( format == 0xfffe && available >= 26 ) // WAVE_FORMAT_EXTENSIBLE
+                    format = _read16( body + 24 );
+            }
+            else if ( std::memcmp( data.data() + pos, "data", 4 ) == 0 )
+            {
+                samples = body;
+                num_bytes = available;
+            }
+            pos += static_cast<size_t>( std::min<uint64_t>( 8 + size + (size & 1), data.size() - pos ) );
+        }
+
+        const bool pcm = format == 1 && (bits == 16 || bits == 24 || bits == 32);
+        const bool ieee_float = format == 3 && bits == 32;
+        if ( !samples || num_channels <= 0 || (!pcm && !ieee_float) )
+        {
+            error = path + " has an unsupported format (only 16/24/32-bit PCM and 32-bit float)";
+            return false;
+        }
+
+        const int bytes_per_sample = bits / 8;
+        const size_t num_frames = num_bytes / (static_cast<size_t>( bytes_per_sample ) * num_channels);
+        channels.assign( static_cast<size_t>( num_channels ), std::vector<float>( num_frames ) );
+        for ( size_t i = 0; i < num_frames; ++i )
+        {
+            for ( int c = 0; c < num_channels; ++c )
+            {
+                const uint8_t* p = samples + (i * num_channels + c) * bytes_per_sample;
+                float value;
+                if ( ieee_float )
+                {
+                    const uint32_t bits32 = _read32( p );
+                    std::memcpy( &value, &bits32, 4 );
+                }
+                else if ( bits == 16 )
+                    value = static_cast<float>( static_cast<int16_t>( _read16( p ) ) ) / 32768.0f;
+                else if ( bits == 24 )
+                    value = static_cast<float>( static_cast<int32_t>( (p[0] << 8) | (p[1] << 16) | (static_cast<uint32_t>( p[2] ) << 24) ) >> 8 ) / 8388608.0f;
+                else
+                    value = static_cast<float>( static_cast<int32_t>( _read32( p ) ) ) / 2147483648.0f;
+                channels[ static_cast<size_t>( c ) ][i] = value;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Writes a RIFF/WAVE file, or an RF64 file (EBU Tech 3306) where the
+     * RIFF sizes don't fit into 32 bits, e.g. a long multichannel stem.
+     */
+    bool write(const std::string& path, std::string& error) const
+    {
+        const uint32_t num_channels = static_cast<uint32_t>( channels.size() );
+        const uint64_t num_frames = getNumFrames();
+        const uint64_t data_size = num_frames * num_channels * 4;
+        const bool rf64 = data_size > 0xffffffffull - 36;
+        const uint64_t riff_size = (rf64 ? 36 + 36 : 36) + data_size;
+
+        std::vector<uint8_t> data;
+        auto put = [&data](const char* text) { data.insert( data.end(), text, text + 4 ); };
+        auto put16 = [&data](uint32_t v) { data.push_back( static_cast<uint8_t>( v ) ); data.push_back( static_cast<uint8_t>( v >> 8 ) ); };
+        auto put32 = [&put16](uint32_t v) { put16( v & 0xffff ); put16( v >> 16 ); };
+        auto put64 = [&put32](uint64_t v) { put32( static_cast<uint32_t>( v ) ); put32( static_cast<uint32_t>( v >> 32 ) ); };
+
+        if ( rf64 )
+        {
+            // The 32-bit sizes are all ones, the real ones are in the ds64 chunk.
+            put( "RF64" ); put32( 0xffffffff ); put( "WAVE" );
+            put( "ds64" ); put32( 28 ); put64( riff_size ); put64( data_size ); put64( num_frames ); put32( 0 );
+        }
+        else
+        {
+            put( "RIFF" ); put32( static_cast<uint32_t>( riff_size ) ); put( "WAVE" );
+        }
+        put( "fmt " ); put32( 16 ); put16( 3 ); put16( num_channels ); put32( static_cast<uint32_t>( sample_rate ) );
+        put32( static_cast<uint32_t>( sample_rate ) * num_channels * 4 ); put16( num_channels * 4 ); put16( 32 );
+        put( "data" ); put32( rf64 ? 0xffffffff : static_cast<uint32_t>( data_size ) );
+
+        FILE* file = std::fopen( path.c_str(), "wb" );
+        bool ok = file != nullptr;
+
+        // Interleaved in slices, so that a long file isn't held twice in memory.
+        const size_t SLICE_FRAMES = 65536;
+        for ( uint64_t start = 0; ok && start < num_frames; start += SLICE_FRAMES )
+        {
+            const uint64_t end = std::min<uint64_t>( num_frames, start + SLICE_FRAMES );
+            for ( uint64_t i = start; i < end; ++i )
+            {
+                for ( uint32_t c = 0; c < num_channels; ++c )
+                {
+                    uint32_t bits32;
+                    std::memcpy( &bits32, &channels[c][i], 4 );
+                    put32( bits32 );
+                }
+            }
+            ok = std::fwrite( data.data(), 1, data.size(), file ) == data.size();
+            data.clear();
+        }
+        if ( ok && !data.empty() )
+            ok = std::fwrite( data.data(), 1, data.size(), file ) == data.size();
+
+        if ( file && std::fclose( file ) != 0 )
+            ok = false;
+        if ( !ok )
+        {
+            error = "cannot write " + path;
+            return false;
+        }
+        return true;
+    }
+
+private:
+    static uint32_t _read16(const uint8_t* p) { return static_cast<uint32_t>( p[0] | (p[1] << 8) ); }
+    static uint32_t _read32(const uint8_t* p) { return _read16( p ) | (_read16( p + 2 ) << 16); }
+};
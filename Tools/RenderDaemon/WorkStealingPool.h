@@ -0,0 +1,161 @@
+/*
+  ==============================================================================
+
+    WorkStealingPool.h
+    Created: 19 Oct 2026 9:37:05pm
+    Author:  Stefan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * A thread pool in which every worker has a deque of its own. Workers take
+ * their own tasks from the back (most recently pushed, still warm in cache)
+ * and, once they run dry, steal from the front of the others' deques. Tasks
+ * submitted from outside the pool are spread round-robin, tasks submitted by
+ * a worker go to its own deque.
+ */
+class WorkStealingPool
+{
+
+public:
+    explicit WorkStealingPool(int num_threads)
+        : _next_queue( 0 )
+        , _num_pending( 0 )
+        , _stopping( false )
+    {
+        num_threads = std::max( 1, num_threads );
+        for ( int i = 0; i < num_threads; ++i )
+            _queues.push_back( std::make_unique<Queue>() );
+        for ( int i = 0; i < num_threads; ++i )
+            _threads.emplace_back( [this, i] { _run( i ); } );
+    }
+
+    ~WorkStealingPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock( _wake_mutex );
+            _stopping = true;
+        }
+        _wake.notify_all();
+        for ( auto& thread : _threads )
+            thread.join();
+    }
+
+public:
+    int getNumThreads() const { return static_cast<int>( _threads.size() ); }
+
+    void submit(std::function<void ()> task)
+    {
+        const int index = _current_worker() >= 0 && _current_pool() == this
+            ? _current_worker()
+            : static_cast<int>( _next_queue++ % _queues.size() );
+
+        {
+            std::lock_guard<std::mutex> lock( _queues[ index ]->mutex );
+            _queues[ index ]->tasks.push_back( std::move( task ) );
+        }
+        {
+            std::lock_guard<std::mutex> lock( _wake_mutex );
+            ++_num_pending;
+        }
+        _wake.notify_one();
+    }
+
+private:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<std::function<void ()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> _queues;
+    std::vector<std::thread> _threads;
+    std::atomic<unsigned> _next_queue;
+
+    std::mutex _wake_mutex;
+    std::condition_variable _wake;
+    int _num_pending;
+    bool _stopping;
+
+private:
+    static int& _current_worker()
+    {
+        static thread_local int current_worker = -1;
+        return current_worker;
+    }
+
+    static const WorkStealingPool*& _current_pool()
+    {
+        static thread_local const WorkStealingPool* current_pool = nullptr;
+        return current_pool;
+    }
+
+    bool _take(int index, std::function<void ()>& task)
+    {
+        // The own deque from the back, ...
+        {
+            Queue& own = *_queues[ index ];
+            std::lock_guard<std::mutex> lock( own.mutex );
+            if ( !own.tasks.empty() )
+            {
+                task = std::move( own.tasks.back() );
+                own.tasks.pop_back();
+                return true;
+            }
+        }
+
+        // ... or the others' from the front.
+        const int num_queues = static_cast<int>( _queues.size() );
+        for ( int k = 1; k < num_queues; ++k )
+        {
+            Queue& victim = *_queues[ (index + k) % num_queues ];
+            std::lock_guard<std::mutex> lock( victim.mutex );
+            if ( !victim.tasks.empty() )
+            {
+                task = std::move( victim.tasks.front() );
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void _run(int index)
+    {
+        _current_worker() = index;
+        _current_pool() = this;
+
+        for ( ;; )
+        {
+            {
+                std::unique_lock<std::mutex> lock( _wake_mutex );
+                _wake.wait( lock, [this] { return _stopping || _num_pending > 0; } );
+                if ( _num_pending == 0 )
+                    return; // stopping, and everything submitted has been run
+                --_num_pending;
+            }
+
+            // Every pending count stands for exactly one queued task, which
+            // some worker may have stolen in the meantime; keep looking.
+            std::function<void ()> task;
+            while ( !_take( index, task ) )
+                std::this_thread::yield();
+            task();
+        }
+    }
+
+};
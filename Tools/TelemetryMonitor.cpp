@@ -0,0 +1,158 @@
+/*
+  ==============================================================================
+
+    TelemetryMonitor.cpp
+    Created: 19 Oct 2026 7:58:12pm
+    Author:  Stefan
+
+    Shows a live table of all Dr.Echo instances on this machine, as published
+    to the per-process telemetry pages (see Source/TelemetryLayout.h).
+
+    Build (macOS/Linux, no further dependencies):
+        c++ -std=c++14 -O2 -I Source Tools/TelemetryMonitor.cpp -o drecho-telemetry
+
+    Usage:
+        drecho-telemetry [--once] [--interval <milliseconds>]
+
+  ==============================================================================
+*/
+
+#include "TelemetryLayout.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+static bool _is_process_alive(uint32_t process_id)
+{
+    return ::kill( static_cast<pid_t>( process_id ), 0 ) == 0 || errno == EPERM;
+}
+
+// Returns the load below which the given fraction of all blocks stayed.
+static float _get_load_percentile(const TelemetrySlot& slot, double fraction)
+{
+    uint64_t total = 0;
+    for ( const auto& count : slot.load_histogram )
+        total += count.load( std::memory_order_relaxed );
+    if ( total == 0 )
+        return 0.0f;
+
+    uint64_t sum = 0;
+    for ( int i = 0; i < TELEMETRY_NUM_LOAD_BUCKETS; ++i )
+    {
+        sum += slot.load_histogram[i].load( std::memory_order_relaxed );
+        if ( static_cast<double>( sum ) >= fraction * static_cast<double>( total ) )
+            return static_cast<float>( i + 1 ) / static_cast<float>( TELEMETRY_NUM_LOAD_BUCKETS - 1 );
+    }
+    return 1.0f;
+}
+
+static void _print_page(const TelemetryPage& page)
+{
+    for ( uint32_t i = 0; i < page.num_slots && i < static_cast<uint32_t>( TELEMETRY_MAX_SLOTS ); ++i )
+    {
+        const TelemetrySlot& slot = page.slots[i];
+        if ( !slot.in_use.load( std::memory_order_relaxed ) )
+            continue;
+
+        const uint32_t sample_rate = slot.sample_rate.load( std::memory_order_relaxed );
+        const uint32_t delay_samples = slot.delay_samples.load( std::memory_order_relaxed );
+        const float peak = slot.peak_wet.load( std::memory_order_relaxed );
+
+        std::printf( "%8u %5u %7u %12llu %6.1f %6.1f %9u %8u %8.1f %7.1f %5s %9.1f\n",
+            page.process_id,
+            slot.instance_id.load( std::memory_order_relaxed ),
+            sample_rate,
+            static_cast<unsigned long long>( slot.num_blocks.load( std::memory_order_relaxed ) ),
+            100.0f * slot.load.load( std::memory_order_relaxed ),
+            100.0f * _get_load_percentile( slot, 0.95 ),
+            slot.num_overruns.load( std::memory_order_relaxed ),
+            delay_samples,
+            sample_rate ? 1000.0 * delay_samples / sample_rate : 0.0,
+            peak > 0.0f ? 20.0f * std::log10( peak ) : -INFINITY,
+            slot.tail_active.load( std::memory_order_relaxed ) ? "yes" : "no",
+            static_cast<double>( slot.buffer_bytes.load( std::memory_order_relaxed ) ) / 1024.0 );
+    }
+}
+
+static int _print_all()
+{
+    DIR* directory = ::opendir( DRECHO_TELEMETRY_DIRECTORY );
+    if ( !directory )
+    {
+        std::printf( "No Dr.Echo instances (%s doesn't exist).\n", DRECHO_TELEMETRY_DIRECTORY );
+        return 0;
+    }
+
+    std::printf( "%8s %5s %7s %12s %6s %6s %9s %8s %8s %7s %5s %9s\n",
+        "PID", "INST", "RATE", "BLOCKS", "LOAD%", "P95%", "OVERRUNS", "DELAY", "DELAYms", "PEAKdB", "TAIL", "MEMkB" );
+
+    int num_pages = 0;
+    while ( const dirent* entry = ::readdir( directory ) )
+    {
+        const std::string name = entry->d_name;
+        if ( name.size() < 6 || name.compare( name.size() - 5, 5, ".page" ) != 0 )
+            continue;
+
+        const std::string path = std::string( DRECHO_TELEMETRY_DIRECTORY ) + "/" + name;
+        const int fd = ::open( path.c_str(), O_RDONLY );
+        if ( fd < 0 )
+            continue;
+        void* data = ::mmap( nullptr, sizeof( TelemetryPage ), PROT_READ, MAP_SHARED, fd, 0 );
+        ::close( fd );
+        if ( data == MAP_FAILED )
+            continue;
+
+        // Pages of crashed processes are left behind, so check that their owner still runs.
+        const TelemetryPage& page = *static_cast<const TelemetryPage*>( data );
+        if ( page.magic.load( std::memory_order_acquire ) == TELEMETRY_MAGIC && page.version == TELEMETRY_VERSION && _is_process_alive( page.process_id ) )
+        {
+            _print_page( page );
+            ++num_pages;
+        }
+
+        ::munmap( data, sizeof( TelemetryPage ) );
+    }
+    ::closedir( directory );
+
+    return num_pages;
+}
+
+int main(int argc, char* argv[])
+{
+    bool once = false;
+    int interval_ms = 500;
+    for ( int i = 1; i < argc; ++i )
+    {
+        if ( std::strcmp( argv[i], "--once" ) == 0 )
+            once = true;
+        else if ( std::strcmp( argv[i], "--interval" ) == 0 && i + 1 < argc )
+            interval_ms = std::max( 50, std::atoi( argv[++i] ) );
+        else
+        {
+            std::fprintf( stderr, "Usage: %s [--once] [--interval <milliseconds>]\n", argv[0] );
+            return 1;
+        }
+    }
+
+    for ( ;; )
+    {
+        if ( !once )
+            std::printf( "\x1b[H\x1b[2J" ); // home and clear the terminal
+        _print_all();
+        std::fflush( stdout );
+        if ( once )
+            return 0;
+        ::usleep( static_cast<useconds_t>( interval_ms ) * 1000 );
+    }
+}